@@ -11,10 +11,10 @@ fi
 
 
 rm -rf src obj
-cp -r src_calvin_pdlr/ src
+cp -r src_calvin/ src
 cp definitions.hh src/common/definitions.hh
 cd src
 make clean
 make -j
 cd ../
-bin/deployment/db 0 "$ARGUMENT" 0
\ No newline at end of file
+bin/deployment/db 0 "$ARGUMENT" 0 --scheduler=pdlr
\ No newline at end of file
@@ -0,0 +1,45 @@
+#!/bin/bash
+#
+# Runs two Calvin nodes on localhost and moves part of node 0's data to node 1
+# part way through the run, to compare throughput before and after.
+#
+#   ./calvin_rebalance.sh [m|t] [percent_mp] [migration] [seconds_before]
+#
+# The migration uses the --migrate format of deployment/main.cc; the rebalance
+# advisor prints suggestions in the same format ("Suggested: --migrate=...").
+
+APP=${1:-m}
+MP=${2:-0}
+MIGRATION=${3:-default:0-99999@1}
+AFTER=${4:-30}
+
+rm -rf src obj
+cp -r src_calvin/ src
+cp definitions.hh src/common/definitions.hh
+cd src
+make clean
+make -j
+cd ../
+
+mkdir -p rebalance-run
+cd rebalance-run
+cat > deploy-run.conf <<CONF
+# Node<id>=<replica>:<partition>:<cores>:<host>:<port>
+node0=0:0:8:127.0.0.1:54564
+node1=0:1:8:127.0.0.1:54565
+CONF
+
+../bin/deployment/db 1 "$APP" "$MP" > node1.log 2>&1 &
+NODE1=$!
+../bin/deployment/db 0 "$APP" "$MP" --migrate="$MIGRATION" \
+    --migrate-after="$AFTER" > node0.log 2>&1 &
+NODE0=$!
+
+sleep $((AFTER * 2))
+kill $NODE0 $NODE1
+wait
+
+for log in node0.log node1.log; do
+  echo "== $log =="
+  grep -E "^Completed|^Repartitioned|^Suggested" $log
+done
@@ -29,9 +29,61 @@
 #define NUM_WORKERS (NUM_WORKERS_CORE)  // ハイパースレッド
 // ==============================================
 
+// ============== worker setting ==============
+// Number of ready txns a worker takes at once. Storage lookups for the whole
+// group are done and prefetched before any of them executes.
+#define WORKER_BATCH_SIZE 4
+// ==============================================
+
 // ============== database setting ==============
 #define DB_SIZE 1000000
 #define LOCK_TABLE_SIZE 1000000  // accessed only by a lock manager
+// Threads populating the local partition at startup.
+#define INIT_THREADS 4
+// Objects a loader thread creates before handing them to storage at once.
+#define INIT_BATCH_SIZE 4096
+// ==============================================
+
+// ============== repartitioning setting ==============
+// A migration ordered in some epoch takes effect this many epochs later on
+// every node. Sequencers never run further ahead of their scheduler than this.
+#define MIGRATION_LEAD_EPOCHS 100
+// Number of hottest keys the rebalance advisor reports every second.
+#define REBALANCE_HOT_KEYS 5
+// ==============================================
+
+// ============== checkpoint setting ==============
+// Versioned storage is split into this many independently locked shards.
+#define CHECKPOINT_SHARDS 64
+// Threads writing a checkpoint, each to its own file.
+#define CHECKPOINT_THREADS 4
+// Bytes a checkpoint thread gathers before each write().
+#define CHECKPOINT_BUFFER_SIZE (4 << 20)
+// ==============================================
+
+// ============== mvcc setting ==============
+// Initial hash table size of MvccStorage (a power of two).
+#define MVCC_BUCKETS 65536
+// Locks shared by MvccStorage's writers, each covering every this many'th
+// bucket.
+#define MVCC_LOCK_STRIPES 1024
+// Threads running read-only txns at a snapshot, with --snapshot-reads.
+#define SNAPSHOT_THREADS 2
+// Longest a read-only txn is retried for objects missing from the snapshot.
+#define SNAPSHOT_MAX_WAIT 1.0
+// ==============================================
+
+// ============== buffer pool setting ==============
+// Pages FetchingStorage keeps in memory; colder keys are evicted to disk.
+#define BUFFER_POOL_FRAMES COLD_CUTOFF
+// Queued page reads and writes that are submitted without waiting for the
+// end of the epoch.
+#define BUFFER_POOL_IO_BATCH 64
+// Most page reads and writes in flight at once (the io_uring ring size).
+#define BUFFER_POOL_IO_DEPTH 256
+// Longest the sequencer holds a txn back, with --prefetch, waiting for its
+// objects to be read in.
+#define PREFETCH_MAX_WAIT 0.1
 // ==============================================
 
 // ============== workload setting ==============
@@ -47,7 +99,33 @@
 // ==============================================
 
 // ============== used for only pdlr ==============
-#define MAX_FAILED_LOCK 100
+// Lock requests per window of the contention estimator (its averages halve
+// every window), and the percentile of the queue lengths seen in a window
+// above which keys count as contended in the next (see
+// scheduler/contention_estimator.h).
+#define CONTENTION_WINDOW 10000
+#define CONTENTION_PERCENTILE 90
+// When the lock manager admits txns and releases finished ones: "PDLR",
+// "FIFO" or "COST" (see scheduler/scheduling_policy.h).
+#define PDLR_POLICY "PDLR"
+// ==============================================
+
+// ============== used for only vll ==============
+// Most txns the VLL lock manager keeps queued (granted or blocked) at once.
+#define VLL_MAX_IN_FLIGHT 16384
+// The lock manager stops admitting txns and runs SCA passes once this many of
+// the queued txns are blocked.
+#define VLL_MAX_BLOCKED 1000
+// Txns completed between SCA passes run while txns are still being admitted.
+#define VLL_SCA_RELEASES 8
+// How the VLL lock manager maps keys to counters: HASHED (FNV hash buckets,
+// colliding keys conflict) or EXACT (a counter per key in flight; see
+// scheduler/lock_slots.h).
+#define VLL_LOCK_SLOTS EXACT
+// Threads requesting VLL locks next to the lock manager thread (at least 1;
+// see scheduler/vll_acquirer.h), and how many txns they keep in flight.
+#define VLL_LOCK_THREADS 2
+#define VLL_LOCK_PIPELINE 256
 // ==============================================
 
 // calvin system default cpu affinity:
@@ -41,6 +41,27 @@ class Application {
   // Execute a transaction's application logic given the input 'txn'.
   virtual int Execute(TxnProto* txn, StorageManager* storage) const = 0;
 
+  // Dependent txns (optimistic lock location prediction). Some txns learn
+  // part of their read and write sets from what they read, such as a TPC-C
+  // payment that looks its customer up by last name. Before such a txn is
+  // ordered, a reconnaissance read predicts those keys. When it runs,
+  // Execute() checks the prediction against what it reads under locks and,
+  // if it no longer holds, returns REDO without writing anything and leaves
+  // the keys it found in the txn's 'dependent_keys'. Every node executing the
+  // txn reads the same values and comes to the same verdict, and the txn is
+  // ordered again with the keys it found (see scheduler/txn_restarter.h).
+
+  // Predicts the dependent keys of 'txn' from copies of objects in 'storage'
+  // (see Storage::CopyObject), made while txns run.
+  // Keys whose lookup is stored at another node are left unpredicted, to be
+  // found by the txn's first execution.
+  virtual void Reconnoiter(TxnProto* txn, Storage* storage,
+                           Configuration* config) const {}
+
+  // Turns 'txn', a copy of a txn that Execute() returned REDO for, into the
+  // txn to order in its place, predicting the keys execution found.
+  virtual void Repredict(TxnProto* txn) const {}
+
   // Storage initialization method.
   virtual void InitializeStorage(Storage* storage,
                                  Configuration* conf) const = 0;
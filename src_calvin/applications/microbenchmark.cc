@@ -5,8 +5,10 @@
 
 #include "applications/microbenchmark.h"
 
+#include <cstdio>
 #include <iostream>
 
+#include "applications/parallel_loader.h"
 #include "backend/storage.h"
 #include "backend/storage_manager.h"
 #include "common/utils.h"
@@ -14,8 +16,6 @@
 #include "common/definitions.hh"
 #include "proto/txn.pb.h"
 
-// #define PREFETCHING
-
 // Fills '*keys' with num_keys unique ints k where
 // 'key_start' <= k < 'key_limit', and k == part (mod nparts).
 // Requires: key_start % nparts == 0
@@ -144,11 +144,48 @@ int Microbenchmark::Execute(TxnProto* txn, StorageManager* storage) const {
   return 0;
 }
 
+namespace {
+
+// Which of the microbenchmark's integer keys this node loads.
+struct LocalKeys {
+  const Partitioner* partitioner;
+  int node;
+  // If positive, the local keys are exactly node + k * stride (hash
+  // partitioning) and the load units are the k's. Otherwise the units are all
+  // keys and each one is looked up.
+  int64 stride;
+};
+
+void LoadLocalKeys(int64 lo, int64 hi, LoadBuffer* buffer, void* arg) {
+  LocalKeys* local = reinterpret_cast<LocalKeys*>(arg);
+  char key[32];
+  for (int64 i = lo; i < hi; i++) {
+    int64 id = i;
+    if (local->stride > 0)
+      id = local->node + i * local->stride;
+    else if (local->partitioner->Lookup(id) != local->node)
+      continue;
+    int length = snprintf(key, sizeof(key), "%ld", static_cast<long>(id));
+    buffer->Put(Key(key, length), new Value(key, length));
+  }
+}
+
+}  // namespace
+
+// Only the local keys are created, looked up by their numeric id so that
+// remote keys are never formatted.
 void Microbenchmark::InitializeStorage(Storage* storage,
                                        Configuration* conf) const {
-  for (int i = 0; i < nparts * DB_SIZE; i++) {
-    if (conf->LookupPartition(IntToString(i)) == conf->this_node_id) {
-      storage->PutObject(IntToString(i), new Value(IntToString(i)));
-    }
+  int64 keys = static_cast<int64>(nparts) * DB_SIZE;
+  int nodes = conf->all_nodes.size();
+  LocalKeys local = {conf->partition_map()->partitioner('\0'),
+                     conf->this_node_id, 0};
+  int64 units = keys;
+  if (dynamic_cast<const HashPartitioner*>(local.partitioner) != NULL) {
+    local.stride = nodes;
+    units = (keys - local.node + nodes - 1) / nodes;
   }
+
+  storage->Reserve(keys / nodes);
+  ParallelLoad("Microbenchmark", storage, units, &LoadLocalKeys, &local);
 }
@@ -0,0 +1,63 @@
+// Populates storage at startup from several threads.
+
+#include "applications/parallel_loader.h"
+
+#include <pthread.h>
+
+#include <cstdio>
+
+#include "common/utils.h"
+
+namespace {
+
+// Arguments and result of one loader thread.
+struct LoadSlice {
+  Storage* storage;
+  LoadFunction load;
+  void* arg;
+  int64 lo;
+  int64 hi;
+  int64 objects;
+};
+
+void* RunLoadSlice(void* arg) {
+  LoadSlice* slice = reinterpret_cast<LoadSlice*>(arg);
+  LoadBuffer buffer(slice->storage);
+  slice->load(slice->lo, slice->hi, &buffer, slice->arg);
+  buffer.Flush();
+  slice->objects = buffer.objects();
+  return NULL;
+}
+
+}  // namespace
+
+int64 ParallelLoad(const char* name, Storage* storage, int64 count,
+                   LoadFunction load, void* arg) {
+  double start = GetTime();
+
+  int threads = INIT_THREADS;
+  if (count < threads)
+    threads = (count > 0) ? count : 1;
+
+  pthread_t thread_ids[INIT_THREADS];
+  LoadSlice slices[INIT_THREADS];
+  for (int i = 0; i < threads; i++) {
+    LoadSlice slice = {storage, load, arg, count * i / threads,
+                       count * (i + 1) / threads, 0};
+    slices[i] = slice;
+    pthread_create(&thread_ids[i], NULL, &RunLoadSlice, &slices[i]);
+  }
+
+  int64 objects = 0;
+  for (int i = 0; i < threads; i++) {
+    pthread_join(thread_ids[i], NULL);
+    objects += slices[i].objects;
+  }
+
+  double elapsed = GetTime() - start;
+  printf("%s: loaded %ld objects in %.3f s (%.0f objects/s, %d threads)\n",
+         name, static_cast<long>(objects), elapsed,
+         elapsed > 0 ? objects / elapsed : 0, threads);
+  fflush(stdout);
+  return objects;
+}
@@ -0,0 +1,64 @@
+// Populates storage at startup from several threads.
+//
+// An application splits the records it owns into 'count' units of work (keys,
+// warehouses, ...) and passes a function that creates the records of units
+// [lo, hi). ParallelLoad() runs it on INIT_THREADS threads, each over its own
+// contiguous slice, and each thread hands its records to storage in batches of
+// INIT_BATCH_SIZE through a LoadBuffer.
+
+#ifndef _DB_APPLICATIONS_PARALLEL_LOADER_H_
+#define _DB_APPLICATIONS_PARALLEL_LOADER_H_
+
+#include <utility>
+#include <vector>
+
+#include "backend/storage.h"
+#include "common/definitions.hh"
+#include "common/types.h"
+
+using std::pair;
+using std::vector;
+
+class LoadBuffer {
+ public:
+  explicit LoadBuffer(Storage* storage) : storage_(storage), objects_(0) {
+    batch_.reserve(INIT_BATCH_SIZE);
+  }
+  ~LoadBuffer() { Flush(); }
+
+  // Queues 'value' to be stored under 'key'. Takes ownership of 'value'.
+  void Put(const Key& key, Value* value) {
+    batch_.push_back(std::make_pair(key, value));
+    if (batch_.size() >= INIT_BATCH_SIZE)
+      Flush();
+  }
+
+  // Writes all queued objects to storage.
+  void Flush() {
+    if (batch_.empty())
+      return;
+    storage_->PutObjects(batch_);
+    objects_ += batch_.size();
+    batch_.clear();
+  }
+
+  // Number of objects written so far.
+  int64 objects() const { return objects_; }
+
+ private:
+  Storage* storage_;
+  vector<pair<Key, Value*> > batch_;
+  int64 objects_;
+};
+
+// Creates the records of units [lo, hi) and puts them into 'buffer'. Called
+// concurrently from several threads.
+typedef void (*LoadFunction)(int64 lo, int64 hi, LoadBuffer* buffer,
+                             void* arg);
+
+// Runs 'load' over units [0, count) on up to INIT_THREADS threads and prints
+// the load rate, labelled with 'name'. Returns the number of objects stored.
+int64 ParallelLoad(const char* name, Storage* storage, int64 count,
+                   LoadFunction load, void* arg);
+
+#endif  // _DB_APPLICATIONS_PARALLEL_LOADER_H_
@@ -6,9 +6,15 @@
 
 #include "applications/tpcc.h"
 
+#include <algorithm>
+#include <map>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "applications/parallel_loader.h"
+#include "applications/tpcc_records.h"
 #include "backend/storage.h"
 #include "backend/storage_manager.h"
 #include "common/configuration.h"
@@ -16,7 +22,117 @@
 #include "proto/tpcc.pb.h"
 #include "proto/tpcc_args.pb.h"
 
+using google::protobuf::RepeatedPtrField;
+using std::make_pair;
+using std::map;
+using std::pair;
 using std::string;
+using std::vector;
+
+// TPC-C's run-time constant C in NURand() for customer last names.
+static const int kLastNameC = 173;
+
+// Returns a non-uniform random number in [x, y] as TPC-C's NURand(A, x, y).
+static int NURand(int a, int x, int y, unsigned int* seed) {
+  return (((Rand(seed) % (a + 1)) | (x + Rand(seed) % (y - x + 1))) +
+          kLastNameC) % (y - x + 1) + x;
+}
+
+// Returns the TPC-C last name numbered 'number' (0 to 999), made of one
+// syllable per digit.
+static string LastName(int number) {
+  static const char* syllables[] = {"BAR", "OUGHT", "ABLE",  "PRI",   "PRES",
+                                    "ESE", "ANTI",  "CALLY", "ATION", "EING"};
+  return string(syllables[number / 100]) + syllables[number / 10 % 10] +
+         syllables[number % 10];
+}
+
+// Copies the object 'key' from 'storage' into '*value' for a reconnaissance
+// read, which runs alongside txns without locks. Returns 'value', or NULL if
+// there is no such object.
+static const Value* CopyOf(Storage* storage, const Key& key, Value* value) {
+  return storage->CopyObject(key, value) ? value : NULL;
+}
+
+// Sets '*customer' to the customer a payment by last name picks from the
+// CustomerIndex in 'index_value': the middle one in order of first names, as
+// TPC-C specifies. Returns false if there is no such index.
+static bool LookUpCustomer(const Value* index_value, Key* customer) {
+  CustomerIndex index;
+  if (index_value == NULL || !index.ParseFromString(*index_value) ||
+      index.customer_ids_size() == 0)
+    return false;
+  *customer = index.customer_ids((index.customer_ids_size() - 1) / 2);
+  return true;
+}
+
+// Appends to 'keys' the order and order lines an order-status reads: those of
+// the customer's latest order as 'index_value' (a LatestOrder) names it, if
+// the customer has ordered at all.
+static void PredictOrderStatus(const Value* index_value, vector<Key>* keys) {
+  if (index_value == NULL)
+    return;
+  const LatestOrder* index = RecordIn<LatestOrder>(index_value);
+  keys->push_back(index->order_id);
+  for (int i = 0; i < index->order_line_count; i++)
+    keys->push_back(string(index->order_id) + "ol" + IntToString(i));
+}
+
+// Appends to 'keys' the new order, order, order lines and customer a delivery
+// changes in district 'district_key': those of the oldest undelivered order
+// as 'index_value' (an OldestNewOrder) numbers it, if it has been placed. The
+// order is copied from 'storage' without locks, as the fields read never
+// change once it is placed.
+static void PredictDelivery(const Key& district_key, const Value* index_value,
+                            Storage* storage, vector<Key>* keys) {
+  if (index_value == NULL)
+    return;
+  string number =
+      IntToString(RecordIn<OldestNewOrder>(index_value)->order_number);
+  Key order_key = district_key + "o" + number;
+  Value order_value;
+  if (!storage->CopyObject(order_key, &order_value))
+    return;
+  const Order* order = RecordIn<Order>(&order_value);
+  keys->push_back(district_key + "no" + number);
+  keys->push_back(order_key);
+  for (int i = 0; i < order->order_line_count; i++)
+    keys->push_back(order_key + "ol" + IntToString(i));
+  keys->push_back(order->customer_id);
+}
+
+// Returns the key set of 'txn' that ends in the keys predicted for it, and
+// sets '*first' to the position of the first of them. Returns NULL for txns
+// that are not restarted.
+static RepeatedPtrField<string>* PredictedKeys(TxnProto* txn, int* first) {
+  switch (txn->txn_type()) {
+    case TPCC::PAYMENT:
+      *first = 2;
+      return txn->mutable_read_write_set();
+    case TPCC::ORDER_STATUS:
+      *first = 4;
+      return txn->mutable_read_set();
+    case TPCC::DELIVERY:
+      *first = DISTRICTS_PER_WAREHOUSE;
+      return txn->mutable_read_write_set();
+    default:
+      return NULL;
+  }
+}
+
+// Returns true if 'keys' are the keys predicted for 'txn'. Otherwise leaves
+// them in its dependent keys, for Repredict().
+static bool CheckPrediction(TxnProto* txn, const vector<Key>& keys) {
+  int first;
+  const RepeatedPtrField<string>* predicted = PredictedKeys(txn, &first);
+  if (predicted->size() - first == static_cast<int>(keys.size()) &&
+      std::equal(keys.begin(), keys.end(), predicted->begin() + first))
+    return true;
+  txn->clear_dependent_keys();
+  for (size_t i = 0; i < keys.size(); i++)
+    txn->add_dependent_keys(keys[i]);
+  return false;
+}
 
 // ---- THIS IS A HACK TO MAKE ITEMS WORK ON LOCAL MACHINE ---- //
 unordered_map<Key, Value*> ItemList;
@@ -62,6 +178,7 @@ TxnProto* TPCC::NewTxn(int64 txn_id,
   // Because a switch is not scoped we declare our variables outside of it
   int warehouse_id, district_id, customer_id;
   char warehouse_key[128], district_key[128], customer_key[128];
+  char customer_district_key[128];
   int order_line_count;
   bool invalid;
   Value customer_value;
@@ -96,13 +213,7 @@ TxnProto* TPCC::NewTxn(int64 txn_id,
       txn->add_read_set(customer_key);
 
       int order_number;
-      if (next_order_id_for_district.count(district_key) > 0) {
-        order_number = next_order_id_for_district[district_key];
-        next_order_id_for_district[district_key]++;
-      } else {
-        order_number = 0;
-        next_order_id_for_district[district_key] = 1;
-      }
+      order_number = next_order_number_[district_key]++;
 
       // We set the length of the read and write set uniformly between 5 and 15
       order_line_count = (rand() % 11) + 5;
@@ -184,6 +295,9 @@ TxnProto* TPCC::NewTxn(int64 txn_id,
                order_number);
       txn->add_write_set(order_key);
 
+      // And the customer's latest order index
+      txn->add_write_set(string(customer_key) + "lo");
+
       // Set the order line count in the args
       tpcc_args->add_order_line_count(order_line_count);
       tpcc_args->set_order_number(order_number);
@@ -219,6 +333,8 @@ TxnProto* TPCC::NewTxn(int64 txn_id,
         customer_id = rand() % CUSTOMERS_PER_DISTRICT;
         snprintf(customer_key, sizeof(customer_key), "w%dd%dc%d", warehouse_id,
                  district_id, customer_id);
+        snprintf(customer_district_key, sizeof(customer_district_key),
+                 "w%dd%d", warehouse_id, district_id);
 
         // If the probability is 15%, we make it a remote customer
       } else {
@@ -239,13 +355,18 @@ TxnProto* TPCC::NewTxn(int64 txn_id,
                    remote_warehouse_id, remote_district_id, remote_customer_id);
         } while (config->all_nodes.size() > 1 &&
                  config->LookupPartition(remote_warehouse_key) != remote_node);
+        snprintf(customer_district_key, sizeof(customer_district_key),
+                 "w%dd%d", remote_warehouse_id, remote_district_id);
       }
 
-      // We only do secondary keying ~60% of the time
-      if (rand() / (static_cast<double>(RAND_MAX + 1.0)) < 0.00) {
-        // Now that we have the object, let's create the txn arg
-        tpcc_args->set_last_name(customer_key);
-        txn->add_read_set(customer_key);
+      // We only do secondary keying ~60% of the time. The customer is left
+      // to the reconnaissance read (see Reconnoiter()), the txn only reads
+      // the customer index of the district.
+      if (rand() / (static_cast<double>(RAND_MAX + 1.0)) <
+          PAYMENTS_BY_LAST_NAME) {
+        string last_name = LastName(NURand(255, 0, 999, NULL));
+        tpcc_args->set_last_name(last_name);
+        txn->add_read_set(string(customer_district_key) + "ln" + last_name);
 
         // Otherwise just give a customer key
       } else {
@@ -254,51 +375,23 @@ TxnProto* TPCC::NewTxn(int64 txn_id,
 
       break;
 
-    case ORDER_STATUS: {
-      string customer_string;
-      string customer_latest_order;
-      string warehouse_string;
-      string district_string;
-      int customer_order_line_number;
-
-      if (latest_order_id_for_customer.size() < 1) {
-        txn->set_txn_id(-1);
-        break;
-      }
-
-      pthread_mutex_lock(&mutex_);
-      customer_string =
-          (*involed_customers)[rand() % involed_customers->size()];
-      pthread_mutex_unlock(&mutex_);
-      customer_latest_order = latest_order_id_for_customer[customer_string];
-      warehouse_string = customer_string.substr(0, customer_string.find("d"));
-      district_string = customer_string.substr(0, customer_string.find("c"));
-      snprintf(customer_key, sizeof(customer_key), "%s",
-               customer_string.c_str());
-      snprintf(warehouse_key, sizeof(warehouse_key), "%s",
-               warehouse_string.c_str());
-      snprintf(district_key, sizeof(district_key), "%s",
-               district_string.c_str());
-
-      customer_order_line_number = order_line_number[customer_latest_order];
+    // Order-status and delivery are dependent txns: the orders they read are
+    // predicted by Reconnoiter() from the secondary indexes in storage.
+    case ORDER_STATUS:
+      warehouse_id = (rand() % WAREHOUSES_PER_NODE) * config->all_nodes.size() +
+                     config->this_node_id;
+      district_id = rand() % DISTRICTS_PER_WAREHOUSE;
+      customer_id = rand() % CUSTOMERS_PER_DISTRICT;
+      snprintf(warehouse_key, sizeof(warehouse_key), "w%d", warehouse_id);
+      snprintf(district_key, sizeof(district_key), "w%dd%d", warehouse_id,
+               district_id);
+      snprintf(customer_key, sizeof(customer_key), "w%dd%dc%d", warehouse_id,
+               district_id, customer_id);
       txn->add_read_set(warehouse_key);
       txn->add_read_set(district_key);
       txn->add_read_set(customer_key);
-
-      snprintf(order_key, sizeof(order_key), "%s",
-               customer_latest_order.c_str());
-      txn->add_read_set(order_key);
-      char order_line_key[128];
-      for (int i = 0; i < customer_order_line_number; i++) {
-        snprintf(order_line_key, sizeof(order_line_key), "%sol%d", order_key,
-                 i);
-        txn->add_read_set(order_line_key);
-      }
-
-      tpcc_args->add_order_line_count(customer_order_line_number);
-
+      txn->add_read_set(string(customer_key) + "lo");
       break;
-    }
 
     case STOCK_LEVEL: {
       warehouse_id = (rand() % WAREHOUSES_PER_NODE) * config->all_nodes.size() +
@@ -310,86 +403,35 @@ TxnProto* TPCC::NewTxn(int64 txn_id,
       snprintf(district_key, sizeof(district_key), "w%dd%d", warehouse_id,
                district_id);
 
-      if (latest_order_id_for_district.count(district_key) == 0) {
+      if (next_order_number_.count(district_key) == 0) {
         txn->set_txn_id(-1);
         break;
       }
 
+      // The order lines and stock of the latest orders are left to
+      // Reconnoiter().
       txn->add_read_set(warehouse_key);
       txn->add_read_set(district_key);
-      int latest_order_number = latest_order_id_for_district[district_key];
-      char order_line_key[128];
-      char stock_key[128];
-
-      tpcc_args->set_lastest_order_number(latest_order_number);
+      tpcc_args->set_lastest_order_number(next_order_number_[district_key] - 1);
       tpcc_args->set_threshold(rand() % 10 + 10);
-
-      for (int i = latest_order_number;
-           (i >= 0) && (i > latest_order_number - 20); i--) {
-        snprintf(order_key, sizeof(order_key), "%so%d", district_key, i);
-        int ol_number = order_line_number[order_key];
-
-        for (int j = 0; j < ol_number; j++) {
-          snprintf(order_line_key, sizeof(order_line_key), "%sol%d", order_key,
-                   j);
-          int item = item_for_order_line[order_line_key];
-          if (items_used.count(item) > 0) {
-            continue;
-          }
-          items_used.insert(item);
-          txn->add_read_set(order_line_key);
-          snprintf(stock_key, sizeof(stock_key), "%ssi%d", warehouse_key, item);
-          txn->add_read_set(stock_key);
-        }
-      }
-
       break;
     }
 
-    case DELIVERY: {
+    case DELIVERY:
       warehouse_id = (rand() % WAREHOUSES_PER_NODE) * config->all_nodes.size() +
                      config->this_node_id;
       snprintf(warehouse_key, sizeof(warehouse_key), "w%d", warehouse_id);
       txn->add_read_set(warehouse_key);
 
-      char order_line_key[128];
-      int oldest_order;
-
+      // Every district is read, and its index of new orders advanced if it
+      // has one to deliver.
       for (int i = 0; i < DISTRICTS_PER_WAREHOUSE; i++) {
         snprintf(district_key, sizeof(district_key), "%sd%d", warehouse_key, i);
-        if ((smallest_order_id_for_district.count(district_key) == 0) ||
-            (smallest_order_id_for_district[district_key] >
-             latest_order_id_for_district[district_key])) {
-          continue;
-        } else {
-          txn->add_read_set(district_key);
-          oldest_order = smallest_order_id_for_district[district_key];
-          smallest_order_id_for_district[district_key]++;
-
-          snprintf(new_order_key, sizeof(new_order_key), "%sno%d", district_key,
-                   oldest_order);
-          txn->add_read_write_set(new_order_key);
-        }
-
-        snprintf(order_key, sizeof(order_key), "%so%d", district_key,
-                 oldest_order);
-        txn->add_read_write_set(order_key);
-        int ol_number = order_line_number[order_key];
-        tpcc_args->add_order_line_count(ol_number);
-
-        for (int j = 0; j < ol_number; j++) {
-          snprintf(order_line_key, sizeof(order_line_key), "%sol%d", order_key,
-                   j);
-          txn->add_read_write_set(order_line_key);
-        }
-
-        snprintf(customer_key, sizeof(customer_key), "%s",
-                 customer_for_order[order_key].c_str());
-        txn->add_read_write_set(customer_key);
+        txn->add_read_set(district_key);
+        txn->add_read_write_set(string(district_key) + "on");
       }
-
+      tpcc_args->set_carrier_id(rand() % 10);
       break;
-    }
 
     // Invalid transaction
     default:
@@ -449,52 +491,129 @@ int TPCC::Execute(TxnProto* txn, StorageManager* storage) const {
   return FAILURE;
 }
 
+void TPCC::Reconnoiter(TxnProto* txn, Storage* storage,
+                       Configuration* config) const {
+  // Txns NewTxn() gave up on are not ordered.
+  if (txn->txn_id() == -1)
+    return;
+
+  vector<Key> keys;
+  Value value;
+  switch (txn->txn_type()) {
+    // Only payments by last name have a read set, the customer index.
+    case PAYMENT: {
+      Key customer_key;
+      if (txn->read_set_size() > 0 &&
+          config->LookupPartition(txn->read_set(0)) == config->this_node_id &&
+          LookUpCustomer(CopyOf(storage, txn->read_set(0), &value),
+                         &customer_key))
+        txn->add_read_write_set(customer_key);
+      break;
+    }
+
+    case ORDER_STATUS:
+      PredictOrderStatus(CopyOf(storage, txn->read_set(3), &value), &keys);
+      for (size_t i = 0; i < keys.size(); i++)
+        txn->add_read_set(keys[i]);
+      break;
+
+    case DELIVERY:
+      for (int i = 0; i < DISTRICTS_PER_WAREHOUSE; i++) {
+        PredictDelivery(txn->read_set(1 + i),
+                        CopyOf(storage, txn->read_write_set(i), &value),
+                        storage, &keys);
+      }
+      for (size_t i = 0; i < keys.size(); i++)
+        txn->add_read_write_set(keys[i]);
+      break;
+
+    // Stock-level reads the order lines of the district's latest 20 orders
+    // and the stock of their items. TPC-C does not require it to be
+    // serializable, so it reads the orders placed by the time of this
+    // prediction and is never restarted. Orders and order lines never change
+    // once placed.
+    case STOCK_LEVEL: {
+      TPCCArgs tpcc_args;
+      tpcc_args.ParseFromString(txn->arg());
+      int latest_order_number = tpcc_args.lastest_order_number();
+      std::set<Key> items_used;
+      for (int i = latest_order_number;
+           (i >= 0) && (i > latest_order_number - 20); i--) {
+        Key order_key = txn->read_set(1) + "o" + IntToString(i);
+        if (!storage->CopyObject(order_key, &value))
+          continue;
+        int order_line_count = RecordIn<Order>(&value)->order_line_count;
+        for (int j = 0; j < order_line_count; j++) {
+          Key order_line_key = order_key + "ol" + IntToString(j);
+          if (!storage->CopyObject(order_line_key, &value))
+            continue;
+          Key item_key = RecordIn<OrderLine>(&value)->item_id;
+          if (items_used.count(item_key) > 0)
+            continue;
+          items_used.insert(item_key);
+          txn->add_read_set(order_line_key);
+          txn->add_read_set(txn->read_set(0) + "s" + item_key);
+        }
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+void TPCC::Repredict(TxnProto* txn) const {
+  // The keys execution found replace those predicted.
+  int first;
+  RepeatedPtrField<string>* keys = PredictedKeys(txn, &first);
+  if (keys == NULL)
+    return;
+  while (keys->size() > first)
+    keys->RemoveLast();
+  for (int i = 0; i < txn->dependent_keys_size(); i++)
+    keys->Add()->assign(txn->dependent_keys(i));
+  txn->clear_dependent_keys();
+}
+
 // The new order function is executed when the application receives a new order
 // transaction.  This follows the TPC-C standard.
 int TPCC::NewOrderTransaction(TxnProto* txn, StorageManager* storage) const {
   // First, we retrieve the warehouse from storage
-  Value* warehouse_value;
-  Warehouse* warehouse = new Warehouse();
-  warehouse_value = storage->ReadObject(txn->read_set(0));
-  assert(warehouse->ParseFromString(*warehouse_value));
-
-  // Next, we retrieve the district
-  District* district = new District();
-  Value* district_value = storage->ReadObject(txn->read_write_set(0));
-  assert(district->ParseFromString(*district_value));
-  // Increment the district's next order ID and put to datastore
-  district->set_next_order_id(district->next_order_id() + 1);
-  assert(district->SerializeToString(district_value));
-  // Not necessary since storage already has a pointer to district_value.
-  //   storage->PutObject(district->id(), district_value);
+  Warehouse* warehouse =
+      RecordIn<Warehouse>(storage->ReadObject(txn->read_set(0)));
+
+  // Next, we retrieve the district and increment its next order ID. Records
+  // are updated in place, storage already holds them.
+  District* district =
+      RecordIn<District>(storage->ReadObject(txn->read_write_set(0)));
+  district->next_order_id++;
 
   // Retrieve the customer we are looking for
-  Value* customer_value;
-  Customer* customer = new Customer();
-  customer_value = storage->ReadObject(txn->read_set(1));
-  assert(customer->ParseFromString(*customer_value));
+  Customer* customer =
+      RecordIn<Customer>(storage->ReadObject(txn->read_set(1)));
 
   // Next, we get the order line count, system time, and other args from the
   // transaction proto
-  TPCCArgs* tpcc_args = new TPCCArgs();
-  tpcc_args->ParseFromString(txn->arg());
-  int order_line_count = tpcc_args->order_line_count(0);
-  int order_number = tpcc_args->order_number();
-  double system_time = tpcc_args->system_time();
+  TPCCArgs tpcc_args;
+  tpcc_args.ParseFromString(txn->arg());
+  int order_line_count = tpcc_args.order_line_count(0);
+  double system_time = tpcc_args.system_time();
 
-  // Next we create an Order object
+  // Next we create an Order record
   Key order_key = txn->write_set(order_line_count + 1);
-  Order* order = new Order();
-  order->set_id(order_key);
-  order->set_warehouse_id(warehouse->id());
-  order->set_district_id(district->id());
-  order->set_customer_id(customer->id());
+  Order* order;
+  Value* order_value = NewRecord(&order);
+  SetField(order->id, order_key);
+  SetField(order->warehouse_id, warehouse->id);
+  SetField(order->district_id, district->id);
+  SetField(order->customer_id, customer->id);
 
   // Set some of the auxiliary data
-  order->set_entry_date(system_time);
-  order->set_carrier_id(-1);
-  order->set_order_line_count(order_line_count);
-  order->set_all_items_local(txn->multipartition());
+  order->entry_date = system_time;
+  order->carrier_id = -1;
+  order->order_line_count = order_line_count;
+  order->all_items_local = txn->multipartition();
 
   // We initialize the order line amount total to 0
   int order_line_amount_total = 0;
@@ -502,119 +621,82 @@ int TPCC::NewOrderTransaction(TxnProto* txn, StorageManager* storage) const {
   for (int i = 0; i < order_line_count; i++) {
     // For each order line we parse out the three args
 
-    string stock_key = txn->read_write_set(i + 1);
+    const string& stock_key = txn->read_write_set(i + 1);
     string supply_warehouse_key = stock_key.substr(0, stock_key.find("s"));
-    int quantity = tpcc_args->quantities(i);
+    int quantity = tpcc_args.quantities(i);
 
     // Find the item key within the stock key
     size_t item_idx = stock_key.find("i");
     string item_key = stock_key.substr(item_idx, string::npos);
 
     // First, we check if the item number is valid
-    Item* item = new Item();
-    if (item_key == "i-1")
+    if (item_key == "i-1") {
+      delete order_value;
       return FAILURE;
-    else
-      assert(item->ParseFromString(*GetItem(item_key)));
+    }
+    Item* item = RecordIn<Item>(GetItem(item_key));
 
-    // Next, we create a new order line object with std attributes
-    OrderLine* order_line = new OrderLine();
+    // Next, we create a new order line record with std attributes
+    OrderLine* order_line;
+    Value* order_line_value = NewRecord(&order_line);
     Key order_line_key = txn->write_set(i);
-    order_line->set_order_id(order_line_key);
+    SetField(order_line->order_id, order_line_key);
 
     // Set the attributes for this order line
-    order_line->set_district_id(district->id());
-    order_line->set_warehouse_id(warehouse->id());
-    order_line->set_number(i);
-    order_line->set_item_id(item_key);
-    order_line->set_supply_warehouse_id(supply_warehouse_key);
-    order_line->set_quantity(quantity);
-    order_line->set_delivery_date(system_time);
+    SetField(order_line->district_id, district->id);
+    SetField(order_line->warehouse_id, warehouse->id);
+    order_line->number = i;
+    SetField(order_line->item_id, item_key);
+    SetField(order_line->supply_warehouse_id, supply_warehouse_key);
+    order_line->quantity = quantity;
+    order_line->delivery_date = system_time;
 
     // Next, we get the correct stock from the data store
-    Stock* stock = new Stock();
-    Value* stock_value = storage->ReadObject(stock_key);
-    assert(stock->ParseFromString(*stock_value));
+    Stock* stock = RecordIn<Stock>(storage->ReadObject(stock_key));
 
     // Once we have it we can increase the YTD, order_count, and remote_count
-    stock->set_year_to_date(stock->year_to_date() + quantity);
-    stock->set_order_count(stock->order_count() - 1);
+    stock->year_to_date += quantity;
+    stock->order_count--;
     if (txn->multipartition())
-      stock->set_remote_count(stock->remote_count() + 1);
+      stock->remote_count++;
 
-    // And we decrease the stock's supply appropriately and rewrite to storage
-    if (stock->quantity() >= quantity + 10)
-      stock->set_quantity(stock->quantity() - quantity);
+    // And we decrease the stock's supply appropriately
+    if (stock->quantity >= quantity + 10)
+      stock->quantity -= quantity;
     else
-      stock->set_quantity(stock->quantity() - quantity + 91);
-
-    // Put the stock back into the database
-    assert(stock->SerializeToString(stock_value));
-    // Not necessary since storage already has a ptr to stock_value.
-    //   storage->PutObject(stock_key, stock_value);
-    delete stock;
+      stock->quantity += 91 - quantity;
 
     // Next, we update the order line's amount and add it to the running sum
-    order_line->set_amount(quantity * item->price());
-    order_line_amount_total += (quantity * item->price());
+    order_line->amount = quantity * item->price;
+    order_line_amount_total += (quantity * item->price);
 
     // Finally, we write the order line to storage
-    Value* order_line_value = new Value();
-    assert(order_line->SerializeToString(order_line_value));
     storage->PutObject(order_line_key, order_line_value);
-    // order->add_order_line_ptr(reinterpret_cast<uint64>(order_line_value));
-
-    pthread_mutex_lock(&mutex_for_item);
-    if (storage->configuration_->this_node_id ==
-        storage->configuration_->LookupPartition(txn->read_set(0)))
-      item_for_order_line[order_line_key] = StringToInt(item_key);
-    pthread_mutex_unlock(&mutex_for_item);
-    // Free memory
-    delete order_line;
-    delete item;
   }
 
-  // We create a new NewOrder object
+  // We create a new NewOrder record and put it in the datastore
   Key new_order_key = txn->write_set(order_line_count);
-  NewOrder* new_order = new NewOrder();
-  new_order->set_id(new_order_key);
-  new_order->set_warehouse_id(warehouse->id());
-  new_order->set_district_id(district->id());
-
-  // Serialize it and put it in the datastore
-  Value* new_order_value = new Value();
-  assert(new_order->SerializeToString(new_order_value));
+  NewOrder* new_order;
+  Value* new_order_value = NewRecord(&new_order);
+  SetField(new_order->id, new_order_key);
+  SetField(new_order->warehouse_id, warehouse->id);
+  SetField(new_order->district_id, district->id);
   storage->PutObject(new_order_key, new_order_value);
 
-  // Serialize order and put it in the datastore
-  Value* order_value = new Value();
-  assert(order->SerializeToString(order_value));
+  // Put the order in the datastore
   storage->PutObject(order_key, order_value);
 
-  if (storage->configuration_->this_node_id ==
-      storage->configuration_->LookupPartition(txn->read_set(0))) {
-    pthread_mutex_lock(&mutex_);
-    if (latest_order_id_for_customer.count(txn->read_set(1)) == 0)
-      involed_customers->push_back(txn->read_set(1));
-    latest_order_id_for_customer[txn->read_set(1)] = order_key;
-
-    if (smallest_order_id_for_district.count(txn->read_write_set(0)) == 0) {
-      smallest_order_id_for_district[txn->read_write_set(0)] = order_number;
-    }
-    order_line_number[order_key] = order_line_count;
-    customer_for_order[order_key] = txn->read_set(1);
-
-    latest_order_id_for_district[txn->read_write_set(0)] = order_number;
-    pthread_mutex_unlock(&mutex_);
-  }
+  // Finally, the order becomes the customer's latest. Index records are
+  // replaced rather than updated in place, so that clients copying them to
+  // predict dependent txns see either the old or the new one whole. The
+  // storage frees the old one.
+  LatestOrder* latest_order;
+  Value* latest_order_value = NewRecord(&latest_order);
+  SetField(latest_order->order_id, order_key);
+  latest_order->order_line_count = order_line_count;
+  storage->PutObject(txn->write_set(order_line_count + 2), latest_order_value);
 
   // Successfully completed transaction
-  delete warehouse;
-  delete district;
-  delete customer;
-  delete order;
-  delete new_order;
-  delete tpcc_args;
   return SUCCESS;
 }
 
@@ -622,505 +704,452 @@ int TPCC::NewOrderTransaction(TxnProto* txn, StorageManager* storage) const {
 // payment transaction.  This follows the TPC-C standard.
 int TPCC::PaymentTransaction(TxnProto* txn, StorageManager* storage) const {
   // First, we parse out the transaction args from the TPCC proto
-  TPCCArgs* tpcc_args = new TPCCArgs();
-  tpcc_args->ParseFromString(txn->arg());
-  int amount = tpcc_args->amount();
-
-  // We create a string to hold up the customer object we look up
-  Value* customer_value;
-  Key customer_key;
-
-  // If there's a last name we do secondary keying
-  if (tpcc_args->has_last_name()) {
-    Key secondary_key = tpcc_args->last_name();
-
-    // If the RW set is not at least of size 3, then no customer key was
-    // given to this transaction.  Otherwise, we perform a check to ensure
-    // the secondary key we just looked up agrees with our previous lookup
-    if (txn->read_write_set_size() < 3 ||
-        secondary_key != txn->read_write_set(2)) {
-      // Append the newly read key to write set
-      if (txn->read_write_set_size() < 3)
-        txn->add_read_write_set(secondary_key);
-
-      // Or the old one was incorrect so we overwrite it
-      else
-        txn->set_read_write_set(2, secondary_key);
-
+  TPCCArgs tpcc_args;
+  tpcc_args.ParseFromString(txn->arg());
+  int amount = tpcc_args.amount();
+
+  // If there's a last name we do secondary keying. The customer must be the
+  // one predicted, otherwise the txn is restarted with the one found before
+  // anything is written.
+  if (tpcc_args.has_last_name()) {
+    vector<Key> found_key(1);
+    if (!LookUpCustomer(storage->ReadObject(txn->read_set(0)), &found_key[0]))
+      return FAILURE;
+    if (!CheckPrediction(txn, found_key))
       return REDO;
-      // Otherwise, we look up the customer's key
-    } else {
-      customer_value = storage->ReadObject(tpcc_args->last_name());
-    }
-
-    // Otherwise we use the final argument
-  } else {
-    customer_key = txn->read_write_set(2);
-    customer_value = storage->ReadObject(customer_key);
   }
+  const Key& customer_key = txn->read_write_set(2);
 
-  // Deserialize the warehouse object
-  Key warehouse_key = txn->read_write_set(0);
-  Value* warehouse_value = storage->ReadObject(warehouse_key);
-  Warehouse* warehouse = new Warehouse();
-  assert(warehouse->ParseFromString(*warehouse_value));
-
-  // Next, we update the values of the warehouse and write it out
-  warehouse->set_year_to_date(warehouse->year_to_date() + amount);
-  assert(warehouse->SerializeToString(warehouse_value));
-  // Not necessary since storage already has a pointer to warehouse_value.
-  //   storage->PutObject(warehouse_key, warehouse_value);
-
-  // Deserialize the district object
-  Key district_key = txn->read_write_set(1);
-  Value* district_value = storage->ReadObject(district_key);
-  District* district = new District();
-  assert(district->ParseFromString(*district_value));
-
-  // Next, we update the values of the district and write it out
-  district->set_year_to_date(district->year_to_date() + amount);
-  assert(district->SerializeToString(district_value));
-  // Not necessary since storage already has a pointer to district_value.
-  //   storage->PutObject(district_key, district_value);
-
-  // We deserialize the customer
-  Customer* customer = new Customer();
-  assert(customer->ParseFromString(*customer_value));
+  // Next, we update the warehouse and the district in place
+  const Key& warehouse_key = txn->read_write_set(0);
+  Warehouse* warehouse =
+      RecordIn<Warehouse>(storage->ReadObject(warehouse_key));
+  warehouse->year_to_date += amount;
+
+  const Key& district_key = txn->read_write_set(1);
+  District* district = RecordIn<District>(storage->ReadObject(district_key));
+  district->year_to_date += amount;
 
   // Next, we update the customer's balance, payment and payment count
-  customer->set_balance(customer->balance() - amount);
-  customer->set_year_to_date_payment(customer->year_to_date_payment() + amount);
-  customer->set_payment_count(customer->payment_count() + 1);
+  Customer* customer = RecordIn<Customer>(storage->ReadObject(customer_key));
+  customer->balance -= amount;
+  customer->year_to_date_payment += amount;
+  customer->payment_count++;
 
   // If the customer has bad credit, we update the data information attached
   // to her
-  if (customer->credit() == "BC") {
-    string data = customer->data();
+  if (strcmp(customer->credit, "BC") == 0) {
     char new_information[500];
 
     // Print the new_information into the buffer
     snprintf(new_information, sizeof(new_information), "%s%s%s%s%s%d%s",
-             customer->id().c_str(), customer->warehouse_id().c_str(),
-             customer->district_id().c_str(), district->id().c_str(),
-             warehouse->id().c_str(), amount, customer->data().c_str());
+             customer->id, customer->warehouse_id, customer->district_id,
+             district->id, warehouse->id, amount, customer->data);
   }
 
-  // We write the customer to disk
-  assert(customer->SerializeToString(customer_value));
-  // Not necessary since storage already has a pointer to customer_value.
-  //   storage->PutObject(customer_key, customer_value);
-
-  // Finally, we create a history object and update the data
-  History* history = new History();
-  history->set_customer_id(customer_key);
-  history->set_customer_warehouse_id(customer->warehouse_id());
-  history->set_customer_district_id(customer->district_id());
-  history->set_warehouse_id(warehouse_key);
-  history->set_district_id(district_key);
-
-  // Create the data for the history object
-  char history_data[100];
-  snprintf(history_data, sizeof(history_data), "%s    %s",
-           warehouse->name().c_str(), district->name().c_str());
-  history->set_data(history_data);
-
-  // Write the history object to disk
-  Value* history_value = new Value();
-  assert(history->SerializeToString(history_value));
+  // Finally, we create a history record and update the data
+  History* history;
+  Value* history_value = NewRecord(&history);
+  SetField(history->customer_id, customer_key);
+  SetField(history->customer_warehouse_id, customer->warehouse_id);
+  SetField(history->customer_district_id, customer->district_id);
+  SetField(history->warehouse_id, warehouse->id);
+  SetField(history->district_id, district->id);
+
+  // Create the data for the history record
+  snprintf(history->data, sizeof(history->data), "%s    %s", warehouse->name,
+           district->name);
+
+  // Write the history record to storage
   storage->PutObject(txn->write_set(0), history_value);
 
   // Successfully completed transaction
-  delete customer;
-  delete history;
-  delete district;
-  delete warehouse;
-  delete tpcc_args;
   return SUCCESS;
 }
 
 int TPCC::OrderStatusTransaction(TxnProto* txn, StorageManager* storage) const {
-  TPCCArgs* tpcc_args = new TPCCArgs();
-  tpcc_args->ParseFromString(txn->arg());
-  int order_line_count = tpcc_args->order_line_count(0);
-
-  Value* warehouse_value;
-  Warehouse* warehouse = new Warehouse();
-  warehouse_value = storage->ReadObject(txn->read_set(0));
-  assert(warehouse->ParseFromString(*warehouse_value));
-
-  District* district = new District();
-  Value* district_value = storage->ReadObject(txn->read_set(1));
-  assert(district->ParseFromString(*district_value));
-
-  Value* customer_value;
-  Customer* customer = new Customer();
-  customer_value = storage->ReadObject(txn->read_set(2));
-  assert(customer->ParseFromString(*customer_value));
-
-  //  double customer_balance = customer->balance();
-  string customer_first = customer->first();
-  string customer_middle = customer->middle();
-  string customer_last = customer->last();
-
-  Order* order = new Order();
-  Value* order_value = storage->ReadObject(txn->read_set(3));
-  assert(order->ParseFromString(*order_value));
-  //  int carrier_id = order->carrier_id();
-  //  double entry_date = order->entry_date();
-
-  for (int i = 0; i < order_line_count; i++) {
-    OrderLine* order_line = new OrderLine();
-    Value* order_line_value = storage->ReadObject(txn->read_set(4 + i));
-    assert(order_line->ParseFromString(*order_line_value));
-    string item_key = order_line->item_id();
-    string supply_warehouse_id = order_line->supply_warehouse_id();
-    //    int quantity = order_line->quantity();
-    //    double amount = order_line->amount();
-    //    double delivery_date = order_line->delivery_date();
-
-    delete order_line;
-  }
+  // The customer's latest order must be the one predicted, otherwise the txn
+  // is restarted with the one found.
+  vector<Key> order_keys;
+  PredictOrderStatus(storage->ReadObject(txn->read_set(3)), &order_keys);
+  if (!CheckPrediction(txn, order_keys))
+    return REDO;
+
+  // Order-status shows the customer and the lines of the customer's latest
+  // order. Nothing is returned to the client, so the records are only looked
+  // up.
+  RecordIn<Warehouse>(storage->ReadObject(txn->read_set(0)));
+  RecordIn<District>(storage->ReadObject(txn->read_set(1)));
+  RecordIn<Customer>(storage->ReadObject(txn->read_set(2)));
+
+  // A customer that has not ordered yet has no order to show.
+  if (order_keys.empty())
+    return SUCCESS;
 
-  delete warehouse;
-  delete district;
-  delete customer;
-  delete order;
+  RecordIn<Order>(storage->ReadObject(txn->read_set(4)));
+  int order_line_count = order_keys.size() - 1;
+  for (int i = 0; i < order_line_count; i++)
+    RecordIn<OrderLine>(storage->ReadObject(txn->read_set(5 + i)));
 
   return SUCCESS;
 }
 
 int TPCC::StockLevelTransaction(TxnProto* txn, StorageManager* storage) const {
   int low_stock = 0;
-  TPCCArgs* tpcc_args = new TPCCArgs();
-  tpcc_args->ParseFromString(txn->arg());
-  int threshold = tpcc_args->threshold();
-
-  Value* warehouse_value;
-  Warehouse* warehouse = new Warehouse();
-  warehouse_value = storage->ReadObject(txn->read_set(0));
-  assert(warehouse->ParseFromString(*warehouse_value));
+  TPCCArgs tpcc_args;
+  tpcc_args.ParseFromString(txn->arg());
+  int threshold = tpcc_args.threshold();
 
-  District* district = new District();
-  Value* district_value = storage->ReadObject(txn->read_set(1));
-  assert(district->ParseFromString(*district_value));
-
-  int index = 0;
+  RecordIn<Warehouse>(storage->ReadObject(txn->read_set(0)));
+  RecordIn<District>(storage->ReadObject(txn->read_set(1)));
 
+  // Each order line is followed by the stock of its item.
   int cycle = (txn->read_set_size() - 2) / 2;
   for (int i = 0; i < cycle; i++) {
-    OrderLine* order_line = new OrderLine();
-    Value* order_line_value = storage->ReadObject(txn->read_set(2 + index));
-    index++;
-    assert(order_line->ParseFromString(*order_line_value));
-    string item_key = order_line->item_id();
-
-    Stock* stock = new Stock();
-    Value* stock_value = storage->ReadObject(txn->read_set(2 + index));
-    index++;
-    assert(stock->ParseFromString(*stock_value));
-    if (stock->quantity() < threshold) {
+    RecordIn<OrderLine>(storage->ReadObject(txn->read_set(2 + 2 * i)));
+    Stock* stock =
+        RecordIn<Stock>(storage->ReadObject(txn->read_set(3 + 2 * i)));
+    if (stock->quantity < threshold) {
       low_stock++;
     }
-
-    delete order_line;
-    delete stock;
   }
 
-  delete warehouse;
-  delete district;
   return SUCCESS;
 }
 
 int TPCC::DeliveryTransaction(TxnProto* txn, StorageManager* storage) const {
-  TPCCArgs* tpcc_args = new TPCCArgs();
-  tpcc_args->ParseFromString(txn->arg());
+  // The oldest undelivered orders must be the ones predicted, otherwise the
+  // txn is restarted with the ones found. The districts' indexes are read
+  // under locks, and the orders they lead to have been placed by txns ordered
+  // earlier, as placing an order writes the district.
+  vector<Key> keys;
+  bool delivered[DISTRICTS_PER_WAREHOUSE];
+  for (int i = 0; i < DISTRICTS_PER_WAREHOUSE; i++) {
+    size_t predicted = keys.size();
+    PredictDelivery(txn->read_set(1 + i),
+                    storage->ReadObject(txn->read_write_set(i)),
+                    storage->GetStorage(), &keys);
+    delivered[i] = keys.size() > predicted;
+  }
+  if (!CheckPrediction(txn, keys))
+    return REDO;
 
-  Value* warehouse_value;
-  Warehouse* warehouse = new Warehouse();
-  warehouse_value = storage->ReadObject(txn->read_set(0));
-  assert(warehouse->ParseFromString(*warehouse_value));
+  RecordIn<Warehouse>(storage->ReadObject(txn->read_set(0)));
 
-  if (txn->read_set_size() == 1) {
-    delete warehouse;
-    return SUCCESS;
-  }
+  // The carrier and delivery date come from the client, so that replicas and
+  // replays deliver alike.
+  TPCCArgs tpcc_args;
+  tpcc_args.ParseFromString(txn->arg());
 
-  int delivery_district_number = txn->read_set_size() - 1;
-  int read_write_index = 0;
-  int line_count_index = 0;
-  for (int i = 1; i <= delivery_district_number; i++) {
-    District* district = new District();
-    Value* district_value = storage->ReadObject(txn->read_set(i));
-    assert(district->ParseFromString(*district_value));
+  int read_write_index = DISTRICTS_PER_WAREHOUSE;
+  for (int i = 0; i < DISTRICTS_PER_WAREHOUSE; i++) {
+    if (!delivered[i])
+      continue;
+    RecordIn<District>(storage->ReadObject(txn->read_set(1 + i)));
 
     storage->DeleteObject(txn->read_write_set(read_write_index));
     read_write_index++;
 
-    Order* order = new Order();
-    Value* order_value =
-        storage->ReadObject(txn->read_write_set(read_write_index));
+    Order* order = RecordIn<Order>(
+        storage->ReadObject(txn->read_write_set(read_write_index)));
     read_write_index++;
-    assert(order->ParseFromString(*order_value));
-    char customer_key[128];
-    snprintf(customer_key, sizeof(customer_key), "%s",
-             order->customer_id().c_str());
+    order->carrier_id = tpcc_args.carrier_id();
 
-    order->set_carrier_id(rand() % 10);
-
-    int ol_number = tpcc_args->order_line_count(line_count_index);
-    line_count_index++;
     double total_amount = 0;
-
-    for (int j = 0; j < ol_number; j++) {
-      OrderLine* order_line = new OrderLine();
-      Value* order_line_value =
-          storage->ReadObject(txn->read_write_set(read_write_index));
+    for (int j = 0; j < order->order_line_count; j++) {
+      OrderLine* order_line = RecordIn<OrderLine>(
+          storage->ReadObject(txn->read_write_set(read_write_index)));
       read_write_index++;
-      assert(order_line->ParseFromString(*order_line_value));
-      order_line->set_delivery_date(GetTime());
-      total_amount = total_amount + order_line->amount();
-
-      delete order_line;
+      order_line->delivery_date = tpcc_args.system_time();
+      total_amount = total_amount + order_line->amount;
     }
 
-    Customer* customer = new Customer();
-    Value* customer_value =
-        storage->ReadObject(txn->read_write_set(read_write_index));
+    Customer* customer = RecordIn<Customer>(
+        storage->ReadObject(txn->read_write_set(read_write_index)));
     read_write_index++;
-    assert(customer->ParseFromString(*customer_value));
-    customer->set_balance(customer->balance() + total_amount);
-    customer->set_delivery_count(customer->delivery_count() + 1);
-
-    delete district;
-    delete order;
-    delete customer;
+    customer->balance += total_amount;
+    customer->delivery_count++;
+
+    // The next new order of the district is now the oldest. Like all index
+    // records, the index is replaced rather than updated in place.
+    OldestNewOrder* oldest_new_order;
+    Value* oldest_new_order_value = NewRecord(&oldest_new_order);
+    oldest_new_order->order_number =
+        RecordIn<OldestNewOrder>(storage->ReadObject(txn->read_write_set(i)))
+            ->order_number + 1;
+    storage->PutObject(txn->read_write_set(i), oldest_new_order_value);
   }
 
-  delete warehouse;
   return SUCCESS;
 }
 
+namespace {
+
+// The warehouses this node loads, by position in 'warehouses'.
+struct LocalWarehouses {
+  const TPCC* tpcc;
+  vector<int> warehouses;
+};
+
+void LoadLocalWarehouses(int64 lo, int64 hi, LoadBuffer* buffer, void* arg) {
+  LocalWarehouses* local = reinterpret_cast<LocalWarehouses*>(arg);
+  unsigned int seed = 1000 + lo;
+  for (int64 i = lo; i < hi; i++)
+    local->tpcc->LoadWarehouse(local->warehouses[i], buffer, &seed);
+}
+
+}  // namespace
+
 // The initialize function is executed when an initialize transaction comes
 // through, indicating we should populate the database with fake data
 void TPCC::InitializeStorage(Storage* storage, Configuration* conf) const {
-  // We create and write out all of the warehouses
+  // Every key of a warehouse's districts, customers and stock is partitioned
+  // by the warehouse id, so the local warehouses are all that is looked up.
+  LocalWarehouses local;
+  local.tpcc = this;
   for (int i = 0; i < (int)(WAREHOUSES_PER_NODE * conf->all_nodes.size());
        i++) {
-    // First, we create a key for the warehouse
-    char warehouse_key[128], warehouse_key_ytd[128];
-    Value* warehouse_value = new Value();
+    char warehouse_key[128];
     snprintf(warehouse_key, sizeof(warehouse_key), "w%d", i);
-    snprintf(warehouse_key_ytd, sizeof(warehouse_key_ytd), "w%dy", i);
-    if (conf->LookupPartition(warehouse_key) != conf->this_node_id) {
-      continue;
-    }
-    // Next we initialize the object and serialize it
-    Warehouse* warehouse = CreateWarehouse(warehouse_key);
-    assert(warehouse->SerializeToString(warehouse_value));
-
-    // Finally, we pass it off to the storage manager to write to disk
-    if (conf->LookupPartition(warehouse_key) == conf->this_node_id) {
-      storage->PutObject(warehouse_key, warehouse_value);
-      storage->PutObject(warehouse_key_ytd, new Value(*warehouse_value));
-    }
+    if (conf->LookupPartition(warehouse_key) == conf->this_node_id)
+      local.warehouses.push_back(i);
+  }
 
-    // Next, we create and write out all of the districts
-    for (int j = 0; j < DISTRICTS_PER_WAREHOUSE; j++) {
-      // First, we create a key for the district
-      char district_key[128], district_key_ytd[128];
-      snprintf(district_key, sizeof(district_key), "w%dd%d", i, j);
-      snprintf(district_key_ytd, sizeof(district_key_ytd), "w%dd%dy", i, j);
+  storage->Reserve(static_cast<int64>(local.warehouses.size()) *
+                   (2 + 3 * DISTRICTS_PER_WAREHOUSE +
+                    DISTRICTS_PER_WAREHOUSE * CUSTOMERS_PER_DISTRICT +
+                    NUMBER_OF_ITEMS));
+  ParallelLoad("TPC-C", storage, local.warehouses.size(),
+               &LoadLocalWarehouses, &local);
 
-      // Next we initialize the object and serialize it
-      Value* district_value = new Value();
-      District* district = CreateDistrict(district_key, warehouse_key);
-      assert(district->SerializeToString(district_value));
+  // Finally, all the items are initialized
+  InitializeItems();
+}
 
-      // Finally, we pass it off to the storage manager to write to disk
-      if (conf->LookupPartition(district_key) == conf->this_node_id) {
-        storage->PutObject(district_key, district_value);
-        storage->PutObject(district_key_ytd, new Value(*district_value));
-      }
+void TPCC::InitializeItems() const {
+  srand(1000);
+  for (int i = 0; i < NUMBER_OF_ITEMS; i++) {
+    // First, we create a key for the item
+    char item_key[128];
+    snprintf(item_key, sizeof(item_key), "i%d", i);
 
-      // Next, we create and write out all of the customers
-      for (int k = 0; k < CUSTOMERS_PER_DISTRICT; k++) {
-        // First, we create a key for the customer
-        char customer_key[128];
-        snprintf(customer_key, sizeof(customer_key), "w%dd%dc%d", i, j, k);
-
-        // Next we initialize the object and serialize it
-        Value* customer_value = new Value();
-        Customer* customer =
-            CreateCustomer(customer_key, district_key, warehouse_key);
-        assert(customer->SerializeToString(customer_value));
-
-        // Finally, we pass it off to the storage manager to write to disk
-        if (conf->LookupPartition(customer_key) == conf->this_node_id)
-          storage->PutObject(customer_key, customer_value);
-        delete customer;
-      }
+    // And pass it off to the local record of items
+    SetItem(string(item_key), CreateItem(item_key));
+  }
+}
 
-      // Free storage
-      delete district;
+void TPCC::RestoreOrderNumbers(Storage* storage, Configuration* conf) const {
+  // Districts count their orders from 1, NewTxn() numbers them from 0.
+  for (int i = 0; i < (int)(WAREHOUSES_PER_NODE * conf->all_nodes.size());
+       i++) {
+    char warehouse_key[128];
+    snprintf(warehouse_key, sizeof(warehouse_key), "w%d", i);
+    if (conf->LookupPartition(warehouse_key) != conf->this_node_id)
+      continue;
+    for (int j = 0; j < DISTRICTS_PER_WAREHOUSE; j++) {
+      char district_key[128];
+      snprintf(district_key, sizeof(district_key), "w%dd%d", i, j);
+      Value value;
+      if (storage->CopyObject(district_key, &value))
+        next_order_number_[district_key] =
+            RecordIn<District>(&value)->next_order_id - 1;
+    }
+  }
+}
+
+void TPCC::LoadWarehouse(int warehouse, LoadBuffer* buffer,
+                         unsigned int* seed) const {
+  // We create and write out the warehouse
+  char warehouse_key[128], warehouse_key_ytd[128];
+  snprintf(warehouse_key, sizeof(warehouse_key), "w%d", warehouse);
+  snprintf(warehouse_key_ytd, sizeof(warehouse_key_ytd), "w%dy", warehouse);
+  Value* warehouse_value = CreateWarehouse(warehouse_key, seed);
+  buffer->Put(warehouse_key, warehouse_value);
+  buffer->Put(warehouse_key_ytd, new Value(*warehouse_value));
+
+  // Next, we create and write out all of the districts
+  for (int j = 0; j < DISTRICTS_PER_WAREHOUSE; j++) {
+    char district_key[128], district_key_ytd[128];
+    snprintf(district_key, sizeof(district_key), "w%dd%d", warehouse, j);
+    snprintf(district_key_ytd, sizeof(district_key_ytd), "w%dd%dy", warehouse,
+             j);
+    Value* district_value = CreateDistrict(district_key, warehouse_key, seed);
+    buffer->Put(district_key, district_value);
+    buffer->Put(district_key_ytd, new Value(*district_value));
+
+    // Next, we create and write out all of the customers. TPC-C gives each
+    // last name to one of the first 1000 customers of a district, and
+    // non-uniformly random ones to the rest.
+    map<string, vector<pair<string, string> > > customers_by_last_name;
+    for (int k = 0; k < CUSTOMERS_PER_DISTRICT; k++) {
+      char customer_key[128];
+      snprintf(customer_key, sizeof(customer_key), "w%dd%dc%d", warehouse, j,
+               k);
+      Value* customer_value =
+          CreateCustomer(customer_key, district_key, warehouse_key, seed);
+      Customer* customer = RecordIn<Customer>(customer_value);
+      SetField(customer->last,
+               LastName(k < 1000 ? k : NURand(255, 0, 999, seed)));
+      customers_by_last_name[customer->last].push_back(
+          make_pair(string(customer->first), string(customer_key)));
+      buffer->Put(customer_key, customer_value);
     }
 
-    // Next, we create and write out all of the stock
-    for (int j = 0; j < NUMBER_OF_ITEMS; j++) {
-      // First, we create a key for the stock
-      char item_key[128];
-      Value* stock_value = new Value();
-      snprintf(item_key, sizeof(item_key), "i%d", j);
-
-      // Next we initialize the object and serialize it
-      Stock* stock = CreateStock(item_key, warehouse_key);
-      assert(stock->SerializeToString(stock_value));
-
-      // Finally, we pass it off to the storage manager to write to disk
-      if (conf->LookupPartition(stock->id()) == conf->this_node_id)
-        storage->PutObject(stock->id(), stock_value);
-      delete stock;
+    // And the district's index of them by last name.
+    for (map<string, vector<pair<string, string> > >::iterator it =
+             customers_by_last_name.begin();
+         it != customers_by_last_name.end(); ++it) {
+      std::sort(it->second.begin(), it->second.end());
+      CustomerIndex index;
+      for (size_t k = 0; k < it->second.size(); k++)
+        index.add_customer_ids(it->second[k].second);
+      Value* index_value = new Value();
+      assert(index.SerializeToString(index_value));
+      buffer->Put(string(district_key) + "ln" + it->first, index_value);
     }
 
-    // Free storage
-    delete warehouse;
+    // The district has no new orders yet, the first will be number 0.
+    OldestNewOrder* oldest_new_order;
+    Value* oldest_new_order_value = NewRecord(&oldest_new_order);
+    oldest_new_order->order_number = 0;
+    buffer->Put(string(district_key) + "on", oldest_new_order_value);
   }
 
-  // Finally, all the items are initialized
-  srand(1000);
-  for (int i = 0; i < NUMBER_OF_ITEMS; i++) {
-    // First, we create a key for the item
+  // Next, we create and write out all of the stock
+  for (int j = 0; j < NUMBER_OF_ITEMS; j++) {
     char item_key[128];
-    Value* item_value = new Value();
-    snprintf(item_key, sizeof(item_key), "i%d", i);
-
-    // Next we initialize the object and serialize it
-    Item* item = CreateItem(item_key);
-    assert(item->SerializeToString(item_value));
-
-    // Finally, we pass it off to the local record of items
-    SetItem(string(item_key), item_value);
-    delete item;
+    snprintf(item_key, sizeof(item_key), "i%d", j);
+    Value* stock_value = CreateStock(item_key, warehouse_key, seed);
+    buffer->Put(RecordIn<Stock>(stock_value)->id, stock_value);
   }
 }
 
-// The following method is a dumb constructor for the warehouse protobuffer
-Warehouse* TPCC::CreateWarehouse(Key warehouse_key) const {
-  Warehouse* warehouse = new Warehouse();
+// The following method is a dumb constructor for the warehouse record
+Value* TPCC::CreateWarehouse(Key warehouse_key, unsigned int* seed) const {
+  Warehouse* warehouse;
+  Value* warehouse_value = NewRecord(&warehouse);
 
   // We initialize the id and the name fields
-  warehouse->set_id(warehouse_key);
-  warehouse->set_name(RandomString(10));
+  SetField(warehouse->id, warehouse_key);
+  SetField(warehouse->name, RandomString(10, seed));
 
   // Provide some information to make TPC-C happy
-  warehouse->set_street_1(RandomString(20));
-  warehouse->set_street_2(RandomString(20));
-  warehouse->set_city(RandomString(20));
-  warehouse->set_state(RandomString(2));
-  warehouse->set_zip(RandomString(9));
+  SetField(warehouse->street_1, RandomString(20, seed));
+  SetField(warehouse->street_2, RandomString(20, seed));
+  SetField(warehouse->city, RandomString(20, seed));
+  SetField(warehouse->state, RandomString(2, seed));
+  SetField(warehouse->zip, RandomString(9, seed));
 
   // Set default financial information
-  warehouse->set_tax(0.05);
-  warehouse->set_year_to_date(0.0);
+  warehouse->tax = 0.05;
+  warehouse->year_to_date = 0.0;
 
-  return warehouse;
+  return warehouse_value;
 }
 
-District* TPCC::CreateDistrict(Key district_key, Key warehouse_key) const {
-  District* district = new District();
+Value* TPCC::CreateDistrict(Key district_key, Key warehouse_key,
+                            unsigned int* seed) const {
+  District* district;
+  Value* district_value = NewRecord(&district);
 
   // We initialize the id and the name fields
-  district->set_id(district_key);
-  district->set_warehouse_id(warehouse_key);
-  district->set_name(RandomString(10));
+  SetField(district->id, district_key);
+  SetField(district->warehouse_id, warehouse_key);
+  SetField(district->name, RandomString(10, seed));
 
   // Provide some information to make TPC-C happy
-  district->set_street_1(RandomString(20));
-  district->set_street_2(RandomString(20));
-  district->set_city(RandomString(20));
-  district->set_state(RandomString(2));
-  district->set_zip(RandomString(9));
+  SetField(district->street_1, RandomString(20, seed));
+  SetField(district->street_2, RandomString(20, seed));
+  SetField(district->city, RandomString(20, seed));
+  SetField(district->state, RandomString(2, seed));
+  SetField(district->zip, RandomString(9, seed));
 
   // Set default financial information
-  district->set_tax(0.05);
-  district->set_year_to_date(0.0);
-  district->set_next_order_id(1);
+  district->tax = 0.05;
+  district->year_to_date = 0.0;
+  district->next_order_id = 1;
 
-  return district;
+  return district_value;
 }
 
-Customer* TPCC::CreateCustomer(Key customer_key,
-                               Key district_key,
-                               Key warehouse_key) const {
-  Customer* customer = new Customer();
+Value* TPCC::CreateCustomer(Key customer_key,
+                            Key district_key,
+                            Key warehouse_key,
+                            unsigned int* seed) const {
+  Customer* customer;
+  Value* customer_value = NewRecord(&customer);
 
   // We initialize the various keys
-  customer->set_id(customer_key);
-  customer->set_district_id(district_key);
-  customer->set_warehouse_id(warehouse_key);
+  SetField(customer->id, customer_key);
+  SetField(customer->district_id, district_key);
+  SetField(customer->warehouse_id, warehouse_key);
 
   // Next, we create a first and middle name
-  customer->set_first(RandomString(20));
-  customer->set_middle(RandomString(20));
-  customer->set_last(customer_key);
+  SetField(customer->first, RandomString(20, seed));
+  SetField(customer->middle, RandomString(20, seed));
+  SetField(customer->last, customer_key);
 
   // Provide some information to make TPC-C happy
-  customer->set_street_1(RandomString(20));
-  customer->set_street_2(RandomString(20));
-  customer->set_city(RandomString(20));
-  customer->set_state(RandomString(2));
-  customer->set_zip(RandomString(9));
+  SetField(customer->street_1, RandomString(20, seed));
+  SetField(customer->street_2, RandomString(20, seed));
+  SetField(customer->city, RandomString(20, seed));
+  SetField(customer->state, RandomString(2, seed));
+  SetField(customer->zip, RandomString(9, seed));
 
   // Set default financial information
-  customer->set_since(0);
-  customer->set_credit("GC");
-  customer->set_credit_limit(0.01);
-  customer->set_discount(0.5);
-  customer->set_balance(0);
-  customer->set_year_to_date_payment(0);
-  customer->set_payment_count(0);
-  customer->set_delivery_count(0);
+  customer->since = 0;
+  SetField(customer->credit, "GC");
+  customer->credit_limit = 0.01;
+  customer->discount = 0.5;
+  customer->balance = 0;
+  customer->year_to_date_payment = 0;
+  customer->payment_count = 0;
+  customer->delivery_count = 0;
 
   // Set some miscellaneous data
-  customer->set_data(RandomString(50));
+  SetField(customer->data, RandomString(50, seed));
 
-  return customer;
+  return customer_value;
 }
 
-Stock* TPCC::CreateStock(Key item_key, Key warehouse_key) const {
-  Stock* stock = new Stock();
+Value* TPCC::CreateStock(Key item_key, Key warehouse_key,
+                         unsigned int* seed) const {
+  Stock* stock;
+  Value* stock_value = NewRecord(&stock);
 
   // We initialize the various keys
   char stock_key[128];
   snprintf(stock_key, sizeof(stock_key), "%ss%s", warehouse_key.c_str(),
            item_key.c_str());
-  stock->set_id(stock_key);
-  stock->set_warehouse_id(warehouse_key);
-  stock->set_item_id(item_key);
+  SetField(stock->id, stock_key);
+  SetField(stock->warehouse_id, warehouse_key);
+  SetField(stock->item_id, item_key);
 
   // Next, we create a first and middle name
-  stock->set_quantity(rand() % 100 + 100);
+  stock->quantity = Rand(seed) % 100 + 100;
 
   // Set default financial information
-  stock->set_year_to_date(0);
-  stock->set_order_count(0);
-  stock->set_remote_count(0);
+  stock->year_to_date = 0;
+  stock->order_count = 0;
+  stock->remote_count = 0;
 
   // Set some miscellaneous data
-  stock->set_data(RandomString(50));
+  SetField(stock->data, RandomString(50, seed));
 
-  return stock;
+  return stock_value;
 }
 
-Item* TPCC::CreateItem(Key item_key) const {
-  Item* item = new Item();
+Value* TPCC::CreateItem(Key item_key) const {
+  Item* item;
+  Value* item_value = NewRecord(&item);
 
   // We initialize the item's key
-  item->set_id(item_key);
+  SetField(item->id, item_key);
 
   // Initialize some fake data for the name, price and data
-  item->set_name(RandomString(24));
-  item->set_price(rand() % 100);
-  item->set_data(RandomString(50));
+  SetField(item->name, RandomString(24));
+  item->price = rand() % 100;
+  SetField(item->data, RandomString(50));
 
-  return item;
+  return item_value;
 }
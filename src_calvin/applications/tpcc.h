@@ -18,14 +18,12 @@
 #define CUSTOMERS_PER_DISTRICT 3000
 #define CUSTOMERS_PER_NODE (DISTRICTS_PER_NODE * CUSTOMERS_PER_DISTRICT)
 #define NUMBER_OF_ITEMS 100000
+// Share of payments that look their customer up by last name (TPC-C: 60%).
+#define PAYMENTS_BY_LAST_NAME 0.6
 
 using std::string;
 
-class Warehouse;
-class District;
-class Customer;
-class Item;
-class Stock;
+class LoadBuffer;
 
 class TPCC : public Application {
  public:
@@ -85,19 +83,44 @@ class TPCC : public Application {
   // Simple execution of a transaction using a given storage
   virtual int Execute(TxnProto* txn, StorageManager* storage) const;
 
+  // Payments by last name, order-status and delivery are dependent txns:
+  // their customer or orders are predicted from the secondary indexes stored
+  // with the district or customer (see proto/tpcc.proto). Stock-level's
+  // latest orders are predicted too, but it is never restarted.
+  virtual void Reconnoiter(TxnProto* txn, Storage* storage,
+                           Configuration* config) const;
+  virtual void Repredict(TxnProto* txn) const;
+
   /* TODO(Thad): Uncomment once testing friend class exists
    private: */
   // When the first transaction is called, the following function initializes
   // a set of fake data for use in the application
   virtual void InitializeStorage(Storage* storage, Configuration* conf) const;
 
+  // Builds the items, which every node keeps outside of storage. Called by
+  // InitializeStorage(), and on its own when storage is restored from a
+  // checkpoint instead.
+  void InitializeItems() const;
+
+  // Makes NewTxn() go on numbering the orders of this node's districts where
+  // 'storage', restored from a checkpoint, left off.
+  void RestoreOrderNumbers(Storage* storage, Configuration* conf) const;
+
   // The following methods are simple randomized initializers that provide us
-  // fake data for our TPC-C function
-  Warehouse* CreateWarehouse(Key id) const;
-  District* CreateDistrict(Key id, Key warehouse_id) const;
-  Customer* CreateCustomer(Key id, Key district_id, Key warehouse_id) const;
-  Item* CreateItem(Key id) const;
-  Stock* CreateStock(Key id, Key warehouse_id) const;
+  // fake data for our TPC-C function. Each returns a new value holding the
+  // record (see applications/tpcc_records.h). If 'seed' is given it is used
+  // instead of rand()'s global state.
+  Value* CreateWarehouse(Key id, unsigned int* seed = NULL) const;
+  Value* CreateDistrict(Key id, Key warehouse_id,
+                        unsigned int* seed = NULL) const;
+  Value* CreateCustomer(Key id, Key district_id, Key warehouse_id,
+                        unsigned int* seed = NULL) const;
+  Value* CreateItem(Key id) const;
+  Value* CreateStock(Key id, Key warehouse_id, unsigned int* seed = NULL) const;
+
+  // Creates warehouse 'warehouse' with its districts, customers and stock.
+  void LoadWarehouse(int warehouse, LoadBuffer* buffer,
+                     unsigned int* seed) const;
 
   // A NewOrder call takes a set of args and a transaction id and performs
   // the new order transaction as specified by TPC-C.  The return is 1 for
@@ -117,6 +140,10 @@ class TPCC : public Application {
   // The following are implementations of retrieval and writing for local items
   Value* GetItem(Key key) const;
   void SetItem(Key key, Value* value) const;
+
+  // Number of the next new order NewTxn() places in each district. Only the
+  // client generating this node's txns uses it.
+  mutable unordered_map<Key, int> next_order_number_;
 };
 
 #endif  // _DB_APPLICATIONS_TPCC_H_
@@ -0,0 +1,183 @@
+// The records of the TPC-C tables.
+//
+// Each record has a fixed layout and is stored as the bytes of its Value, so
+// txns use it in place: RecordIn() returns the record a value holds, and a
+// field is updated by assigning to it, without parsing and serializing the
+// row. Records hold no pointers, so checkpoints and remote reads copy them
+// as they are, like any other value. Strings are kept NUL-terminated in
+// fields sized for the data the loader generates.
+
+#ifndef _DB_APPLICATIONS_TPCC_RECORDS_H_
+#define _DB_APPLICATIONS_TPCC_RECORDS_H_
+
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "common/types.h"
+
+using std::string;
+
+// Size of the fields holding keys, with their terminating NUL.
+#define TPCC_KEY_SIZE 32
+
+struct Warehouse {
+  char id[TPCC_KEY_SIZE];
+  char name[11];
+  char street_1[21];
+  char street_2[21];
+  char city[21];
+  char state[3];
+  char zip[10];
+  double tax;
+  double year_to_date;
+};
+
+struct District {
+  char id[TPCC_KEY_SIZE];
+  char warehouse_id[TPCC_KEY_SIZE];
+  char name[11];
+  char street_1[21];
+  char street_2[21];
+  char city[21];
+  char state[3];
+  char zip[10];
+  double tax;
+  double year_to_date;
+  int32 next_order_id;
+};
+
+struct Customer {
+  char id[TPCC_KEY_SIZE];
+  char district_id[TPCC_KEY_SIZE];
+  char warehouse_id[TPCC_KEY_SIZE];
+  char first[21];
+  char middle[21];
+  char last[TPCC_KEY_SIZE];
+  char street_1[21];
+  char street_2[21];
+  char city[21];
+  char state[3];
+  char zip[10];
+  char credit[3];
+  int32 since;
+  double credit_limit;
+  double discount;
+  double balance;
+  double year_to_date_payment;
+  int32 payment_count;
+  int32 delivery_count;
+  char data[51];
+};
+
+struct NewOrder {
+  char id[TPCC_KEY_SIZE];
+  char district_id[TPCC_KEY_SIZE];
+  char warehouse_id[TPCC_KEY_SIZE];
+};
+
+struct Order {
+  char id[TPCC_KEY_SIZE];
+  char district_id[TPCC_KEY_SIZE];
+  char warehouse_id[TPCC_KEY_SIZE];
+  char customer_id[TPCC_KEY_SIZE];
+  double entry_date;
+  int32 carrier_id;
+  int32 order_line_count;
+  bool all_items_local;
+};
+
+struct OrderLine {
+  char order_id[TPCC_KEY_SIZE];
+  char district_id[TPCC_KEY_SIZE];
+  char warehouse_id[TPCC_KEY_SIZE];
+  char item_id[TPCC_KEY_SIZE];
+  char supply_warehouse_id[TPCC_KEY_SIZE];
+  int32 number;
+  int32 quantity;
+  double delivery_date;
+  double amount;
+  char district_information[25];
+};
+
+struct Item {
+  char id[TPCC_KEY_SIZE];
+  char name[25];
+  double price;
+  char data[51];
+};
+
+// TPC-C's S_DIST_xx fields are left out: nothing reads them, and they would
+// more than double the size of the largest table.
+struct Stock {
+  char id[TPCC_KEY_SIZE];
+  char item_id[TPCC_KEY_SIZE];
+  char warehouse_id[TPCC_KEY_SIZE];
+  int32 quantity;
+  int32 year_to_date;
+  int32 order_count;
+  int32 remote_count;
+  char data[51];
+};
+
+struct History {
+  char customer_id[TPCC_KEY_SIZE];
+  char district_id[TPCC_KEY_SIZE];
+  char warehouse_id[TPCC_KEY_SIZE];
+  char customer_district_id[TPCC_KEY_SIZE];
+  char customer_warehouse_id[TPCC_KEY_SIZE];
+  double date;
+  double amount;
+  char data[25];
+};
+
+// Secondary index of a customer's orders, stored under the customer's key
+// followed by "lo". It names the customer's latest order.
+struct LatestOrder {
+  char order_id[TPCC_KEY_SIZE];
+  int32 order_line_count;
+};
+
+// Secondary index of a district's undelivered new orders, stored under the
+// district's key followed by "on". The new orders numbered from
+// 'order_number' on have not been delivered.
+struct OldestNewOrder {
+  int32 order_number;
+};
+
+// Returns the record of type 'Record' that 'value' holds.
+template <typename Record>
+inline Record* RecordIn(Value* value) {
+  assert(value->size() == sizeof(Record));
+  return reinterpret_cast<Record*>(&(*value)[0]);
+}
+
+template <typename Record>
+inline const Record* RecordIn(const Value* value) {
+  assert(value->size() == sizeof(Record));
+  return reinterpret_cast<const Record*>(value->data());
+}
+
+// Returns a new value holding a zeroed record of type 'Record', and sets
+// '*record' to the record.
+template <typename Record>
+inline Value* NewRecord(Record** record) {
+  Value* value = new Value(sizeof(Record), '\0');
+  *record = RecordIn<Record>(value);
+  return value;
+}
+
+// Sets the string field 'field' to 'from', cut to the size of the field.
+template <size_t N>
+inline void SetField(char (&field)[N], const char* from) {
+  size_t length = strnlen(from, N - 1);
+  memcpy(field, from, length);
+  field[length] = '\0';
+}
+
+template <size_t N>
+inline void SetField(char (&field)[N], const string& from) {
+  SetField(field, from.c_str());
+}
+
+#endif  // _DB_APPLICATIONS_TPCC_RECORDS_H_
@@ -0,0 +1,55 @@
+// On-disk format of checkpoints.
+//
+// A checkpoint of the database as of txn 'stable' is split into 'parts' files
+// named <dir>/<stable>.checkpoint.<part>, written and readable in parallel.
+// Each file holds
+//
+//   CheckpointHeader
+//   records: <key_length:uint32> <value_length:uint32> <key> <value>
+//   CheckpointTrailer
+//
+// The trailer's CRC-32 covers the header and all records. Files are written
+// under a temporary name and renamed once complete, so a file with the final
+// name is never partial.
+
+#ifndef _DB_BACKEND_CHECKPOINT_H_
+#define _DB_BACKEND_CHECKPOINT_H_
+
+#include <cstdio>
+#include <string>
+
+#include "common/types.h"
+
+using std::string;
+
+#define CHECKPOINT_MAGIC "CALVINCP"
+#define CHECKPOINT_VERSION 1
+
+// Marks the end of the records; no key is this long.
+#define CHECKPOINT_END_OF_RECORDS 0xFFFFFFFF
+
+struct CheckpointHeader {
+  char magic[8];
+  uint32 version;
+  uint32 part;
+  uint32 parts;
+  uint32 reserved;
+  int64 stable;
+};
+
+struct CheckpointTrailer {
+  uint32 end_of_records;
+  uint32 crc;
+  int64 records;
+};
+
+// Returns the name of file 'part' of the checkpoint as of txn 'stable'.
+static inline string CheckpointPath(const string& dir, int64 stable,
+                                    int part) {
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%ld.checkpoint.%d", dir.c_str(),
+           static_cast<long>(stable), part);
+  return string(path);
+}
+
+#endif  // _DB_BACKEND_CHECKPOINT_H_
@@ -0,0 +1,192 @@
+// Parallel, memory-mapped checkpoint restore.
+
+#include "backend/checkpoint_loader.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "backend/checkpoint.h"
+#include "backend/storage.h"
+#include "common/utils.h"
+
+using std::vector;
+
+namespace {
+
+// One memory-mapped part file and the result of loading it.
+struct MappedPart {
+  string path;
+  const char* data;
+  size_t size;
+  int64 records;
+  Storage* storage;
+  bool ok;
+};
+
+// Maps the file at 'path' and checks its header against 'stable' and 'part'
+// and that it ends in a trailer. Fills in 'mapped' on success.
+bool MapPart(const string& path, int64 stable, int part, MappedPart* mapped) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    perror(("Cannot open checkpoint " + path).c_str());
+    return false;
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 ||
+      status.st_size < static_cast<off_t>(sizeof(CheckpointHeader) +
+                                          sizeof(CheckpointTrailer))) {
+    fprintf(stderr, "Checkpoint %s is truncated\n", path.c_str());
+    close(fd);
+    return false;
+  }
+  void* data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    perror(("Cannot map checkpoint " + path).c_str());
+    return false;
+  }
+  madvise(data, status.st_size, MADV_SEQUENTIAL);
+  madvise(data, status.st_size, MADV_WILLNEED);
+
+  mapped->path = path;
+  mapped->data = reinterpret_cast<const char*>(data);
+  mapped->size = status.st_size;
+  mapped->ok = false;
+
+  CheckpointHeader header;
+  CheckpointTrailer trailer;
+  memcpy(&header, mapped->data, sizeof(header));
+  memcpy(&trailer, mapped->data + mapped->size - sizeof(trailer),
+         sizeof(trailer));
+  if (memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != CHECKPOINT_VERSION || header.stable != stable ||
+      header.part != static_cast<uint32>(part) ||
+      trailer.end_of_records != CHECKPOINT_END_OF_RECORDS) {
+    fprintf(stderr, "Checkpoint %s is not part %d as of txn %ld\n",
+            path.c_str(), part, static_cast<long>(stable));
+    munmap(data, mapped->size);
+    return false;
+  }
+  mapped->records = trailer.records;
+  return true;
+}
+
+// Verifies the checksum of a mapped part and stores its objects.
+void* LoadPart(void* arg) {
+  MappedPart* mapped = reinterpret_cast<MappedPart*>(arg);
+  const char* end = mapped->data + mapped->size - sizeof(CheckpointTrailer);
+
+  CheckpointTrailer trailer;
+  memcpy(&trailer, end, sizeof(trailer));
+  if (Crc32(0, mapped->data, end - mapped->data) != trailer.crc) {
+    fprintf(stderr, "Checkpoint %s is corrupt\n", mapped->path.c_str());
+    return NULL;
+  }
+
+  // Each value is allocated on its own: the storage owns it and may free it
+  // when the object is replaced or deleted.
+  const char* p = mapped->data + sizeof(CheckpointHeader);
+  int64 i;
+  for (i = 0; i < mapped->records && p + 8 <= end; i++) {
+    uint32 lengths[2];
+    memcpy(lengths, p, sizeof(lengths));
+    p += sizeof(lengths);
+    if (lengths[0] > static_cast<size_t>(end - p) ||
+        lengths[1] > static_cast<size_t>(end - p) - lengths[0])
+      break;
+    mapped->storage->PutObject(Key(p, lengths[0]),
+                               new Value(p + lengths[0], lengths[1]));
+    p += lengths[0] + lengths[1];
+  }
+  mapped->ok = (i == mapped->records && p == end);
+  if (!mapped->ok)
+    fprintf(stderr, "Checkpoint %s is malformed\n", mapped->path.c_str());
+  return NULL;
+}
+
+}  // namespace
+
+int64 CheckpointLoader::FindLatest() {
+  DIR* dir = opendir(dir_.c_str());
+  if (dir == NULL)
+    return -1;
+
+  int64 latest = -1;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    long stable;
+    int part, length;
+    if (sscanf(entry->d_name, "%ld.checkpoint.%d%n", &stable, &part,
+               &length) != 2 ||
+        part != 0 || entry->d_name[length] != '\0' || stable <= latest)
+      continue;
+
+    // Only complete checkpoints count: part 0 names the number of parts.
+    FILE* file = fopen(CheckpointPath(dir_, stable, 0).c_str(), "r");
+    CheckpointHeader header;
+    bool complete =
+        file != NULL && fread(&header, sizeof(header), 1, file) == 1;
+    if (file != NULL)
+      fclose(file);
+    for (uint32 i = 1; complete && i < header.parts; i++)
+      complete = access(CheckpointPath(dir_, stable, i).c_str(), R_OK) == 0;
+    if (complete)
+      latest = stable;
+  }
+  closedir(dir);
+  return latest;
+}
+
+bool CheckpointLoader::Load(int64 stable, Storage* storage) {
+  objects_ = 0;
+  bytes_ = 0;
+
+  // Part 0 says how many parts there are.
+  vector<MappedPart> parts(1);
+  if (!MapPart(CheckpointPath(dir_, stable, 0), stable, 0, &parts[0]))
+    return false;
+  CheckpointHeader header;
+  memcpy(&header, parts[0].data, sizeof(header));
+  bool ok = header.parts > 0;
+  parts.resize(ok ? header.parts : 1);
+
+  int mapped = 1;
+  while (ok && mapped < static_cast<int>(parts.size())) {
+    ok = MapPart(CheckpointPath(dir_, stable, mapped), stable, mapped,
+                 &parts[mapped]);
+    if (ok)
+      mapped++;
+  }
+
+  if (ok) {
+    int64 records = 0;
+    for (size_t i = 0; i < parts.size(); i++)
+      records += parts[i].records;
+    storage->Reserve(records);
+
+    vector<pthread_t> threads(parts.size());
+    for (size_t i = 0; i < parts.size(); i++) {
+      parts[i].storage = storage;
+      pthread_create(&threads[i], NULL, &LoadPart, &parts[i]);
+    }
+    for (size_t i = 0; i < parts.size(); i++) {
+      pthread_join(threads[i], NULL);
+      ok = ok && parts[i].ok;
+      objects_ += parts[i].records;
+      bytes_ += parts[i].size;
+    }
+  }
+
+  for (int i = 0; i < mapped; i++)
+    munmap(const_cast<char*>(parts[i].data), parts[i].size);
+  return ok;
+}
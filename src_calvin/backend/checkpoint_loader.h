@@ -0,0 +1,42 @@
+// Restores a checkpoint written by CollapsedVersionedStorage (see
+// backend/checkpoint.h) into any storage, instead of building the database
+// from scratch. Every part file is memory-mapped and loaded by its own thread,
+// and the storage's tables are sized for all objects up front, so loading
+// does no per-object allocation beyond each value and what the storage itself
+// needs for its index.
+
+#ifndef _DB_BACKEND_CHECKPOINT_LOADER_H_
+#define _DB_BACKEND_CHECKPOINT_LOADER_H_
+
+#include <string>
+
+#include "common/types.h"
+
+using std::string;
+
+class Storage;
+
+class CheckpointLoader {
+ public:
+  explicit CheckpointLoader(const string& dir) : dir_(dir) {}
+
+  // Returns the stable txn id of the newest checkpoint in the directory all of
+  // whose parts are present, or -1 if there is none.
+  int64 FindLatest();
+
+  // Loads the checkpoint as of txn 'stable' into 'storage'. Returns false,
+  // after printing why, if a part is missing or fails validation; 'storage'
+  // may then hold part of the checkpoint.
+  bool Load(int64 stable, Storage* storage);
+
+  // Number of objects and bytes loaded by the last Load().
+  int64 objects() const { return objects_; }
+  int64 bytes() const { return bytes_; }
+
+ private:
+  string dir_;
+  int64 objects_;
+  int64 bytes_;
+};
+
+#endif  // _DB_BACKEND_CHECKPOINT_LOADER_H_
@@ -4,108 +4,161 @@
 
 #include "backend/collapsed_versioned_storage.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <cstdio>
 #include <cstdlib>
-#include <string>
+#include <cstring>
+#include <utility>
+
+#include "backend/checkpoint.h"
+#include "common/utils.h"
+
+using std::pair;
+
+namespace {
+
+// Arguments and results of one checkpoint writer thread.
+struct CheckpointPart {
+  CollapsedVersionedStorage* storage;
+  int part;
+  int64 objects;
+  int64 bytes;
+  bool ok;
+};
+
+// Writes 'data' to 'fd' in full. Returns false on error.
+bool WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = write(fd, data, size);
+    if (n < 0)
+      return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
 
-using std::string;
+}  // namespace
 
-#define TPCCHACK
+CollapsedVersionedStorage::CollapsedVersionedStorage(
+    const string& checkpoint_dir)
+    : checkpoint_dir_(checkpoint_dir), stable_(0), snapshot_(false),
+      capturing_(false) {
+  for (int i = 0; i < CHECKPOINT_SHARDS; i++)
+    pthread_mutex_init(&shards_[i].mutex, NULL);
+}
 
-#ifdef TPCCHACK
-#define MAXARRAYSIZE 1000000
-// For inserted objects we need to make a representation that is thread-safe
-// (i.e. an array).  This is kind of hacky, but since this only corresponds
-// to TPCC, we'll be okay
-Value* NewOrderStore[MAXARRAYSIZE];
-Value* OrderStore[MAXARRAYSIZE];
-Value* OrderLineStore[MAXARRAYSIZE * 15];
-Value* HistoryStore[MAXARRAYSIZE];
-#endif
+CollapsedVersionedStorage::~CollapsedVersionedStorage() {
+  while (capturing_)
+    Spin(0.001);
+  for (int i = 0; i < CHECKPOINT_SHARDS; i++) {
+    unordered_map<Key, DataNode*>::iterator it;
+    for (it = shards_[i].objects.begin(); it != shards_[i].objects.end();
+         ++it) {
+      while (it->second != NULL) {
+        DataNode* next = it->second->next;
+        delete it->second->value;
+        delete it->second;
+        it->second = next;
+      }
+    }
+    pthread_mutex_destroy(&shards_[i].mutex);
+  }
+}
 
 Value* CollapsedVersionedStorage::ReadObject(const Key& key, int64 txn_id) {
-#ifdef TPCCHACK
-  if (key.find("ol") != string::npos) {
-    return OrderLineStore[txn_id * 15 + atoi(&key[key.find("line(") + 5])];
-  } else if (key.find("no") != string::npos) {
-    return NewOrderStore[txn_id];
-  } else if (key.find("o") != string::npos) {
-    return OrderStore[txn_id];
-  } else if (key.find("h") != string::npos) {
-    return HistoryStore[txn_id];
-  } else {
-#endif
-
-    // Check to see if a match even exists
-    if (objects_.count(key) != 0) {
-      for (DataNode* list = objects_[key]; list; list = list->next) {
-        if (list->txn_id <= txn_id) {
-          return list->value;
-        }
-      }
+  Shard* shard = ShardOf(key);
+  Value* result = NULL;
+  pthread_mutex_lock(&shard->mutex);
+
+  // Check to see if a match even exists
+  unordered_map<Key, DataNode*>::iterator it = shard->objects.find(key);
+  if (it != shard->objects.end() && it->second != NULL) {
+    DataNode* head = it->second;
+
+    // First access after the checkpoint's stable txn: copy the stable
+    // version, which the reader may update in place.
+    if (snapshot_ && txn_id > stable_ && head->txn_id <= stable_ &&
+        head->value != NULL) {
+      DataNode* item = new DataNode();
+      item->txn_id = stable_ + 1;
+      item->value = new Value(*head->value);
+      item->next = head;
+      it->second = head = item;
     }
 
-#ifdef TPCCHACK
+    for (DataNode* list = head; list; list = list->next) {
+      if (list->txn_id <= txn_id) {
+        result = list->value;
+        break;
+      }
+    }
   }
-#endif
 
-  // No match found
-  return NULL;
+  pthread_mutex_unlock(&shard->mutex);
+  return result;
+}
+
+bool CollapsedVersionedStorage::CopyObject(const Key& key, Value* value) {
+  Shard* shard = ShardOf(key);
+  pthread_mutex_lock(&shard->mutex);
+  unordered_map<Key, DataNode*>::const_iterator it = shard->objects.find(key);
+  bool found = it != shard->objects.end() && it->second != NULL &&
+               it->second->value != NULL;
+  if (found)
+    *value = *it->second->value;
+  pthread_mutex_unlock(&shard->mutex);
+  return found;
 }
 
 bool CollapsedVersionedStorage::PutObject(const Key& key,
                                           Value* value,
                                           int64 txn_id) {
-#ifdef TPCCHACK
-  if (key.find("ol") != string::npos) {
-    OrderLineStore[txn_id * 15 + atoi(&key[key.find("line(") + 5])] = value;
-  } else if (key.find("no") != string::npos) {
-    NewOrderStore[txn_id] = value;
-  } else if (key.find("o") != string::npos) {
-    OrderStore[txn_id] = value;
-  } else if (key.find("h") != string::npos) {
-    HistoryStore[txn_id] = value;
-  } else {
-#endif
-
-    // Create the new version to insert into the list
-    DataNode* item = new DataNode();
-    item->txn_id = txn_id;
-    item->value = value;
-    item->next = NULL;
-
-    // Is the most recent value a candidate for pruning?
-    DataNode* current;
-    if (objects_.count(key) != 0 && (current = objects_[key]) != NULL) {
-      int64 most_recent = current->txn_id;
-
-      if ((most_recent > stable_ && txn_id > stable_) ||
-          (most_recent <= stable_ && txn_id <= stable_)) {
-        item->next = current->next;
-        delete current;
-      } else {
-        item->next = current;
-      }
+  // Create the new version to insert into the list
+  DataNode* item = new DataNode();
+  item->txn_id = txn_id;
+  item->value = value;
+  item->next = NULL;
+
+  Shard* shard = ShardOf(key);
+  pthread_mutex_lock(&shard->mutex);
+
+  // Is the most recent value a candidate for pruning? Without a pending
+  // checkpoint only the latest version is kept.
+  DataNode*& current = shard->objects[key];
+  if (current != NULL) {
+    int64 most_recent = current->txn_id;
+
+    if (!snapshot_ ||
+        (most_recent > stable_ && txn_id > stable_) ||
+        (most_recent <= stable_ && txn_id <= stable_)) {
+      item->next = current->next;
+      if (current->value != value)
+        delete current->value;
+      delete current;
+    } else {
+      item->next = current;
     }
-    objects_[key] = item;
-
-#ifdef TPCCHACK
   }
-#endif
+  current = item;
 
+  pthread_mutex_unlock(&shard->mutex);
   return true;
 }
 
 bool CollapsedVersionedStorage::DeleteObject(const Key& key, int64 txn_id) {
-#ifdef TPCCHACK
-  if (key.find("o") != string::npos || key.find("h") != string::npos)
-    return false;
-#endif
+  Shard* shard = ShardOf(key);
+  pthread_mutex_lock(&shard->mutex);
 
-  DataNode* list = (objects_.count(key) == 0 ? NULL : objects_[key]);
+  unordered_map<Key, DataNode*>::iterator it = shard->objects.find(key);
+  DataNode* list = (it == shard->objects.end() ? NULL : it->second);
 
+  // Without a pending checkpoint there is only the latest version.
   while (list != NULL) {
-    if ((list->txn_id > stable_ && txn_id > stable_) ||
+    if (!snapshot_ ||
+        (list->txn_id > stable_ && txn_id > stable_) ||
         (list->txn_id <= stable_ && txn_id <= stable_))
       break;
 
@@ -113,106 +166,219 @@ bool CollapsedVersionedStorage::DeleteObject(const Key& key, int64 txn_id) {
   }
 
   // First we need to insert an empty string when there is >1 item
-  if (list != NULL && objects_[key] == list && list->next != NULL) {
-    objects_[key]->txn_id = txn_id;
-    objects_[key]->value = NULL;
+  if (list != NULL && it->second == list && list->next != NULL) {
+    delete it->second->value;
+    it->second->txn_id = txn_id;
+    it->second->value = NULL;
 
     // Otherwise we need to free the head
-  } else if (list != NULL && objects_[key] == list) {
-    delete objects_[key];
-    objects_[key] = NULL;
+  } else if (list != NULL && it->second == list) {
+    delete it->second->value;
+    delete it->second;
+    it->second = NULL;
 
     // Lastly, we may only want to free the tail
   } else if (list != NULL) {
+    delete list->value;
     delete list;
-    objects_[key]->next = NULL;
+    it->second->next = NULL;
+
+    // Only the version kept for the checkpoint exists. Hide it from later txns
+    // behind an empty one.
+  } else if (it != shard->objects.end() && it->second != NULL &&
+             txn_id > stable_) {
+    DataNode* item = new DataNode();
+    item->txn_id = txn_id;
+    item->value = NULL;
+    item->next = it->second;
+    it->second = item;
   }
 
+  pthread_mutex_unlock(&shard->mutex);
   return true;
 }
 
+bool CollapsedVersionedStorage::ListKeys(vector<Key>* keys) {
+  for (int i = 0; i < CHECKPOINT_SHARDS; i++) {
+    pthread_mutex_lock(&shards_[i].mutex);
+    unordered_map<Key, DataNode*>::const_iterator it;
+    for (it = shards_[i].objects.begin(); it != shards_[i].objects.end();
+         ++it) {
+      if (it->second != NULL && it->second->value != NULL)
+        keys->push_back(it->first);
+    }
+    pthread_mutex_unlock(&shards_[i].mutex);
+  }
+  return true;
+}
+
+void CollapsedVersionedStorage::Reserve(int64 objects) {
+  for (int i = 0; i < CHECKPOINT_SHARDS; i++) {
+    pthread_mutex_lock(&shards_[i].mutex);
+    shards_[i].objects.rehash(shards_[i].objects.size() +
+                              objects / CHECKPOINT_SHARDS + 1);
+    pthread_mutex_unlock(&shards_[i].mutex);
+  }
+}
+
+void CollapsedVersionedStorage::PrepareForCheckpoint(int64 stable) {
+  stable_ = stable;
+  snapshot_ = true;
+}
+
 int CollapsedVersionedStorage::Checkpoint() {
+  if (capturing_)
+    return -1;
+  capturing_ = true;
+
   pthread_t checkpointing_daemon;
   int thread_status =
       pthread_create(&checkpointing_daemon, NULL, &RunCheckpointer, this);
+  if (thread_status == 0)
+    pthread_detach(checkpointing_daemon);
+  else
+    capturing_ = false;
 
   return thread_status;
 }
 
+void* CollapsedVersionedStorage::RunCheckpointPart(void* arg) {
+  CheckpointPart* part = reinterpret_cast<CheckpointPart*>(arg);
+  part->ok = part->storage->WriteCheckpointPart(part->part, &part->objects,
+                                                &part->bytes);
+  return NULL;
+}
+
 void CollapsedVersionedStorage::CaptureCheckpoint() {
-  // Give the user output
-  fprintf(stdout, "Beginning checkpoint capture...\n");
-
-  // First, we open the file for writing
-  char log_name[200];
-  snprintf(log_name, sizeof(log_name), "%s/%ld.checkpoint", CHKPNTDIR, stable_);
-  FILE* checkpoint = fopen(log_name, "w");
-
-  // Next we iterate through all of the objects and write the stable version
-  // to disk
-  unordered_map<Key, DataNode*>::iterator it;
-  for (it = objects_.begin(); it != objects_.end(); it++) {
-    // Read in the stable value
-    Key key = it->first;
-    Value* result = ReadObject(key, stable_);
-
-    // Write <len_key_bytes|key|len_value_bytes|value> to disk
-    int key_length = key.length();
-    int val_length = result->length();
-    fprintf(
-        checkpoint, "%c%c%c%c%s%c%c%c%c%s", static_cast<char>(key_length >> 24),
-        static_cast<char>(key_length >> 16), static_cast<char>(key_length >> 8),
-        static_cast<char>(key_length), key.c_str(),
-        static_cast<char>(val_length >> 24),
-        static_cast<char>(val_length >> 16), static_cast<char>(val_length >> 8),
-        static_cast<char>(val_length), result->c_str());
-
-    // Remove object from tree if there's an old version
-    if (it->second->next != NULL)
-      DeleteObject(key, stable_);
+  double start = GetTime();
+
+  // Every thread writes its own file from its own set of shards.
+  pthread_t threads[CHECKPOINT_THREADS];
+  CheckpointPart parts[CHECKPOINT_THREADS];
+  for (int i = 0; i < CHECKPOINT_THREADS; i++) {
+    CheckpointPart part = {this, i, 0, 0, false};
+    parts[i] = part;
+    pthread_create(&threads[i], NULL, &RunCheckpointPart, &parts[i]);
   }
 
-#ifdef TPCCHACK
-  fprintf(checkpoint, "\nNewOrder\n");
-  for (int64 i = 0; i < MAXARRAYSIZE; i++) {
-    if (NewOrderStore[i] != NULL) {
-      fprintf(checkpoint, "%ld%s",
-              static_cast<int64>((*NewOrderStore[i]).length()),
-              (*NewOrderStore[i]).c_str());
-    }
+  int64 objects = 0;
+  int64 bytes = 0;
+  bool ok = true;
+  for (int i = 0; i < CHECKPOINT_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+    objects += parts[i].objects;
+    bytes += parts[i].bytes;
+    ok = ok && parts[i].ok;
   }
 
-  fprintf(checkpoint, "\nOrder\n");
-  for (int64 i = 0; i < MAXARRAYSIZE; i++) {
-    if (OrderStore[i] != NULL) {
-      fprintf(checkpoint, "%ld%s",
-              static_cast<int64>((*OrderStore[i]).length()),
-              (*OrderStore[i]).c_str());
-    }
+  PruneStableVersions();
+  snapshot_ = false;
+
+  double elapsed = GetTime() - start;
+  if (ok) {
+    printf("Checkpoint as of txn %ld: %ld objects, %.1f MB in %.3f s "
+           "(%.1f MB/s, %d threads)\n", static_cast<long>(stable_),
+           static_cast<long>(objects), bytes / 1048576.0, elapsed,
+           elapsed > 0 ? bytes / 1048576.0 / elapsed : 0, CHECKPOINT_THREADS);
+  } else {
+    printf("Checkpoint as of txn %ld failed\n", static_cast<long>(stable_));
   }
+  fflush(stdout);
+  capturing_ = false;
+}
 
-  fprintf(checkpoint, "\nOrderLine\n");
-  for (int64 i = 0; i < MAXARRAYSIZE * 15; i++) {
-    if (OrderLineStore[i] != NULL) {
-      fprintf(checkpoint, "%ld%s",
-              static_cast<int64>((*OrderLineStore[i]).length()),
-              (*OrderLineStore[i]).c_str());
-    }
+bool CollapsedVersionedStorage::WriteCheckpointPart(int part, int64* objects,
+                                                    int64* bytes) {
+  string path = CheckpointPath(checkpoint_dir_, stable_, part);
+  string temp_path = path + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    perror(("Cannot create checkpoint " + temp_path).c_str());
+    return false;
   }
 
-  fprintf(checkpoint, "\nHistory\n");
-  for (int64 i = 0; i < MAXARRAYSIZE; i++) {
-    if (HistoryStore[i] != NULL) {
-      fprintf(checkpoint, "%ld%s",
-              static_cast<int64>((*HistoryStore[i]).length()),
-              (*HistoryStore[i]).c_str());
+  string buffer;
+  buffer.reserve(CHECKPOINT_BUFFER_SIZE + 4096);
+  uint32 crc = 0;
+  bool ok = true;
+
+  CheckpointHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+  header.version = CHECKPOINT_VERSION;
+  header.part = part;
+  header.parts = CHECKPOINT_THREADS;
+  header.stable = stable_;
+  buffer.append(reinterpret_cast<char*>(&header), sizeof(header));
+
+  // The stable versions are no longer written by anyone (later txns work on
+  // copies) and are not freed before PruneStableVersions(), so only finding
+  // them needs the shard lock.
+  vector<pair<Key, Value*> > stable_objects;
+  for (int i = part; i < CHECKPOINT_SHARDS && ok; i += CHECKPOINT_THREADS) {
+    Shard* shard = &shards_[i];
+    stable_objects.clear();
+    pthread_mutex_lock(&shard->mutex);
+    unordered_map<Key, DataNode*>::const_iterator it;
+    for (it = shard->objects.begin(); it != shard->objects.end(); ++it) {
+      DataNode* list = it->second;
+      while (list != NULL && list->txn_id > stable_)
+        list = list->next;
+      if (list != NULL && list->value != NULL)
+        stable_objects.push_back(std::make_pair(it->first, list->value));
+    }
+    pthread_mutex_unlock(&shard->mutex);
+
+    for (size_t j = 0; j < stable_objects.size() && ok; j++) {
+      const Key& key = stable_objects[j].first;
+      const Value& value = *stable_objects[j].second;
+      uint32 lengths[2] = {static_cast<uint32>(key.size()),
+                           static_cast<uint32>(value.size())};
+      buffer.append(reinterpret_cast<char*>(lengths), sizeof(lengths));
+      buffer.append(key);
+      buffer.append(value);
+      (*objects)++;
+
+      // One large sequential write at a time.
+      if (buffer.size() >= CHECKPOINT_BUFFER_SIZE) {
+        crc = Crc32(crc, buffer.data(), buffer.size());
+        ok = WriteAll(fd, buffer.data(), buffer.size());
+        *bytes += buffer.size();
+        buffer.clear();
+      }
     }
   }
-#endif
 
-  // Close the file
-  fclose(checkpoint);
+  crc = Crc32(crc, buffer.data(), buffer.size());
+  CheckpointTrailer trailer = {CHECKPOINT_END_OF_RECORDS, crc, *objects};
+  buffer.append(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+  ok = ok && WriteAll(fd, buffer.data(), buffer.size());
+  *bytes += buffer.size();
+
+  ok = ok && fdatasync(fd) == 0;
+  close(fd);
+  ok = ok && rename(temp_path.c_str(), path.c_str()) == 0;
+  if (!ok)
+    perror(("Cannot write checkpoint " + path).c_str());
+  return ok;
+}
 
-  // Give the user output
-  fprintf(stdout, "Finished checkpointing\n");
+void CollapsedVersionedStorage::PruneStableVersions() {
+  for (int i = 0; i < CHECKPOINT_SHARDS; i++) {
+    pthread_mutex_lock(&shards_[i].mutex);
+    unordered_map<Key, DataNode*>::iterator it;
+    for (it = shards_[i].objects.begin(); it != shards_[i].objects.end();
+         ++it) {
+      DataNode* head = it->second;
+      if (head == NULL)
+        continue;
+      while (head->next != NULL) {
+        DataNode* next = head->next->next;
+        delete head->next->value;
+        delete head->next;
+        head->next = next;
+      }
+    }
+    pthread_mutex_unlock(&shards_[i].mutex);
+  }
 }
@@ -6,14 +6,18 @@
 #ifndef _DB_BACKEND_COLLAPSED_VERSIONED_STORAGE_H_
 #define _DB_BACKEND_COLLAPSED_VERSIONED_STORAGE_H_
 
+#include <pthread.h>
+
 #include <climits>
-#include <cstring>
+#include <string>
 #include <tr1/unordered_map>
 
 #include "backend/versioned_storage.h"
+#include "common/definitions.hh"
 
 #define CHKPNTDIR "../db/checkpoints"
 
+using std::string;
 using std::tr1::unordered_map;
 
 struct DataNode {
@@ -24,17 +28,9 @@ struct DataNode {
 
 class CollapsedVersionedStorage : public VersionedStorage {
  public:
-  CollapsedVersionedStorage() {
-    stable_ = 0;
-
-#ifdef TPCCHACK
-    memset(&NewOrderStore, 0, sizeof(NewOrderStore));
-    memset(&OrderStore, 0, sizeof(OrderStore));
-    memset(&OrderLineStore, 0, sizeof(OrderLineStore));
-    memset(&HistoryStore, 0, sizeof(HistoryStore));
-#endif
-  }
-  virtual ~CollapsedVersionedStorage() {}
+  // Checkpoints are written to 'checkpoint_dir' (see backend/checkpoint.h).
+  explicit CollapsedVersionedStorage(const string& checkpoint_dir = CHKPNTDIR);
+  virtual ~CollapsedVersionedStorage();
 
   // TODO(Thad and Philip): How can we incorporate this type of versioned
   // storage into the work that you've been doing with prefetching?  It seems
@@ -43,8 +39,11 @@ class CollapsedVersionedStorage : public VersionedStorage {
 
   // Standard operators in the DB
   virtual Value* ReadObject(const Key& key, int64 txn_id = LLONG_MAX);
+  virtual bool CopyObject(const Key& key, Value* value);
   virtual bool PutObject(const Key& key, Value* value, int64 txn_id);
   virtual bool DeleteObject(const Key& key, int64 txn_id);
+  virtual bool ListKeys(vector<Key>* keys);
+  virtual void Reserve(int64 objects);
 
   // Specify the overloaded parent functions we are using here
   using VersionedStorage::Prefetch;
@@ -54,23 +53,66 @@ class CollapsedVersionedStorage : public VersionedStorage {
   // previously stable values are no longer necessary.  At this point in time,
   // the database can switch the labels as to what is stable (the previously
   // frozen values) to a new txn_id occurring in the future.
-  virtual void PrepareForCheckpoint(int64 stable) { stable_ = stable; }
+  //
+  // From then on until the checkpoint has been captured, the version as of
+  // 'stable' of every object is preserved: the first txn after 'stable' to
+  // touch an object gets a copy of it to update (reads included, since txns
+  // update the values they read in place). Must be called before any txn
+  // after 'stable' runs.
+  virtual void PrepareForCheckpoint(int64 stable);
+
+  // Starts capturing the checkpoint in the background. Must be called once
+  // every txn up to 'stable' has completed; execution of later txns goes on
+  // meanwhile. Returns 0 on success.
   virtual int Checkpoint();
 
+  // True from PrepareForCheckpoint() until the checkpoint is on disk.
+  virtual bool Checkpointing() { return snapshot_; }
+
   // The capture checkpoint method is an internal method that allows us to
   // write out the stable checkpoint to disk.
   virtual void CaptureCheckpoint();
 
  private:
-  // We make a simple mapping of keys to a map of "versions" of our value.
-  // The int64 represents a simple transaction id and the Value associated with
-  // it is whatever value was written out at that time.
-  unordered_map<Key, DataNode*> objects_;
+  // Objects are spread over independently locked shards, so that workers and
+  // checkpoint threads only contend on the same shard.
+  struct Shard {
+    // We make a simple mapping of keys to a map of "versions" of our value.
+    // The int64 represents a simple transaction id and the Value associated
+    // with it is whatever value was written out at that time.
+    unordered_map<Key, DataNode*> objects;
+    pthread_mutex_t mutex;
+  };
+
+  Shard* ShardOf(const Key& key) {
+    return &shards_[hash_(key) % CHECKPOINT_SHARDS];
+  }
+
+  // Writes the stable version of every object in shards 'part',
+  // 'part' + CHECKPOINT_THREADS, ... to file 'part' of the checkpoint. Adds the
+  // number of objects and bytes written to '*objects' and '*bytes'. Returns
+  // false if the file could not be written.
+  bool WriteCheckpointPart(int part, int64* objects, int64* bytes);
+
+  // Drops the versions that were only kept for the checkpoint.
+  void PruneStableVersions();
+
+  static void* RunCheckpointPart(void* arg);
+
+  Shard shards_[CHECKPOINT_SHARDS];
+  std::tr1::hash<Key> hash_;
+
+  string checkpoint_dir_;
 
   // The stable and frozen int64 represent which transaction ID's are stable
   // to write out to storage, and which should be the latest to be overwritten
   // in the current database execution cycle, respectively.
-  int64 stable_;
+  volatile int64 stable_;
+
+  // True while the versions as of 'stable_' are preserved for a checkpoint,
+  // and while it is being captured, respectively.
+  volatile bool snapshot_;
+  volatile bool capturing_;
 };
 
 static inline void* RunCheckpointer(void* storage) {
@@ -4,9 +4,25 @@
 // main memory, disk, and swapping algorithms.
 
 #include "backend/fetching_storage.h"
-#include "common/definitions.hh"
 
-typedef FetchingStorage::Latch Latch;
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Pages hold the value's length followed by its bytes.
+Value* ParsePage(const char* page) {
+  uint32 length;
+  memcpy(&length, page, sizeof(length));
+  return new Value(page + sizeof(length), length);
+}
+
+}  // namespace
 
 ////////////////// Constructors/Destructors  //////////////////////
 
@@ -14,269 +30,457 @@ typedef FetchingStorage::Latch Latch;
 
 FetchingStorage* FetchingStorage::self = NULL;
 
-FetchingStorage* FetchingStorage::BuildStorage() {
+FetchingStorage* FetchingStorage::BuildStorage(const string& page_io) {
   if (self == NULL)
-    self = new FetchingStorage();
+    self = new FetchingStorage(string(STORAGE_PATH) + "pages",
+                               BUFFER_POOL_FRAMES, page_io);
   return self;
 }
 
-// Private constructor
+FetchingStorage::FetchingStorage(const string& path, int frames,
+                                 const string& page_io)
+    : frames_(frames), clock_hand_(0), write_sequence_(0),
+      read_latency_(0.001), interval_start_(GetTime()), hits_(0), misses_(0),
+      evictions_(0), writes_(0), reads_(0), read_time_(0), stalls_(0), stall_time_(0), queued_since_(0),
+      in_flight_(0), stopped_(false) {
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    perror(("Cannot open data file " + path).c_str());
+    exit(EXIT_FAILURE);
+  }
+  page_io_ = PageIo::Create(page_io, fd_, PAGE_SIZE, BUFFER_POOL_IO_DEPTH);
+  if (page_io_ == NULL) {
+    fprintf(stderr, "Page I/O backend %s is not available, using aio\n",
+            page_io.c_str());
+    page_io_ = PageIo::Create("aio", fd_, PAGE_SIZE, BUFFER_POOL_IO_DEPTH);
+  }
 
-FetchingStorage::FetchingStorage() {
-  main_memory_ = new SimpleStorage();
-  // 1 MILLION LATCHES!
-  latches_ = new Latch[1000000];
+  for (int i = frames - 1; i >= 0; i--) {
+    Frame frame = {-1, NULL, FREE, 0, false, false};
+    frames_[i] = frame;
+    free_frames_.push_back(i);
+  }
+  page_table_.rehash(frames);
 
-  pthread_create(&gc_thread_, NULL, RunGCThread, reinterpret_cast<void*>(this));
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&loaded_, NULL);
+  pthread_create(&completion_thread_, NULL, RunCompletionThread, this);
 }
 
 FetchingStorage::~FetchingStorage() {
-  delete main_memory_;
-  delete[] latches_;
+  // The completion thread finishes all queued and in-flight requests first.
+  stopped_ = true;
+  pthread_join(completion_thread_, NULL);
+  delete page_io_;
+  close(fd_);
+
+  for (size_t i = 0; i < frames_.size(); i++)
+    delete frames_[i].value;
+  unordered_map<int64, PendingWrite>::iterator it;
+  for (it = pending_writes_.begin(); it != pending_writes_.end(); ++it)
+    delete[] it->second.page;
+
+  pthread_mutex_destroy(&mutex_);
+  pthread_cond_destroy(&loaded_);
 }
 
-////////////////// Private utility functions  //////////////////////
+////////////////// Buffer pool  //////////////////////
 
-Latch* FetchingStorage::LatchFor(const Key& key) {
-  // Just fail miserably if we are passed a non-int.
-  // assert(atoi(key.c_str()) != 0);
-  // An array is a nice threadsafe hashtable.
-  return latches_ + atoi(key.c_str());
+int64 FetchingStorage::PageOf(const Key& key) {
+  unordered_map<Key, int64>::iterator it = page_ids_.find(key);
+  if (it != page_ids_.end())
+    return it->second;
+  int64 id = page_ids_.size();
+  page_ids_[key] = id;
+  return id;
 }
 
-void FetchingStorage::GetKey(int fd, Key* key) {
-  char path[255];
-  snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
-  char key_c_str[255];
-  memset(&key_c_str, 0, 255);
-  readlink(path, key_c_str, 255);
-  *key = string((strrchr(key_c_str, '/') + 1));
+FetchingStorage::Frame* FetchingStorage::FrameFor(int64 id, bool create,
+                                                  bool* existed) {
+  Frame* frame;
+  while (true) {
+    unordered_map<int64, int>::iterator it = page_table_.find(id);
+    if (it != page_table_.end()) {
+      frame = &frames_[it->second];
+      frame->referenced = true;
+      *existed = true;
+      return frame;
+    }
+    *existed = pending_writes_.count(id) > 0 || OnDisk(id);
+    if (!*existed && !create)
+      return NULL;
+    frame = FreeFrame();
+    if (frame != NULL)
+      break;
+    // Every frame is pinned or loading: wait for txns to release some.
+    SubmitQueued();
+    pthread_mutex_unlock(&mutex_);
+    Spin(0.0001);
+    pthread_mutex_lock(&mutex_);
+  }
+
+  misses_++;
+  frame->id = id;
+  frame->pins = 0;
+  frame->referenced = true;
+  frame->dirty = false;
+  page_table_[id] = frame - &frames_[0];
+
+  unordered_map<int64, PendingWrite>::iterator pending =
+      pending_writes_.find(id);
+  if (pending != pending_writes_.end()) {
+    // Evicted recently and still being written: no need to read it back.
+    frame->value = ParsePage(pending->second.page);
+    frame->state = RESIDENT;
+  } else if (*existed) {
+    frame->value = NULL;
+    frame->state = LOADING;
+    IoRequest request = {PageIo::READ, id, new char[PAGE_SIZE], 0, GetTime()};
+    Queue(request);
+  } else {
+    frame->value = new Value();
+    frame->state = RESIDENT;
+    frame->dirty = true;
+  }
+  return frame;
 }
 
-void* FetchingStorage::RunGCThread(void* arg) {
-  FetchingStorage* storage = reinterpret_cast<FetchingStorage*>(arg);
-  while (true) {
-    double start_time = GetTime();
-    for (int i = COLD_CUTOFF; i < 1000000; i++) {
-      storage->HardUnfetch(IntToString(i));
+FetchingStorage::Frame* FetchingStorage::FreeFrame() {
+  if (!free_frames_.empty()) {
+    Frame* frame = &frames_[free_frames_.back()];
+    free_frames_.pop_back();
+    return frame;
+  }
+
+  // Two turns of the clock: the first may only clear reference bits.
+  int frames = frames_.size();
+  for (int i = 0; i < 2 * frames; i++) {
+    Frame* frame = &frames_[clock_hand_];
+    clock_hand_ = (clock_hand_ + 1) % frames;
+    if (frame->state != RESIDENT || frame->pins > 0)
+      continue;
+    if (frame->referenced) {
+      frame->referenced = false;
+      continue;
     }
-    usleep(static_cast<int>(1000000 * (GetTime() - start_time)));
+    Evict(frame);
+    return frame;
   }
   return NULL;
 }
 
+void FetchingStorage::Evict(Frame* frame) {
+  int64 id = frame->id;
+  if (frame->dirty && frame->value != NULL) {
+    uint32 length = frame->value->size();
+    assert(length <= PAGE_SIZE - sizeof(length));
+    char* page = new char[PAGE_SIZE];
+    memcpy(page, &length, sizeof(length));
+    memcpy(page + sizeof(length), frame->value->data(), length);
+    memset(page + sizeof(length) + length, 0,
+           PAGE_SIZE - sizeof(length) - length);
+
+    // A write-back still queued for this page is superseded by this one.
+    PendingWrite pending = {page, ++write_sequence_};
+    pending_writes_[id] = pending;
+    int64 size = on_disk_.size();
+    if (id >= size)
+      on_disk_.resize(id + 1 > 2 * size ? id + 1 : 2 * size);
+    on_disk_[id] = true;
+
+    IoRequest request = {PageIo::WRITE, id, page, pending.sequence,
+                         GetTime()};
+    Queue(request);
+    writes_++;
+  }
+
+  delete frame->value;
+  page_table_.erase(id);
+  frame->id = -1;
+  frame->value = NULL;
+  frame->state = FREE;
+  evictions_++;
+}
+
+void FetchingStorage::WaitLoaded(Frame* frame) {
+  if (frame->state != LOADING)
+    return;
+  double start = GetTime();
+  SubmitQueued();
+  while (frame->state == LOADING)
+    pthread_cond_wait(&loaded_, &mutex_);
+  stalls_++;
+  stall_time_ += GetTime() - start;
+}
+
 ///////////// The meat and potato public interface methods.  ///////////
 
 Value* FetchingStorage::ReadObject(const Key& key, int64 txn_id) {
-  Latch* latch = LatchFor(key);
-  // Must call a Prefetch before transaction.
-  pthread_mutex_lock(&latch->lock_);
-  assert(latch->state != ON_DISK);
-  assert(latch->state != RELEASING);
-  assert(latch->state == FETCHING || latch->state == IN_MEMORY);
-  assert(latch->active_requests > 0);
-  pthread_mutex_unlock(&latch->lock_);
-  // Block thread until pre-fetch on this key is done.
-  while (latch->state == FETCHING) {
+  pthread_mutex_lock(&mutex_);
+  bool existed;
+  Frame* frame = FrameFor(PageOf(key), false, &existed);
+  Value* value = NULL;
+  if (frame != NULL) {
+    // Keep the frame from being reused while we wait for it.
+    frame->pins++;
+    WaitLoaded(frame);
+    frame->pins--;
+    value = frame->value;
+  }
+  pthread_mutex_unlock(&mutex_);
+  return value;
+}
+
+bool FetchingStorage::CopyObject(const Key& key, Value* value) {
+  pthread_mutex_lock(&mutex_);
+  bool existed;
+  Frame* frame = FrameFor(PageOf(key), false, &existed);
+  bool found = false;
+  if (frame != NULL) {
+    frame->pins++;
+    WaitLoaded(frame);
+    frame->pins--;
+    found = frame->value != NULL;
+    if (found)
+      *value = *frame->value;
   }
-  return main_memory_->ReadObject(key);
+  pthread_mutex_unlock(&mutex_);
+  return found;
 }
 
-// Write data to memory.
+// Write data to memory. The page is written to disk when it is evicted.
 bool FetchingStorage::PutObject(const Key& key, Value* value, int64 txn_id) {
-  Latch* latch = LatchFor(key);
-  pthread_mutex_lock(&latch->lock_);
-  // Must call a prefetch before transaction
-  assert(latch->active_requests > 0);
-  latch->state = IN_MEMORY;
-  pthread_mutex_unlock(&latch->lock_);
-  main_memory_->PutObject(key, value);
+  if (value == NULL)
+    return DeleteObject(key, txn_id);
+
+  pthread_mutex_lock(&mutex_);
+  bool existed;
+  Frame* frame = FrameFor(PageOf(key), true, &existed);
+  frame->pins++;
+  WaitLoaded(frame);
+  frame->pins--;
+  if (frame->value != value) {
+    delete frame->value;
+    frame->value = value;
+  }
+  frame->dirty = true;
+  pthread_mutex_unlock(&mutex_);
   return true;
 }
 
-// Put null, change state to uninitialized.
 bool FetchingStorage::DeleteObject(const Key& key, int64 txn_id) {
-  return PutObject(key, NULL, txn_id);
+  pthread_mutex_lock(&mutex_);
+  int64 id = PageOf(key);
+  unordered_map<int64, int>::iterator it = page_table_.find(id);
+  if (it != page_table_.end()) {
+    Frame* frame = &frames_[it->second];
+    frame->pins++;
+    WaitLoaded(frame);
+    frame->pins--;
+    delete frame->value;
+    frame->value = NULL;
+    frame->dirty = false;
+    // A pinned frame stays mapped (and empty) until it is evicted.
+    if (frame->pins == 0) {
+      page_table_.erase(id);
+      frame->id = -1;
+      frame->state = FREE;
+      free_frames_.push_back(frame - &frames_[0]);
+    }
+  }
+  // Queued write-backs of the page are dropped by the I/O thread.
+  pending_writes_.erase(id);
+  if (OnDisk(id))
+    on_disk_[id] = false;
+  pthread_mutex_unlock(&mutex_);
+  return true;
 }
 
-// Return false if file does not exist.
 bool FetchingStorage::Prefetch(const Key& key, double* wait_time) {
-  Latch* latch = LatchFor(key);
-
-  pthread_mutex_lock(&latch->lock_);
-
-  int active_requests = latch->active_requests;
-  latch->active_requests++;
+  pthread_mutex_lock(&mutex_);
+  int64 id = PageOf(key);
+  if (page_table_.count(id) > 0)
+    hits_++;
+  bool existed;
+  Frame* frame = FrameFor(id, true, &existed);
+  frame->pins++;
+  // The txn may update the object in place.
+  frame->dirty = true;
+  *wait_time = (frame->state == LOADING) ? ExpectedWait() : 0;
+  pthread_mutex_unlock(&mutex_);
+  return existed;
+}
 
-  State previous_state = latch->state;
-  if (previous_state == ON_DISK)
-    latch->state = FETCHING;
-  if (previous_state == UNINITIALIZED) {
-    main_memory_->PutObject(key, new Value());
-    latch->state = IN_MEMORY;
-  }
-  if (previous_state == RELEASING)
-    latch->state = IN_MEMORY;
-  State current_state = latch->state;
-
-  pthread_mutex_unlock(&latch->lock_);
-
-  // Pre-fetch and in memory pre-states are no-ops.
-  if (current_state == IN_MEMORY) {
-    *wait_time = 0;  // You're good to go.
-    return true;
-  } else if (previous_state == FETCHING) {
-    // We already have another prefetching attempt.
-    *wait_time = 0.100;  // arbitrary nonzero result.
-    return true;
-  } else {
-    // Not in memory: cold call to prefetch.
-    assert(active_requests == 0);
-    *wait_time = 0.100;  // somewhat larger arbitrary nonzero result.
-    char* buf = new char[PAGE_SIZE];
-    return FileRead(key, buf, PAGE_SIZE);
-  }
+void FetchingStorage::SubmitPrefetches() {
+  pthread_mutex_lock(&mutex_);
+  SubmitQueued();
+  pthread_mutex_unlock(&mutex_);
 }
 
-bool FetchingStorage::HardUnfetch(const Key& key) {
-  // Since we have a write lock, we know there are no concurrent
-  // reads to this key, so we can freely read as well.
-  Latch* latch = LatchFor(key);
-  pthread_mutex_lock(&latch->lock_);
-
-  State previous_state = latch->state;
-  int active_requests = latch->active_requests;
-
-  // Only one of the following two conditions can be true.
-  if (active_requests == 0)
-    latch->state = RELEASING;
-  if (active_requests == 0 && latch->state == FETCHING)
-    latch->state = ON_DISK;
-
-  pthread_mutex_unlock(&latch->lock_);
-
-  if (active_requests == 0 && previous_state == IN_MEMORY) {
-    Value* result = main_memory_->ReadObject(key);
-    int len = strlen(result->c_str());
-    char* c_result = new char[len + 1];
-    strcpy(c_result, result->c_str());
-    return FilePut(key, c_result, len);
-  } else {
-    return true;
-  }
+double FetchingStorage::FetchWait(const Key& key) {
+  pthread_mutex_lock(&mutex_);
+  unordered_map<int64, int>::iterator it = page_table_.find(PageOf(key));
+  double wait_time = 0;
+  if (it != page_table_.end() && frames_[it->second].state == LOADING)
+    wait_time = ExpectedWait();
+  pthread_mutex_unlock(&mutex_);
+  return wait_time;
 }
 
 bool FetchingStorage::Unfetch(const Key& key) {
-  Latch* latch = LatchFor(key);
-  pthread_mutex_lock(&latch->lock_);
-  State state = latch->state;
-  latch->active_requests--;
-  assert(latch->active_requests >= 0);
-  assert(latch->state == FETCHING || latch->state == RELEASING ||
-         latch->state == IN_MEMORY);
-  pthread_mutex_unlock(&latch->lock_);
-  if (state == UNINITIALIZED)
-    HardUnfetch(key);
+  pthread_mutex_lock(&mutex_);
+  unordered_map<int64, int>::iterator it = page_table_.find(PageOf(key));
+  if (it != page_table_.end()) {
+    assert(frames_[it->second].pins > 0);
+    frames_[it->second].pins--;
+  }
+  pthread_mutex_unlock(&mutex_);
   return true;
 }
 
-///////////////// Asynchronous Callbacks ////////////////////////
-
-void FetchingStorage::PrefetchCompletionHandler(sigval_t sigval) {
-  struct aiocb* req;
-  req = (struct aiocb*)sigval.sival_ptr;
-  /* Did the request complete? */
-  if (aio_error(req) == 0) {
-    /* Request completed successfully, get the return status */
-    string key;
-    char* buf =
-        const_cast<char*>(reinterpret_cast<volatile char*>(req->aio_buf));
-    GetKey(req->aio_fildes, &key);
-    FetchingStorage* store = FetchingStorage::BuildStorage();
-    Latch* latch = store->LatchFor(key);
-    pthread_mutex_lock(&latch->lock_);
-    State prev_state = latch->state;
-    latch->state = IN_MEMORY;
-    pthread_mutex_unlock(&latch->lock_);
-    /* Nothing interfered with our fetch */
-    if (prev_state == FETCHING) {
-      string* value = new string(buf, PAGE_SIZE);
-      store->main_memory_->PutObject(key, value);
-    }
-    delete[] buf;
-    close(req->aio_fildes);
-    delete req;
-  }
+string FetchingStorage::ReportStats() {
+  pthread_mutex_lock(&mutex_);
+  double now = GetTime();
+  double elapsed = now - interval_start_;
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "Buffer pool (%s): %.1f%% hit rate, %.0f evictions/s, "
+           "%.0f reads/s, %.0f writes/s, avg prefetch %.3f ms, "
+           "%.0f stalls/s (avg %.3f ms)",
+           page_io_->name().c_str(),
+           hits_ + misses_ > 0 ? 100.0 * hits_ / (hits_ + misses_) : 0,
+           elapsed > 0 ? evictions_ / elapsed : 0,
+           elapsed > 0 ? reads_ / elapsed : 0,
+           elapsed > 0 ? writes_ / elapsed : 0,
+           reads_ > 0 ? read_time_ * 1000 / reads_ : 0,
+           elapsed > 0 ? stalls_ / elapsed : 0,
+           stalls_ > 0 ? stall_time_ * 1000 / stalls_ : 0);
+  interval_start_ = now;
+  hits_ = 0;
+  misses_ = 0;
+  evictions_ = 0;
+  writes_ = 0;
+  reads_ = 0;
+  read_time_ = 0;
+  stalls_ = 0;
+  stall_time_ = 0;
+  pthread_mutex_unlock(&mutex_);
+  return string(buffer);
 }
 
-void FetchingStorage::UnfetchCompletionHandler(sigval_t sigval) {
-  struct aiocb* req;
-  req = (struct aiocb*)sigval.sival_ptr;
-  /* Did the request complete? */
-  if (aio_error(req) == 0) {
-    /* Request completed successfully, get the return status */
-    string key;
-    GetKey(req->aio_fildes, &key);
-    FetchingStorage* store = FetchingStorage::BuildStorage();
-    Latch* latch = store->LatchFor(key);
-    pthread_mutex_lock(&latch->lock_);
-    // Hasn't been fetched.
-    assert(latch->active_requests >= 0);
-    int active_requests = latch->active_requests;
-    State state = latch->state;
-    pthread_mutex_unlock(&latch->lock_);
-    if (state == RELEASING && active_requests <= 0) {
-      store->main_memory_->DeleteObject(key);
-      latch->state = ON_DISK;
+///////////////// Asynchronous I/O ////////////////////////
+
+void FetchingStorage::Queue(const IoRequest& request) {
+  if (queued_.empty())
+    queued_since_ = GetTime();
+  queued_.push_back(new IoRequest(request));
+}
+
+void FetchingStorage::SubmitQueued() {
+  vector<PageIo::Request> requests;
+  vector<IoRequest*> deferred;
+  for (size_t i = 0; i < queued_.size(); i++) {
+    IoRequest* request = queued_[i];
+    if (request->op == PageIo::WRITE) {
+      // Drop write-backs that a later eviction or a delete superseded.
+      unordered_map<int64, PendingWrite>::iterator pending =
+          pending_writes_.find(request->id);
+      if (pending == pending_writes_.end() ||
+          pending->second.sequence != request->sequence) {
+        delete[] request->page;
+        delete request;
+        continue;
+      }
+      // Writes of one page must not overlap, or they could land out of
+      // order.
+      if (writing_.count(request->id) > 0) {
+        deferred.push_back(request);
+        continue;
+      }
+      writing_.insert(request->id);
     }
-    close(req->aio_fildes);
-    delete[] reinterpret_cast<volatile char*>(req->aio_buf);
-    delete req;
+    PageIo::Request page_request = {request->op, request->id * PAGE_SIZE,
+                                    request->page, request};
+    requests.push_back(page_request);
   }
-  return;
+  queued_.swap(deferred);
+  queued_since_ = GetTime();
+  if (requests.empty())
+    return;
+
+  in_flight_ += requests.size();
+  pthread_mutex_unlock(&mutex_);
+  page_io_->Submit(requests);
+  pthread_mutex_lock(&mutex_);
 }
 
-/*
- * Here live the bogus hacks.
- */
-
-bool FetchingStorage::FileRead(const Key& key, char* result, int size) {
-  string fileName(STORAGE_PATH);
-  fileName.append(key);
-  int fd = open(fileName.c_str(), O_RDONLY | O_NONBLOCK);
-  if (fd == -1)
-    return false;
-  return aio_read(generateControlBlock(fd, result, size, FETCH)) >= 0;
+void* FetchingStorage::RunCompletionThread(void* arg) {
+  reinterpret_cast<FetchingStorage*>(arg)->RunCompletions();
+  return NULL;
 }
 
-bool FetchingStorage::FilePut(const Key& key, char* value, int size) {
-  string fileName(STORAGE_PATH);
-  fileName.append(key);
-  mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
-  int fd =
-      open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_NONBLOCK, mode);
-  if (fd == -1)
-    return false;
-  return aio_write(generateControlBlock(fd, value, size, RELEASE)) >= 0;
+void FetchingStorage::RunCompletions() {
+  vector<PageIo::Request> done;
+  while (true) {
+    page_io_->Poll(&done);
+    if (!done.empty()) {
+      Complete(done);
+      done.clear();
+      continue;
+    }
+
+    pthread_mutex_lock(&mutex_);
+    // Requests nobody waits for yet (mostly write-backs) go out once enough
+    // have accumulated or they have waited for an epoch.
+    if (!queued_.empty() &&
+        (stopped_ || queued_.size() >= BUFFER_POOL_IO_BATCH ||
+         GetTime() >= queued_since_ + EPOCH_DURATION))
+      SubmitQueued();
+    bool finished = stopped_ && queued_.empty() && in_flight_ == 0;
+
+    // Report once per second while the pool is in use.
+    bool report = false;
+    if (GetTime() >= interval_start_ + 1) {
+      report = hits_ + misses_ > 0;
+      if (!report)
+        interval_start_ = GetTime();
+    }
+    pthread_mutex_unlock(&mutex_);
+    if (finished)
+      break;
+    if (report)
+      printf("%s\n", ReportStats().c_str());
+    Spin(0.00005);
+  }
 }
 
-aiocb* FetchingStorage::generateControlBlock(int fd,
-                                             char* buf,
-                                             const int size,
-                                             Operation op) {
-  aiocb* aiocbp = new aiocb();
-  aiocbp->aio_fildes = fd;
-  aiocbp->aio_offset = 0;
-  aiocbp->aio_buf = buf;
-  aiocbp->aio_nbytes = size;
-  aiocbp->aio_reqprio = 0;
-  /* Link the AIO request with a thread callback */
-  aiocbp->aio_sigevent.sigev_notify = SIGEV_THREAD;
-  if (op == FETCH)
-    aiocbp->aio_sigevent.sigev_notify_function = &PrefetchCompletionHandler;
-  else
-    aiocbp->aio_sigevent.sigev_notify_function = &UnfetchCompletionHandler;
-  aiocbp->aio_sigevent.sigev_notify_attributes = NULL;
-  aiocbp->aio_sigevent.sigev_value.sival_ptr = aiocbp;
-  return aiocbp;
+void FetchingStorage::Complete(const vector<PageIo::Request>& done) {
+  double now = GetTime();
+  pthread_mutex_lock(&mutex_);
+  for (size_t i = 0; i < done.size(); i++) {
+    IoRequest* request = reinterpret_cast<IoRequest*>(done[i].tag);
+    if (request->op == PageIo::READ) {
+      // Loading frames are pinned in place, so the page is still mapped.
+      Frame* frame = &frames_[page_table_[request->id]];
+      assert(frame->state == LOADING);
+      frame->value = ParsePage(request->page);
+      frame->state = RESIDENT;
+      double latency = now - request->start;
+      reads_++;
+      read_time_ += latency;
+      read_latency_ = 0.9 * read_latency_ + 0.1 * latency;
+    } else {
+      writing_.erase(request->id);
+      unordered_map<int64, PendingWrite>::iterator pending =
+          pending_writes_.find(request->id);
+      if (pending != pending_writes_.end() &&
+          pending->second.sequence == request->sequence)
+        pending_writes_.erase(pending);
+    }
+    delete[] request->page;
+    delete request;
+  }
+  in_flight_ -= done.size();
+  pthread_cond_broadcast(&loaded_);
+  pthread_mutex_unlock(&mutex_);
 }
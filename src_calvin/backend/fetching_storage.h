@@ -2,88 +2,198 @@
 //
 // An implementation of the storage interface taking into account
 // main memory, disk, and swapping algorithms.
+//
+// Objects live in a single data file of fixed-size pages, one object per
+// page, numbered in the order their keys are first seen. A buffer pool of
+// BUFFER_POOL_FRAMES frames caches pages in memory; a page table maps resident
+// keys to frames and a clock sweep picks the frame to reuse on a miss. Dirty
+// pages are written back when their frame is evicted.
+//
+// Prefetch() pins a page and queues a read if it is not resident. Queued reads
+// and write-backs go to the disk together through a PageIo backend (see
+// backend/page_io.h): when SubmitPrefetches() is called (once per sequencer
+// epoch), when someone has to wait for a page, or once BUFFER_POOL_IO_BATCH
+// requests or EPOCH_DURATION have accumulated. A dedicated thread polls for
+// completions. Unfetch() unpins the page, making it a candidate for eviction
+// again. Objects returned by ReadObject() are only guaranteed to stay in memory
+// while the caller holds a pin.
 
 #ifndef _DB_BACKEND_FETCHING_STORAGE_H_
 #define _DB_BACKEND_FETCHING_STORAGE_H_
 
-#include <aio.h>
 #include <pthread.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <cassert>
-#include <cstdlib>
-#include <cstring>
-#include <string>
 
-#include <signal.h>
+#include <string>
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
+#include <vector>
 
-#include "common/utils.h"
+#include "backend/page_io.h"
 #include "backend/storage.h"
-#include "backend/simple_storage.h"
+#include "common/definitions.hh"
+#include "common/utils.h"
 
-#define PAGE_SIZE 1000
+#define PAGE_SIZE 4096
 #define STORAGE_PATH "../db/storage/"
 
+using std::string;
+using std::tr1::unordered_map;
+using std::tr1::unordered_set;
+using std::vector;
+
 class FetchingStorage : public Storage {
  public:
-  static FetchingStorage* BuildStorage();
-  ~FetchingStorage();
+  // Returns the storage shared by this process, backed by STORAGE_PATH and
+  // accessed through the PageIo backend 'page_io' when first built.
+  static FetchingStorage* BuildStorage(const string& page_io = "uring");
+
+  // Keeps up to 'frames' pages of the data file 'path' in memory. The data
+  // file is emptied on construction. Falls back to the "aio" backend if
+  // 'page_io' is not available.
+  FetchingStorage(const string& path, int frames,
+                  const string& page_io = "uring");
+  virtual ~FetchingStorage();
+
   virtual Value* ReadObject(const Key& key, int64 txn_id = 0);
+  virtual bool CopyObject(const Key& key, Value* value);
   virtual bool PutObject(const Key& key, Value* value, int64 txn_id = 0);
   virtual bool DeleteObject(const Key& key, int64 txn_id = 0);
+
+  // Pins the page of 'key' and sets '*wait_time' to the expected time until
+  // it is in memory (0 if it already is). Returns false if 'key' does not
+  // exist yet, in which case an empty object is created for it.
   virtual bool Prefetch(const Key& key, double* wait_time);
+
+  // Releases a pin taken by Prefetch().
   virtual bool Unfetch(const Key& key);
-  bool HardUnfetch(const Key& key);
-
-  // Latch object that stores a counter for readlocks and a boolean for write
-  // locks.
-  enum State { UNINITIALIZED, IN_MEMORY, ON_DISK, FETCHING, RELEASING };
-  class Latch {
-   public:
-    int active_requests;  // Can be as many as you want.
-    State state;
-    pthread_mutex_t lock_;
 
-    Latch() {
-      active_requests = 0;
-      state = UNINITIALIZED;
-      pthread_mutex_init(&lock_, NULL);
-    }
-  };
-  Latch* LatchFor(const Key& key);
-  static void PrefetchCompletionHandler(sigval_t sigval);
-  static void UnfetchCompletionHandler(sigval_t sigval);
-  static void GetKey(int fd, Key* key);
+  // Returns the expected time until the pinned page of 'key' is in memory.
+  virtual double FetchWait(const Key& key);
 
- private:
-  FetchingStorage();
-  /*
-   * The following functions are bogus hacks that should be factored out into
-   * a separate disk layer. To make the callbacks play nice for now, everything
-   * is being placed here. After November 1, we can swap out backends.
-   */
+  // Sends all queued page reads and writes to the disk at once.
+  virtual void SubmitPrefetches();
 
-  enum Operation { FETCH, RELEASE };
+  // Returns hit rate, evictions, I/O rates, prefetch latency and the reads
+  // and writes that had to wait for the disk since the last call.
+  string ReportStats();
 
-  // Registers an asynchronous read.
-  bool FileRead(const Key& key, char* result, int size);
+ private:
+  enum State { FREE, LOADING, RESIDENT };
 
-  // Registers an asynchronous write.
-  bool FilePut(const Key& key, char* value, int size);
+  struct Frame {
+    int64 id;
+    Value* value;
+    State state;
+    int pins;
+    bool referenced;
+    bool dirty;
+  };
 
-  // XXX(scw): Document? `int fd' used to be `int& fd'. Move it to the last
-  //           argument and retype `int* fd' if used as an output argument.
-  aiocb* generateControlBlock(int fd, char* buf, const int size, Operation op);
+  struct IoRequest {
+    PageIo::Operation op;
+    int64 id;
+    char* page;
+    // Sequence number of the write-back, to drop superseded ones.
+    int64 sequence;
+    double start;
+  };
 
-  static FetchingStorage* self;
+  // A page written back on eviction but not yet on disk. Misses on it are
+  // served from here.
+  struct PendingWrite {
+    char* page;
+    int64 sequence;
+  };
 
-  // Additional State
+  // Returns the page number of 'key', giving it the next one if it has none.
+  // Requires 'mutex_'.
+  int64 PageOf(const Key& key);
+
+  // Returns the frame holding page 'id', loading or (if 'create' is set and
+  // it does not exist) creating it as needed. Returns NULL if the page does
+  // not exist and 'create' is not set. '*existed' tells whether it did.
+  // Requires 'mutex_'.
+  Frame* FrameFor(int64 id, bool create, bool* existed);
+
+  // Returns a free frame, evicting the first unpinned, unreferenced one under
+  // the clock hand if there is none. Returns NULL if all frames are pinned or
+  // loading. Requires 'mutex_'.
+  Frame* FreeFrame();
+
+  // Drops page 'frame' from memory, queueing a write-back if it is dirty.
+  // Requires 'mutex_'.
+  void Evict(Frame* frame);
+
+  // Waits until 'frame' is no longer loading, submitting queued requests
+  // first. Requires 'mutex_'.
+  void WaitLoaded(Frame* frame);
+
+  // Returns the expected time until a read queued now completes: the read
+  // latency, once per BUFFER_POOL_IO_DEPTH requests ahead of it. Requires
+  // 'mutex_'.
+  double ExpectedWait() const {
+    return read_latency_ *
+           (1 + (queued_.size() + in_flight_) / BUFFER_POOL_IO_DEPTH);
+  }
+
+  // Returns whether page 'id' is on disk or on its way there. Requires
+  // 'mutex_'.
+  bool OnDisk(int64 id) const {
+    return id < static_cast<int64>(on_disk_.size()) && on_disk_[id];
+  }
+
+  // Queues 'request' for the next submission. Requires 'mutex_'.
+  void Queue(const IoRequest& request);
+
+  // Submits all queued requests, except write-backs that were superseded
+  // (dropped) or whose page is still being written (kept queued). Releases
+  // 'mutex_' while submitting. Requires 'mutex_'.
+  void SubmitQueued();
+
+  static void* RunCompletionThread(void* arg);
+  void RunCompletions();
+  void Complete(const vector<PageIo::Request>& done);
 
-  Storage* main_memory_;
-  Latch* latches_;
+  static FetchingStorage* self;
 
-  // GC thread stuff.
-  static void* RunGCThread(void* arg);
-  pthread_t gc_thread_;
+  int fd_;
+  PageIo* page_io_;
+
+  // Buffer pool state, guarded by 'mutex_'. 'loaded_' is signalled whenever
+  // pages finish loading.
+  pthread_mutex_t mutex_;
+  pthread_cond_t loaded_;
+  vector<Frame> frames_;
+  vector<int> free_frames_;
+  int clock_hand_;
+  unordered_map<Key, int64> page_ids_;
+  unordered_map<int64, int> page_table_;
+  unordered_map<int64, PendingWrite> pending_writes_;
+  vector<bool> on_disk_;
+  int64 write_sequence_;
+
+  // Expected time to load a page, as a moving average.
+  double read_latency_;
+
+  // Statistics since the last ReportStats(), guarded by 'mutex_'.
+  double interval_start_;
+  int64 hits_;
+  int64 misses_;
+  int64 evictions_;
+  int64 writes_;
+  int64 reads_;
+  double read_time_;
+  int64 stalls_;
+  double stall_time_;
+
+  // Requests not submitted yet, since when, pages with a write-back in
+  // flight, and the number of requests in flight. Guarded by 'mutex_'.
+  vector<IoRequest*> queued_;
+  double queued_since_;
+  unordered_set<int64> writing_;
+  int in_flight_;
+
+  volatile bool stopped_;
+  pthread_t completion_thread_;
 };
 #endif  // _DB_BACKEND_FETCHING_STORAGE_H_
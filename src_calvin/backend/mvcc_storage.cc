@@ -0,0 +1,261 @@
+// Multi-version storage with lock-free snapshot reads.
+
+#include "backend/mvcc_storage.h"
+
+MvccStorage::MvccStorage()
+    : buckets_(MVCC_BUCKETS, static_cast<Object*>(NULL)), objects_(0),
+      watermark_(-1), versions_(0) {
+  for (int i = 0; i < MVCC_LOCK_STRIPES; i++)
+    pthread_mutex_init(&stripes_[i], NULL);
+  pthread_mutex_init(&snapshot_mutex_, NULL);
+  pthread_mutex_init(&collect_mutex_, NULL);
+}
+
+MvccStorage::~MvccStorage() {
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    while (buckets_[i] != NULL) {
+      Object* next = buckets_[i]->next;
+      Free(buckets_[i]->versions);
+      delete buckets_[i];
+      buckets_[i] = next;
+    }
+  }
+  for (int i = 0; i < MVCC_LOCK_STRIPES; i++)
+    pthread_mutex_destroy(&stripes_[i]);
+  pthread_mutex_destroy(&snapshot_mutex_);
+  pthread_mutex_destroy(&collect_mutex_);
+}
+
+MvccStorage::Object* MvccStorage::Find(const Key& key, size_t bucket) const {
+  Object* object = __atomic_load_n(&buckets_[bucket], __ATOMIC_ACQUIRE);
+  while (object != NULL && object->key != key)
+    object = __atomic_load_n(&object->next, __ATOMIC_ACQUIRE);
+  return object;
+}
+
+MvccStorage::Object* MvccStorage::FindOrCreate(const Key& key,
+                                               size_t bucket) {
+  Object* object = Find(key, bucket);
+  if (object != NULL)
+    return object;
+  object = new Object();
+  object->key = key;
+  object->hash = hash_(key);
+  object->versions = NULL;
+  object->next = buckets_[bucket];
+  object->queued = false;
+  // Readers may walk the chain at any time, so publish the object only once
+  // it is complete.
+  __atomic_store_n(&buckets_[bucket], object, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&objects_, 1, __ATOMIC_RELAXED);
+  return object;
+}
+
+void MvccStorage::Push(Object* object, int64 txn_id, Value* value) {
+  Version* version = new Version();
+  version->txn_id = txn_id;
+  version->value = value;
+  version->next = object->versions;
+  __atomic_store_n(&object->versions, version, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&versions_, 1, __ATOMIC_RELAXED);
+
+  if (version->next != NULL && !object->queued) {
+    object->queued = true;
+    pthread_mutex_lock(&collect_mutex_);
+    collect_.push_back(object);
+    pthread_mutex_unlock(&collect_mutex_);
+  }
+}
+
+int64 MvccStorage::Free(Version* version) {
+  int64 count = 0;
+  while (version != NULL) {
+    Version* next = version->next;
+    delete version->value;
+    delete version;
+    version = next;
+    count++;
+  }
+  return count;
+}
+
+Value* MvccStorage::ReadObject(const Key& key, int64 txn_id) {
+  size_t bucket = BucketOf(hash_(key));
+  Object* object = Find(key, bucket);
+  if (object == NULL)
+    return NULL;
+  if (txn_id <= watermark_)
+    return const_cast<Value*>(ReadSnapshot(key, txn_id));
+
+  pthread_mutex_t* stripe = StripeOf(bucket);
+  pthread_mutex_lock(stripe);
+  Version* version = object->versions;
+  if (txn_id != LLONG_MAX && version != NULL && version->txn_id < txn_id &&
+      version->value != NULL) {
+    Push(object, txn_id, new Value(*version->value));
+    version = object->versions;
+  }
+  while (version != NULL && version->txn_id > txn_id)
+    version = version->next;
+  Value* value = (version == NULL) ? NULL : version->value;
+  pthread_mutex_unlock(stripe);
+  return value;
+}
+
+bool MvccStorage::CopyObject(const Key& key, Value* value) {
+  size_t bucket = BucketOf(hash_(key));
+  Object* object = Find(key, bucket);
+  if (object == NULL)
+    return false;
+  pthread_mutex_t* stripe = StripeOf(bucket);
+  pthread_mutex_lock(stripe);
+  Version* head = object->versions;
+  bool found = head != NULL && head->value != NULL;
+  if (found)
+    *value = *head->value;
+  pthread_mutex_unlock(stripe);
+  return found;
+}
+
+bool MvccStorage::Write(const Key& key, Value* value, int64 txn_id) {
+  size_t bucket = BucketOf(hash_(key));
+  pthread_mutex_t* stripe = StripeOf(bucket);
+  pthread_mutex_lock(stripe);
+  Object* object =
+      (value == NULL) ? Find(key, bucket) : FindOrCreate(key, bucket);
+  Version* head = (object == NULL) ? NULL : object->versions;
+  if (head == NULL || (value == NULL && head->value == NULL)) {
+    // Nothing to delete.
+    if (value != NULL)
+      Push(object, txn_id, value);
+  } else if (head->txn_id == txn_id && txn_id > watermark_) {
+    // The txn's own version, which no snapshot can see yet.
+    if (head->value != value) {
+      delete head->value;
+      head->value = value;
+    }
+  } else {
+    Push(object, txn_id > head->txn_id ? txn_id : head->txn_id, value);
+  }
+  pthread_mutex_unlock(stripe);
+  return true;
+}
+
+bool MvccStorage::PutObject(const Key& key, Value* value, int64 txn_id) {
+  if (value == NULL)
+    return DeleteObject(key, txn_id);
+  return Write(key, value, txn_id);
+}
+
+bool MvccStorage::DeleteObject(const Key& key, int64 txn_id) {
+  return Write(key, NULL, txn_id);
+}
+
+bool MvccStorage::ListKeys(vector<Key>* keys) {
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    for (Object* object = __atomic_load_n(&buckets_[i], __ATOMIC_ACQUIRE);
+         object != NULL;
+         object = __atomic_load_n(&object->next, __ATOMIC_ACQUIRE)) {
+      Version* head = __atomic_load_n(&object->versions, __ATOMIC_ACQUIRE);
+      if (head != NULL && head->value != NULL)
+        keys->push_back(object->key);
+    }
+  }
+  return true;
+}
+
+void MvccStorage::Reserve(int64 objects) {
+  size_t size = buckets_.size();
+  while (static_cast<int64>(size) < objects_ + objects)
+    size *= 2;
+  if (size == buckets_.size())
+    return;
+
+  vector<Object*> buckets(size, static_cast<Object*>(NULL));
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    while (buckets_[i] != NULL) {
+      Object* object = buckets_[i];
+      buckets_[i] = object->next;
+      size_t bucket = object->hash & (size - 1);
+      object->next = buckets[bucket];
+      buckets[bucket] = object;
+    }
+  }
+  buckets_.swap(buckets);
+}
+
+void MvccStorage::AdvanceWatermark(int64 txn_id) {
+  if (txn_id <= watermark_)
+    return;
+  watermark_ = txn_id;
+  Collect();
+}
+
+int64 MvccStorage::BeginSnapshot() {
+  pthread_mutex_lock(&snapshot_mutex_);
+  int64 snapshot = watermark_;
+  snapshots_.insert(snapshot);
+  pthread_mutex_unlock(&snapshot_mutex_);
+  return snapshot;
+}
+
+const Value* MvccStorage::ReadSnapshot(const Key& key, int64 snapshot) {
+  Object* object = Find(key, BucketOf(hash_(key)));
+  if (object == NULL)
+    return NULL;
+  Version* version = __atomic_load_n(&object->versions, __ATOMIC_ACQUIRE);
+  while (version != NULL && version->txn_id > snapshot)
+    version = __atomic_load_n(&version->next, __ATOMIC_ACQUIRE);
+  return (version == NULL) ? NULL : version->value;
+}
+
+void MvccStorage::EndSnapshot(int64 snapshot) {
+  pthread_mutex_lock(&snapshot_mutex_);
+  snapshots_.erase(snapshots_.find(snapshot));
+  pthread_mutex_unlock(&snapshot_mutex_);
+}
+
+void MvccStorage::Collect() {
+  // Snapshots begun from now on are at the watermark, so they cannot see
+  // anything older than 'horizon' either.
+  pthread_mutex_lock(&snapshot_mutex_);
+  int64 horizon = watermark_;
+  if (!snapshots_.empty() && *snapshots_.begin() < horizon)
+    horizon = *snapshots_.begin();
+  pthread_mutex_unlock(&snapshot_mutex_);
+
+  vector<Object*> objects;
+  pthread_mutex_lock(&collect_mutex_);
+  objects.swap(collect_);
+  pthread_mutex_unlock(&collect_mutex_);
+
+  vector<Object*> remaining;
+  int64 collected = 0;
+  for (size_t i = 0; i < objects.size(); i++) {
+    Object* object = objects[i];
+    pthread_mutex_t* stripe = StripeOf(BucketOf(object->hash));
+    pthread_mutex_lock(stripe);
+    // Every reader stops at or before the newest version no later than
+    // 'horizon', so the ones behind it are unreachable.
+    Version* version = object->versions;
+    while (version != NULL && version->txn_id > horizon)
+      version = version->next;
+    Version* garbage = NULL;
+    if (version != NULL) {
+      garbage = version->next;
+      __atomic_store_n(&version->next, static_cast<Version*>(NULL),
+                       __ATOMIC_RELEASE);
+    }
+    if (object->versions->next != NULL)
+      remaining.push_back(object);
+    else
+      object->queued = false;
+    pthread_mutex_unlock(stripe);
+    collected += Free(garbage);
+  }
+  __atomic_sub_fetch(&versions_, collected, __ATOMIC_RELAXED);
+
+  pthread_mutex_lock(&collect_mutex_);
+  collect_.insert(collect_.end(), remaining.begin(), remaining.end());
+  pthread_mutex_unlock(&collect_mutex_);
+}
@@ -0,0 +1,154 @@
+// A multi-version storage for snapshot reads.
+//
+// Every object has a chain of versions, newest first, each stamped with the id
+// of the txn that created it. Txn ids follow the global serial order, so a
+// reader at txn id 't' sees the newest version stamped no later than 't'.
+//
+// Applications update the values they read in place, so every txn touching an
+// object gets a version of its own: the first ReadObject() or PutObject() of
+// txn 't' pushes a copy of the newest version stamped 't'. Older versions stay
+// intact for snapshot readers.
+//
+// Snapshots are taken at the watermark, the txn id up to which every txn has
+// completed (see AdvanceWatermark()). Reads at a snapshot take no locks: the
+// hash table and the version chains are only ever extended at their heads, and
+// versions are only unlinked once no snapshot can reach them. Writers lock one
+// of MVCC_LOCK_STRIPES stripes of buckets.
+//
+// Versions are collected whenever the watermark advances, i.e. once per batch:
+// for every object written since, everything behind its newest version no
+// later than the oldest snapshot in use is dropped. Objects are never removed
+// from the table; deleted ones keep a single empty version.
+
+#ifndef _DB_BACKEND_MVCC_STORAGE_H_
+#define _DB_BACKEND_MVCC_STORAGE_H_
+
+#include <pthread.h>
+
+#include <climits>
+#include <set>
+#include <string>
+#include <tr1/unordered_map>
+#include <vector>
+
+#include "backend/versioned_storage.h"
+#include "common/definitions.hh"
+
+using std::multiset;
+using std::string;
+using std::vector;
+
+class MvccStorage : public VersionedStorage {
+ public:
+  MvccStorage();
+  virtual ~MvccStorage();
+
+  // Returns the version of 'key' as of 'txn_id', or NULL if it did not exist
+  // then. A txn later than the watermark gets a version of its own that it may
+  // update in place. At LLONG_MAX, returns the newest version without
+  // creating one.
+  virtual Value* ReadObject(const Key& key, int64 txn_id = LLONG_MAX);
+
+  // Copies the newest version of 'key', which collection never frees.
+  virtual bool CopyObject(const Key& key, Value* value);
+
+  // Makes 'value' the version of 'key' as of 'txn_id'. Writes stamped no
+  // later than the newest version (bulk loads, migrations) supersede it.
+  virtual bool PutObject(const Key& key, Value* value, int64 txn_id);
+
+  // Writes an empty version of 'key' as of 'txn_id'.
+  virtual bool DeleteObject(const Key& key, int64 txn_id);
+
+  virtual bool ListKeys(vector<Key>* keys);
+
+  // Resizes the hash table for 'objects' more objects. Must not run
+  // concurrently with any other call.
+  virtual void Reserve(int64 objects);
+
+  // Checkpoints are taken by CollapsedVersionedStorage only.
+  virtual int Checkpoint() { return -1; }
+
+  // Records that every txn up to 'txn_id' has completed and collects the
+  // versions no snapshot can see any more.
+  virtual void AdvanceWatermark(int64 txn_id);
+
+  // Starts a snapshot at the current watermark and returns its txn id.
+  // Versions it can see are kept until EndSnapshot() is called with that id.
+  int64 BeginSnapshot();
+
+  // Returns the version of 'key' as of 'snapshot', or NULL. Takes no locks.
+  // The value must not be modified.
+  const Value* ReadSnapshot(const Key& key, int64 snapshot);
+
+  void EndSnapshot(int64 snapshot);
+
+  int64 watermark() const { return watermark_; }
+
+  // Returns the number of versions currently stored, including empty ones.
+  int64 versions() const { return versions_; }
+
+ private:
+  struct Version {
+    int64 txn_id;
+    // NULL if the object was deleted.
+    Value* value;
+    Version* next;
+  };
+
+  struct Object {
+    Key key;
+    size_t hash;
+    Version* versions;
+    Object* next;
+    // Set while the object is in 'collect_'. Guarded by its stripe's lock.
+    bool queued;
+  };
+
+  size_t BucketOf(size_t hash) const { return hash & (buckets_.size() - 1); }
+
+  pthread_mutex_t* StripeOf(size_t bucket) {
+    return &stripes_[bucket % MVCC_LOCK_STRIPES];
+  }
+
+  // Returns the object of 'key', or NULL. Takes no locks.
+  Object* Find(const Key& key, size_t bucket) const;
+
+  // Returns the object of 'key', creating it if necessary. Requires the lock
+  // of the bucket's stripe.
+  Object* FindOrCreate(const Key& key, size_t bucket);
+
+  // Pushes a version stamped 'txn_id' holding 'value' onto 'object'. Requires
+  // the lock of the object's stripe.
+  void Push(Object* object, int64 txn_id, Value* value);
+
+  // Writes 'value' (NULL for a deletion) as of 'txn_id'.
+  bool Write(const Key& key, Value* value, int64 txn_id);
+
+  // Drops the versions no snapshot can see of the objects in 'collect_'.
+  void Collect();
+
+  // Deletes 'version' and the ones behind it. Returns how many there were.
+  static int64 Free(Version* version);
+
+  // Power-of-two sized array of bucket chains, the number of objects in
+  // them, and the writer locks.
+  vector<Object*> buckets_;
+  volatile int64 objects_;
+  pthread_mutex_t stripes_[MVCC_LOCK_STRIPES];
+  std::tr1::hash<Key> hash_;
+
+  // Every txn up to 'watermark_' has completed.
+  volatile int64 watermark_;
+
+  // Snapshots in use, guarded by 'snapshot_mutex_'.
+  multiset<int64> snapshots_;
+  pthread_mutex_t snapshot_mutex_;
+
+  // Objects with more than one version, guarded by 'collect_mutex_'.
+  vector<Object*> collect_;
+  pthread_mutex_t collect_mutex_;
+
+  volatile int64 versions_;
+};
+
+#endif  // _DB_BACKEND_MVCC_STORAGE_H_
@@ -0,0 +1,375 @@
+// Asynchronous reads and writes of whole pages of a data file.
+
+#include "backend/page_io.h"
+
+#include <aio.h>
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/utils.h"
+
+namespace {
+
+// Reports a failed page read or write. There is no way to recover the
+// buffer pool from that.
+void PageIoFailed(int error) {
+  errno = error;
+  perror("Cannot access data file page");
+  exit(EXIT_FAILURE);
+}
+
+class AioPageIo : public PageIo {
+ public:
+  AioPageIo(int fd, int page_size, int depth)
+      : fd_(fd), page_size_(page_size), depth_(depth), reserved_(0) {
+    pthread_mutex_init(&mutex_, NULL);
+  }
+
+  virtual ~AioPageIo() {
+    for (size_t i = 0; i < in_flight_.size(); i++)
+      delete in_flight_[i].control_block;
+    pthread_mutex_destroy(&mutex_);
+  }
+
+  virtual void Submit(const vector<Request>& requests) {
+    vector<InFlight> prepared;
+    for (size_t i = 0; i < requests.size(); i++) {
+      // Start what is prepared before waiting for requests to complete.
+      if (!Reserve(false)) {
+        Start(&prepared);
+        Reserve(true);
+      }
+      aiocb* control_block = new aiocb();
+      memset(control_block, 0, sizeof(*control_block));
+      control_block->aio_fildes = fd_;
+      control_block->aio_offset = requests[i].offset;
+      control_block->aio_buf = requests[i].page;
+      control_block->aio_nbytes = page_size_;
+      control_block->aio_lio_opcode =
+          (requests[i].op == READ) ? LIO_READ : LIO_WRITE;
+      control_block->aio_sigevent.sigev_notify = SIGEV_NONE;
+      InFlight in_flight = {control_block, requests[i]};
+      prepared.push_back(in_flight);
+    }
+    Start(&prepared);
+  }
+
+  virtual void Poll(vector<Request>* done) {
+    pthread_mutex_lock(&mutex_);
+    done->insert(done->end(), completed_.begin(), completed_.end());
+    completed_.clear();
+    Reap(done);
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  virtual string name() const { return "aio"; }
+
+ private:
+  struct InFlight {
+    aiocb* control_block;
+    Request request;
+  };
+
+  // Starts all of '*prepared' with one call and clears it.
+  void Start(vector<InFlight>* prepared) {
+    if (prepared->empty())
+      return;
+    vector<aiocb*> list;
+    for (size_t i = 0; i < prepared->size(); i++)
+      list.push_back((*prepared)[i].control_block);
+    if (lio_listio(LIO_NOWAIT, &list[0], list.size(), NULL) != 0)
+      PageIoFailed(errno);
+
+    pthread_mutex_lock(&mutex_);
+    in_flight_.insert(in_flight_.end(), prepared->begin(), prepared->end());
+    pthread_mutex_unlock(&mutex_);
+    prepared->clear();
+  }
+
+  // Counts one more request in flight if fewer than 'depth_' are. If 'wait'
+  // is set, waits for that, collecting completions meanwhile since the caller
+  // may be the polling thread. Returns whether the request was counted.
+  bool Reserve(bool wait) {
+    pthread_mutex_lock(&mutex_);
+    while (reserved_ >= depth_) {
+      Reap(&completed_);
+      if (reserved_ < depth_ || !wait)
+        break;
+      pthread_mutex_unlock(&mutex_);
+      Spin(0.00005);
+      pthread_mutex_lock(&mutex_);
+    }
+    bool reserved = reserved_ < depth_;
+    if (reserved)
+      reserved_++;
+    pthread_mutex_unlock(&mutex_);
+    return reserved;
+  }
+
+  // Moves the requests that completed to '*done'. Requires 'mutex_'.
+  void Reap(vector<Request>* done) {
+    for (size_t i = 0; i < in_flight_.size();) {
+      aiocb* control_block = in_flight_[i].control_block;
+      int error = aio_error(control_block);
+      if (error == EINPROGRESS) {
+        i++;
+        continue;
+      }
+      if (aio_return(control_block) != page_size_)
+        PageIoFailed(error);
+      done->push_back(in_flight_[i].request);
+      delete control_block;
+      in_flight_[i] = in_flight_.back();
+      in_flight_.pop_back();
+      reserved_--;
+    }
+  }
+
+  int fd_;
+  int page_size_;
+  int depth_;
+
+  // Guards all of the following.
+  pthread_mutex_t mutex_;
+  vector<InFlight> in_flight_;
+  int reserved_;
+  // Completions collected by Reserve() for the next Poll().
+  vector<Request> completed_;
+};
+
+class UringPageIo : public PageIo {
+ public:
+  UringPageIo(int fd, int page_size)
+      : fd_(fd), page_size_(page_size), ring_fd_(-1), sq_ring_(MAP_FAILED),
+        cq_ring_(MAP_FAILED), sqes_(MAP_FAILED), buffers_(NULL) {
+    pthread_mutex_init(&mutex_, NULL);
+  }
+
+  virtual ~UringPageIo() {
+    if (sqes_ != MAP_FAILED)
+      munmap(sqes_, sqes_size_);
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+      munmap(cq_ring_, cq_ring_size_);
+    if (sq_ring_ != MAP_FAILED)
+      munmap(sq_ring_, sq_ring_size_);
+    if (ring_fd_ >= 0)
+      close(ring_fd_);
+    free(buffers_);
+    pthread_mutex_destroy(&mutex_);
+  }
+
+  // Sets up a ring of 'depth' entries and registers the data file and one
+  // page buffer per entry with it. Returns false if that fails.
+  bool Init(int depth) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = syscall(__NR_io_uring_setup, depth, &params);
+    if (ring_fd_ < 0)
+      return false;
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32);
+    cq_ring_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      if (cq_ring_size_ > sq_ring_size_)
+        sq_ring_size_ = cq_ring_size_;
+      cq_ring_size_ = sq_ring_size_;
+    }
+    sq_ring_ = mmap(NULL, sq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED)
+      return false;
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      cq_ring_ = sq_ring_;
+    } else {
+      cq_ring_ = mmap(NULL, cq_ring_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+      if (cq_ring_ == MAP_FAILED)
+        return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED)
+      return false;
+
+    char* sq = reinterpret_cast<char*>(sq_ring_);
+    sq_tail_ = reinterpret_cast<uint32*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<uint32*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<uint32*>(sq + params.sq_off.array);
+    char* cq = reinterpret_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<uint32*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<uint32*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<uint32*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // Every request goes through one of the registered buffers, so the
+    // kernel does not have to map user memory per request.
+    int slots = params.sq_entries;
+    if (posix_memalign(reinterpret_cast<void**>(&buffers_), 4096,
+                       static_cast<size_t>(slots) * page_size_) != 0) {
+      buffers_ = NULL;
+      return false;
+    }
+    struct iovec buffers = {buffers_, static_cast<size_t>(slots) * page_size_};
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS,
+                &buffers, 1) != 0)
+      return false;
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_FILES,
+                &fd_, 1) != 0)
+      return false;
+
+    slots_.resize(slots);
+    for (int i = slots - 1; i >= 0; i--)
+      free_slots_.push_back(i);
+    return true;
+  }
+
+  virtual void Submit(const vector<Request>& requests) {
+    pthread_mutex_lock(&mutex_);
+    uint32 tail = *sq_tail_;
+    uint32 queued = 0;
+    for (size_t i = 0; i < requests.size(); i++) {
+      if (free_slots_.empty()) {
+        // Start what is queued, then wait for a slot to free up. The caller
+        // may be the polling thread, so completions are collected here too.
+        Enter(&tail, &queued);
+        while (true) {
+          Reap(&completed_);
+          if (!free_slots_.empty())
+            break;
+          pthread_mutex_unlock(&mutex_);
+          Spin(0.00005);
+          pthread_mutex_lock(&mutex_);
+        }
+        tail = *sq_tail_;
+      }
+      int slot = free_slots_.back();
+      free_slots_.pop_back();
+      slots_[slot] = requests[i];
+      char* buffer = buffers_ + static_cast<size_t>(slot) * page_size_;
+      if (requests[i].op == WRITE)
+        memcpy(buffer, requests[i].page, page_size_);
+
+      io_uring_sqe* sqe =
+          reinterpret_cast<io_uring_sqe*>(sqes_) + (tail & sq_mask_);
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = (requests[i].op == READ) ? IORING_OP_READ_FIXED
+                                             : IORING_OP_WRITE_FIXED;
+      sqe->flags = IOSQE_FIXED_FILE;
+      sqe->fd = 0;
+      sqe->off = requests[i].offset;
+      sqe->addr = reinterpret_cast<uint64>(buffer);
+      sqe->len = page_size_;
+      sqe->buf_index = 0;
+      sqe->user_data = slot;
+      sq_array_[tail & sq_mask_] = tail & sq_mask_;
+      tail++;
+      queued++;
+    }
+    Enter(&tail, &queued);
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  virtual void Poll(vector<Request>* done) {
+    pthread_mutex_lock(&mutex_);
+    done->insert(done->end(), completed_.begin(), completed_.end());
+    completed_.clear();
+    Reap(done);
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  virtual string name() const { return "uring"; }
+
+ private:
+  // Publishes the 'queued' entries up to 'tail' and hands them to the kernel
+  // in one system call. Requires 'mutex_'.
+  void Enter(uint32* tail, uint32* queued) {
+    __atomic_store_n(sq_tail_, *tail, __ATOMIC_RELEASE);
+    while (*queued > 0) {
+      int submitted = syscall(__NR_io_uring_enter, ring_fd_, *queued, 0, 0,
+                              NULL, 0);
+      if (submitted < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+          continue;
+        PageIoFailed(errno);
+      }
+      *queued -= submitted;
+    }
+  }
+
+  // Moves the requests that completed to '*done'. Requires 'mutex_'.
+  void Reap(vector<Request>* done) {
+    uint32 head = *cq_head_;
+    uint32 tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      int slot = cqe.user_data;
+      if (cqe.res != page_size_)
+        PageIoFailed(cqe.res < 0 ? -cqe.res : EIO);
+      Request& request = slots_[slot];
+      if (request.op == READ) {
+        memcpy(request.page,
+               buffers_ + static_cast<size_t>(slot) * page_size_,
+               page_size_);
+      }
+      done->push_back(request);
+      free_slots_.push_back(slot);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+
+  int fd_;
+  int page_size_;
+  int ring_fd_;
+
+  void* sq_ring_;
+  size_t sq_ring_size_;
+  void* cq_ring_;
+  size_t cq_ring_size_;
+  void* sqes_;
+  size_t sqes_size_;
+
+  uint32* sq_tail_;
+  uint32 sq_mask_;
+  uint32* sq_array_;
+  uint32* cq_head_;
+  uint32* cq_tail_;
+  uint32 cq_mask_;
+  io_uring_cqe* cqes_;
+
+  // One registered page buffer per ring entry.
+  char* buffers_;
+
+  // Guards all of the following and the submission and completion rings.
+  pthread_mutex_t mutex_;
+  // The request using each buffer.
+  vector<Request> slots_;
+  vector<int> free_slots_;
+  // Completions collected by Submit() for the next Poll().
+  vector<Request> completed_;
+};
+
+}  // namespace
+
+PageIo* PageIo::Create(const string& backend, int fd, int page_size,
+                       int depth) {
+  if (backend == "aio")
+    return new AioPageIo(fd, page_size, depth);
+  if (backend == "uring") {
+    UringPageIo* page_io = new UringPageIo(fd, page_size);
+    if (page_io->Init(depth))
+      return page_io;
+    delete page_io;
+  }
+  return NULL;
+}
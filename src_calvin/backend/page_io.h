@@ -0,0 +1,56 @@
+// Asynchronous reads and writes of whole pages of a data file, as used by
+// FetchingStorage's buffer pool. Two backends are available:
+//
+//   aio     POSIX AIO; a batch is started with one lio_listio() call
+//   uring   io_uring with the data file and the I/O buffers registered with
+//           the kernel; a batch is started with one io_uring_enter() call
+//
+// Requests are submitted in batches from any thread and completions are
+// collected by polling from a single thread.
+
+#ifndef _DB_BACKEND_PAGE_IO_H_
+#define _DB_BACKEND_PAGE_IO_H_
+
+#include <string>
+#include <vector>
+
+#include "common/types.h"
+
+using std::string;
+using std::vector;
+
+class PageIo {
+ public:
+  enum Operation { READ, WRITE };
+
+  struct Request {
+    Operation op;
+    int64 offset;
+    // Buffer of one page to read into or write from. Must stay valid until
+    // the request completes.
+    char* page;
+    // Identifies the request to the caller.
+    void* tag;
+  };
+
+  virtual ~PageIo() {}
+
+  // Starts all of 'requests'. Blocks while the backend has too many requests
+  // in flight to take more.
+  virtual void Submit(const vector<Request>& requests) = 0;
+
+  // Appends the requests that completed since the last call to '*done'
+  // without waiting. Must only be called by one thread at a time.
+  virtual void Poll(vector<Request>* done) = 0;
+
+  // Returns the backend's name.
+  virtual string name() const = 0;
+
+  // Creates the backend named 'backend' over pages of 'page_size' bytes of
+  // the file open as 'fd', with up to 'depth' requests in flight. Returns
+  // NULL if there is no such backend or the system does not support it.
+  static PageIo* Create(const string& backend, int fd, int page_size,
+                        int depth);
+};
+
+#endif  // _DB_BACKEND_PAGE_IO_H_
@@ -13,18 +13,64 @@ Value* SimpleStorage::ReadObject(const Key& key, int64 txn_id) {
   }
 }
 
+bool SimpleStorage::CopyObject(const Key& key, Value* value) {
+  pthread_mutex_lock(&mutex_);
+  unordered_map<Key, Value*>::const_iterator it = objects_.find(key);
+  bool found = it != objects_.end() && it->second != NULL;
+  if (found)
+    *value = *it->second;
+  pthread_mutex_unlock(&mutex_);
+  return found;
+}
+
 bool SimpleStorage::PutObject(const Key& key, Value* value, int64 txn_id) {
   pthread_mutex_lock(&mutex_);
-  objects_[key] = value;
+  Value*& object = objects_[key];
+  if (object != value)
+    delete object;
+  object = value;
+  pthread_mutex_unlock(&mutex_);
+  return true;
+}
+
+bool SimpleStorage::PutObjects(const vector<pair<Key, Value*> >& objects) {
+  pthread_mutex_lock(&mutex_);
+  for (size_t i = 0; i < objects.size(); i++) {
+    Value*& object = objects_[objects[i].first];
+    if (object != objects[i].second)
+      delete object;
+    object = objects[i].second;
+  }
   pthread_mutex_unlock(&mutex_);
   return true;
 }
 
 bool SimpleStorage::DeleteObject(const Key& key, int64 txn_id) {
-  objects_.erase(key);
+  pthread_mutex_lock(&mutex_);
+  unordered_map<Key, Value*>::iterator it = objects_.find(key);
+  if (it != objects_.end()) {
+    delete it->second;
+    objects_.erase(it);
+  }
+  pthread_mutex_unlock(&mutex_);
   return true;
 }
 
+bool SimpleStorage::ListKeys(vector<Key>* keys) {
+  pthread_mutex_lock(&mutex_);
+  for (unordered_map<Key, Value*>::const_iterator it = objects_.begin();
+       it != objects_.end(); ++it)
+    keys->push_back(it->first);
+  pthread_mutex_unlock(&mutex_);
+  return true;
+}
+
+void SimpleStorage::Reserve(int64 objects) {
+  pthread_mutex_lock(&mutex_);
+  objects_.rehash(objects_.size() + objects);
+  pthread_mutex_unlock(&mutex_);
+}
+
 void SimpleStorage::Initmutex() {
   pthread_mutex_init(&mutex_, NULL);
 }
@@ -22,8 +22,12 @@ class SimpleStorage : public Storage {
   virtual bool Prefetch(const Key& key, double* wait_time) { return false; }
   virtual bool Unfetch(const Key& key) { return false; }
   virtual Value* ReadObject(const Key& key, int64 txn_id = 0);
+  virtual bool CopyObject(const Key& key, Value* value);
   virtual bool PutObject(const Key& key, Value* value, int64 txn_id = 0);
+  virtual bool PutObjects(const vector<pair<Key, Value*> >& objects);
   virtual bool DeleteObject(const Key& key, int64 txn_id = 0);
+  virtual bool ListKeys(vector<Key>* keys);
+  virtual void Reserve(int64 objects);
 
   virtual void PrepareForCheckpoint(int64 stable) {}
   virtual int Checkpoint() { return 0; }
@@ -7,10 +7,12 @@
 #ifndef _DB_BACKEND_STORAGE_H_
 #define _DB_BACKEND_STORAGE_H_
 
+#include <utility>
 #include <vector>
 
 #include "common/types.h"
 
+using std::pair;
 using std::vector;
 
 class Storage {
@@ -25,23 +27,64 @@ class Storage {
   // otherwise.
   virtual bool Unfetch(const Key& key) = 0;
 
+  // Returns the expected time until the object specified by 'key', pinned by
+  // Prefetch(), is in memory, or 0 if it already is.
+  virtual double FetchWait(const Key& key) { return 0; }
+
+  // Starts loading everything Prefetch() asked for since the last call.
+  // Storages that issue their reads one by one ignore this.
+  virtual void SubmitPrefetches() {}
+
   // If the object specified by 'key' exists, copies the object into '*result'
   // and returns true. If the object does not exist, false is returned.
   virtual Value* ReadObject(const Key& key, int64 txn_id = 0) = 0;
 
+  // Copies the newest version of the object specified by 'key' into '*value'
+  // and returns true, or returns false if there is none. Unlike ReadObject(),
+  // this is safe outside of txns while they run, e.g. for the reconnaissance
+  // reads of clients: the copy is made under the storage's locks, so the
+  // object cannot be freed meanwhile.
+  virtual bool CopyObject(const Key& key, Value* value) = 0;
+
   // Sets the object specified by 'key' equal to 'value'. Any previous version
   // of the object is replaced. Returns true if the write succeeds, or false if
-  // it fails for any reason.
+  // it fails for any reason. The storage takes over 'value' and frees the
+  // value it replaces once no txn or snapshot can read it.
   virtual bool PutObject(const Key& key, Value* value, int64 txn_id = 0) = 0;
 
+  // Writes all of 'objects' as PutObject() would. Storages with a global
+  // lock override this to take it once per call rather than once per object.
+  virtual bool PutObjects(const vector<pair<Key, Value*> >& objects) {
+    bool ok = true;
+    for (size_t i = 0; i < objects.size(); i++)
+      ok = PutObject(objects[i].first, objects[i].second) && ok;
+    return ok;
+  }
+
   // Removes the object specified by 'key' if there is one. Returns true if the
   // deletion succeeds (or if no object is found with the specified key), or
-  // false if it fails for any reason.
+  // false if it fails for any reason. The storage owns the object's value: it
+  // frees it once no txn or snapshot can read it any more, so callers must not
+  // delete a value they read after deleting its object.
   virtual bool DeleteObject(const Key& key, int64 txn_id = 0) = 0;
 
+  // Appends the keys of all objects stored here to '*keys'. Returns false if
+  // the storage cannot enumerate its objects.
+  virtual bool ListKeys(vector<Key>* keys) { return false; }
+
+  // Prepares for about 'objects' more objects to be stored, so that bulk
+  // loads do not repeatedly grow the storage's tables.
+  virtual void Reserve(int64 objects) {}
+
+  // Called once every txn up to 'txn_id' has completed, at the end of each
+  // batch. Multi-version storages collect the versions only older txns could
+  // see.
+  virtual void AdvanceWatermark(int64 txn_id) {}
+
   // TODO(Thad): Something here
   virtual void PrepareForCheckpoint(int64 stable) {}
   virtual int Checkpoint() { return 0; }
+  virtual bool Checkpointing() { return false; }
   virtual void Initmutex() {}
 };
 
@@ -12,14 +12,37 @@
 #include "proto/txn.pb.h"
 #include "proto/message.pb.h"
 
+StorageManager::StorageManager(Configuration* config,
+                               Connection* connection,
+                               Storage* actual_storage)
+    : writer(false),
+      configuration_(config),
+      connection_(connection),
+      actual_storage_(actual_storage),
+      txn_(NULL),
+      objects_read_(0),
+      next_read_(0),
+      remote_reads_used_(0) {}
+
 StorageManager::StorageManager(Configuration* config,
                                Connection* connection,
                                Storage* actual_storage,
                                TxnProto* txn)
-    : configuration_(config),
+    : writer(false),
+      configuration_(config),
       connection_(connection),
       actual_storage_(actual_storage),
-      txn_(txn) {
+      txn_(NULL),
+      objects_read_(0),
+      next_read_(0),
+      remote_reads_used_(0) {
+  Setup(txn);
+}
+
+void StorageManager::Setup(TxnProto* txn) {
+  txn_ = txn;
+  objects_.assign(txn->read_set_size() + txn->read_write_set_size(), NULL);
+
   MessageProto message;
 
   // If reads are performed at this node, execute local reads and broadcast
@@ -35,22 +58,13 @@ StorageManager::StorageManager(Configuration* config,
     message.set_type(MessageProto::READ_RESULT);
 
     // Execute local reads.
-    for (int i = 0; i < txn->read_set_size(); i++) {
-      const Key& key = txn->read_set(i);
-      if (configuration_->LookupPartition(key) ==
-          configuration_->this_node_id) {
-        Value* val = actual_storage_->ReadObject(key);
-        objects_[key] = val;
-        message.add_keys(key);
-        message.add_values(val == NULL ? "" : *val);
-      }
-    }
-    for (int i = 0; i < txn->read_write_set_size(); i++) {
-      const Key& key = txn->read_write_set(i);
+    for (int i = 0; i < static_cast<int>(objects_.size()); i++) {
+      const Key& key = KeyAt(i);
       if (configuration_->LookupPartition(key) ==
           configuration_->this_node_id) {
-        Value* val = actual_storage_->ReadObject(key);
-        objects_[key] = val;
+        Value* val = actual_storage_->ReadObject(key, txn->txn_id());
+        objects_[i] = val;
+        objects_read_++;
         message.add_keys(key);
         message.add_values(val == NULL ? "" : *val);
       }
@@ -75,18 +89,85 @@ StorageManager::StorageManager(Configuration* config,
   // Scheduler is responsible for calling HandleReadResponse. We're done here.
 }
 
+void StorageManager::Reset() {
+  txn_ = NULL;
+  writer = false;
+  objects_read_ = 0;
+  next_read_ = 0;
+  remote_reads_used_ = 0;
+}
+
+const Key& StorageManager::KeyAt(int index) const {
+  if (index < txn_->read_set_size())
+    return txn_->read_set(index);
+  return txn_->read_write_set(index - txn_->read_set_size());
+}
+
+int StorageManager::IndexOf(const Key& key) {
+  int size = objects_.size();
+
+  // Applications normally pass the very key stored in the txn and read in
+  // read set order, so try the expected position by address first.
+  if (next_read_ < size && &KeyAt(next_read_) == &key)
+    return next_read_++;
+  for (int i = 0; i < size; i++) {
+    if (&KeyAt(i) == &key) {
+      next_read_ = i + 1;
+      return i;
+    }
+  }
+  for (int i = 0; i < size; i++) {
+    if (KeyAt(i) == key) {
+      next_read_ = i + 1;
+      return i;
+    }
+  }
+  return -1;
+}
+
 void StorageManager::HandleReadResult(const MessageProto& message) {
   assert(message.type() == MessageProto::READ_RESULT);
+
+  // The sender walked the txn's read set in the same order we index it, so
+  // matching keys can be found by scanning forward. A key that is not found
+  // means the sender partitioned the txn's keys differently, e.g. under
+  // another partition map across a migration.
+  int size = objects_.size();
+  int index = 0;
   for (int i = 0; i < message.keys_size(); i++) {
-    Value* val = new Value(message.values(i));
-    objects_[message.keys(i)] = val;
-    remote_reads_.push_back(val);
+    while (index < size && KeyAt(index) != message.keys(i))
+      index++;
+    assert(index < size);
+
+    if (remote_reads_used_ == static_cast<int>(remote_reads_.size()))
+      remote_reads_.push_back(new Value());
+    Value* val = remote_reads_[remote_reads_used_++];
+    val->assign(message.values(i));
+    objects_[index++] = val;
+    objects_read_++;
   }
 }
 
+bool StorageManager::Executes() const {
+  return writer || txn_->writers_size() == 0;
+}
+
 bool StorageManager::ReadyToExecute() {
-  return static_cast<int>(objects_.size()) ==
-         txn_->read_set_size() + txn_->read_write_set_size();
+  return objects_read_ == static_cast<int>(objects_.size());
+}
+
+void StorageManager::PrefetchObjects() {
+  for (size_t i = 0; i < objects_.size(); i++) {
+    if (objects_[i] != NULL)
+      __builtin_prefetch(objects_[i]);
+  }
+}
+
+void StorageManager::PrefetchValues() {
+  for (size_t i = 0; i < objects_.size(); i++) {
+    if (objects_[i] != NULL)
+      __builtin_prefetch(objects_[i]->data());
+  }
 }
 
 StorageManager::~StorageManager() {
@@ -97,7 +178,8 @@ StorageManager::~StorageManager() {
 }
 
 Value* StorageManager::ReadObject(const Key& key) {
-  return objects_[key];
+  int index = IndexOf(key);
+  return index == -1 ? NULL : objects_[index];
 }
 
 bool StorageManager::PutObject(const Key& key, Value* value) {
@@ -115,3 +197,35 @@ bool StorageManager::DeleteObject(const Key& key) {
   else
     return true;  // Not this node's problem.
 }
+
+StorageManagerPool::StorageManagerPool(Configuration* config,
+                                       Connection* connection,
+                                       Storage* actual_storage)
+    : configuration_(config),
+      connection_(connection),
+      actual_storage_(actual_storage) {}
+
+StorageManagerPool::~StorageManagerPool() {
+  for (vector<StorageManager*>::iterator it = free_managers_.begin();
+       it != free_managers_.end(); ++it) {
+    delete *it;
+  }
+}
+
+StorageManager* StorageManagerPool::Get(TxnProto* txn) {
+  StorageManager* manager;
+  if (free_managers_.empty()) {
+    manager =
+        new StorageManager(configuration_, connection_, actual_storage_);
+  } else {
+    manager = free_managers_.back();
+    free_managers_.pop_back();
+  }
+  manager->Setup(txn);
+  return manager;
+}
+
+void StorageManagerPool::Release(StorageManager* manager) {
+  manager->Reset();
+  free_managers_.push_back(manager);
+}
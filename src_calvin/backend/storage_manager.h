@@ -8,8 +8,9 @@
 // to partitioning at all.
 //
 // StorageManager use:
-//  - Each transaction execution creates a new StorageManager and deletes it
-//    upon completion.
+//  - Each transaction execution sets up a StorageManager for the txn and
+//    releases it upon completion. Workers recycle their managers through a
+//    StorageManagerPool so that buffers are allocated once, not once per txn.
 //  - No ReadObject call takes as an argument any value that depends on the
 //    result of a previous ReadObject call.
 //  - In any transaction execution, a call to DoneReading must follow ALL calls
@@ -22,13 +23,11 @@
 
 #include <ucontext.h>
 
-#include <tr1/unordered_map>
 #include <vector>
 
 #include "common/types.h"
 
 using std::vector;
-using std::tr1::unordered_map;
 
 class Configuration;
 class Connection;
@@ -39,7 +38,13 @@ class TxnProto;
 
 class StorageManager {
  public:
-  // TODO(alex): Document this class correctly.
+  // Creates a manager that is not bound to any txn yet. Setup() must be called
+  // before it is used.
+  StorageManager(Configuration* config,
+                 Connection* connection,
+                 Storage* actual_storage);
+
+  // Creates a manager and sets it up for 'txn'.
   StorageManager(Configuration* config,
                  Connection* connection,
                  Storage* actual_storage,
@@ -47,6 +52,14 @@ class StorageManager {
 
   ~StorageManager();
 
+  // Binds the manager to 'txn': executes the txn's local reads and, if this
+  // node is a reader, broadcasts their results to all (other) writers.
+  void Setup(TxnProto* txn);
+
+  // Unbinds the manager from its txn so it can be set up for another one.
+  // Buffers (including the copies of remote values) are kept for reuse.
+  void Reset();
+
   Value* ReadObject(const Key& key);
   bool PutObject(const Key& key, Value* value);
   bool DeleteObject(const Key& key);
@@ -54,14 +67,35 @@ class StorageManager {
   void HandleReadResult(const MessageProto& message);
   bool ReadyToExecute();
 
+  // Issues CPU prefetches for every object read so far, so that a worker can
+  // set up several txns and have their data on its way into cache before it
+  // starts executing the first one.
+  void PrefetchObjects();
+
+  // Issues CPU prefetches for the data of every object read so far. Finding
+  // the data reads the objects, so this is only worth calling some time after
+  // PrefetchObjects(), once they have arrived.
+  void PrefetchValues();
+
   Storage* GetStorage() { return actual_storage_; }
 
-  // Set by the constructor, indicating whether 'txn' involves any writes at
-  // this node.
+  // Set by Setup(), indicating whether 'txn' involves any writes at this node.
   bool writer;
 
+  // Returns true if the txn is to be executed at this node: if it writes
+  // here, or if it writes nowhere, as read-only txns are executed by their
+  // readers. Nodes that only supply reads to the writers do not execute it.
+  bool Executes() const;
+
   // private:
-  friend class DeterministicScheduler;
+  friend class LockingScheduler;
+
+  // Returns the key at position 'index' of the txn's combined read set:
+  // read_set entries first, followed by read_write_set entries.
+  const Key& KeyAt(int index) const;
+
+  // Returns the position of 'key' in the combined read set, or -1.
+  int IndexOf(const Key& key);
 
   // Pointer to the configuration object for this node.
   Configuration* configuration_;
@@ -75,13 +109,42 @@ class StorageManager {
   // Transaction that corresponds to this instance of a StorageManager.
   TxnProto* txn_;
 
-  // Local copy of all data objects read/written by 'txn_', populated at
-  // StorageManager construction time.
-  //
-  // TODO(alex): Should these be pointers to reduce object copying overhead?
-  unordered_map<Key, Value*> objects_;
+  // All data objects read by 'txn_', indexed by position in the combined read
+  // set (see KeyAt). Filled in by Setup() for local keys and by
+  // HandleReadResult() for remote ones.
+  vector<Value*> objects_;
+  int objects_read_;
+
+  // Position just after the previous ReadObject hit. Applications read their
+  // objects in read set order, so this usually finds the next key directly.
+  int next_read_;
 
+  // Copies of remote values. Entries up to 'remote_reads_used_' belong to the
+  // current txn; the rest are left over from earlier ones and are reused.
   vector<Value*> remote_reads_;
+  int remote_reads_used_;
+};
+
+// A per-worker free list of StorageManagers.
+class StorageManagerPool {
+ public:
+  StorageManagerPool(Configuration* config,
+                     Connection* connection,
+                     Storage* actual_storage);
+  ~StorageManagerPool();
+
+  // Returns a manager that has been set up for 'txn'.
+  StorageManager* Get(TxnProto* txn);
+
+  // Takes back a manager whose txn has finished executing.
+  void Release(StorageManager* manager);
+
+ private:
+  Configuration* configuration_;
+  Connection* connection_;
+  Storage* actual_storage_;
+
+  vector<StorageManager*> free_managers_;
 };
 
 #endif  // _DB_BACKEND_STORAGE_MANAGER_H_
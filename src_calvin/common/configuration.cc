@@ -13,22 +13,76 @@
 #include <cstring>
 #include <string>
 
+#include "common/definitions.hh"
 #include "common/utils.h"
 
 using std::string;
 
 Configuration::Configuration(int node_id, const string& filename)
-    : this_node_id(node_id) {
+    : this_node_id(node_id),
+      partition_map_(NULL),
+      migrations_known_through_(-1) {
+  pthread_mutex_init(&partition_mutex_, NULL);
   if (ReadFromFile(filename))  // Reading from file failed.
     exit(0);
 }
 
-// TODO(alex): Implement better (application-specific?) partitioning.
-int Configuration::LookupPartition(const Key& key) const {
-  if (key.find("w") == 0)  // TPCC
-    return OffsetStringToInt(key, 1) % static_cast<int>(all_nodes.size());
-  else
-    return StringToInt(key) % static_cast<int>(all_nodes.size());
+Configuration::~Configuration() {
+  for (map<int64, PartitionMap*>::iterator it = partition_maps_.begin();
+       it != partition_maps_.end(); ++it)
+    delete it->second;
+  for (size_t i = 0; i < partitioners_.size(); i++)
+    delete partitioners_[i];
+}
+
+const PartitionMap* Configuration::PartitionMapAt(int64 batch) {
+  pthread_mutex_lock(&partition_mutex_);
+  map<int64, PartitionMap*>::iterator it = partition_maps_.upper_bound(batch);
+  --it;
+  const PartitionMap* partition_map = it->second;
+  pthread_mutex_unlock(&partition_mutex_);
+  return partition_map;
+}
+
+void Configuration::AddMigration(int64 batch, char table, int64 lo, int64 hi,
+                                 int node) {
+  pthread_mutex_lock(&partition_mutex_);
+  map<int64, PartitionMap*>::iterator it = partition_maps_.upper_bound(batch);
+  assert(it == partition_maps_.end());
+  --it;
+  PartitionMap* partition_map = new PartitionMap(*it->second);
+  Partitioner* partitioner =
+      new MigratedPartitioner(partition_map->partitioner(table), lo, hi, node);
+  partitioners_.push_back(partitioner);
+  partition_map->set_partitioner(table, partitioner);
+  if (it->first == batch) {
+    // Another migration already starts at this batch: it has not been
+    // installed yet, so the new map simply replaces it.
+    assert(it->second != partition_map_);
+    delete it->second;
+  }
+  partition_maps_[batch] = partition_map;
+  pthread_mutex_unlock(&partition_mutex_);
+}
+
+const PartitionMap* Configuration::PendingPartitionMap(int64 batch) {
+  pthread_mutex_lock(&partition_mutex_);
+  const PartitionMap* partition_map = NULL;
+  map<int64, PartitionMap*>::iterator it = partition_maps_.find(batch);
+  if (it != partition_maps_.end() && it->second != partition_map_)
+    partition_map = it->second;
+  pthread_mutex_unlock(&partition_mutex_);
+  return partition_map;
+}
+
+int64 Configuration::migration_lead() const {
+  return static_cast<int64>(MIGRATION_LEAD_EPOCHS) * all_nodes.size();
+}
+
+void Configuration::InstallPartitionMap(int64 batch) {
+  pthread_mutex_lock(&partition_mutex_);
+  partition_map_ = partition_maps_[batch];
+  pthread_mutex_unlock(&partition_mutex_);
 }
 
 bool Configuration::WriteToFile(const string& filename) const {
@@ -41,6 +95,9 @@ bool Configuration::WriteToFile(const string& filename) const {
     fprintf(fp, "node%d=%d:%d:%d:%s:%d\n", it->first, node->replica_id,
             node->partition_id, node->cores, node->host.c_str(), node->port);
   }
+  for (map<string, string>::const_iterator it = partition_specs_.begin();
+       it != partition_specs_.end(); ++it)
+    fprintf(fp, "partition.%s=%s\n", it->first.c_str(), it->second.c_str());
   fclose(fp);
   return true;
 }
@@ -68,11 +125,42 @@ int Configuration::ReadFromFile(const string& filename) {
     ProcessConfigLine(key, value);
   }
   fclose(fp);
+  return BuildPartitioners();
+}
+
+int Configuration::BuildPartitioners() {
+  int num_nodes = all_nodes.size();
+  Partitioner* default_partitioner = new HashPartitioner(num_nodes);
+  partitioners_.push_back(default_partitioner);
+  PartitionMap* partition_map = new PartitionMap(default_partitioner);
+  partition_maps_[0] = partition_map;
+  partition_map_ = partition_map;
+
+  for (map<string, string>::const_iterator it = partition_specs_.begin();
+       it != partition_specs_.end(); ++it) {
+    Partitioner* partitioner = Partitioner::Create(it->second, num_nodes);
+    if (partitioner == NULL) {
+      printf("Invalid partitioning for table %s: %s\n", it->first.c_str(),
+             it->second.c_str());
+      return -1;
+    }
+    partitioners_.push_back(partitioner);
+    if (it->first == "default") {
+      partition_map->set_partitioner('\0', partitioner);
+    } else if (it->first.size() == 1 && !isdigit(it->first[0])) {
+      partition_map->set_partitioner(it->first[0], partitioner);
+    } else {
+      printf("Invalid table name in config file: %s\n", it->first.c_str());
+      return -1;
+    }
+  }
   return 0;
 }
 
 void Configuration::ProcessConfigLine(char key[], char value[]) {
-  if (strncmp(key, "node", 4) != 0) {
+  if (strncmp(key, "partition.", 10) == 0) {
+    partition_specs_[key + 10] = (value == NULL) ? "" : value;
+  } else if (strncmp(key, "node", 4) != 0) {
 #if VERBOSE
     printf("Unknown key in config file: %s\n", key);
 #endif
@@ -12,6 +12,12 @@
 //  # Node<id>=<replica>:<partition>:<cores>:<host>:<port>
 //  node13=1:3:16:4.8.15.16:1001:1002
 //  node23=2:3:16:4.8.15.16:1004:1005
+//  # Optionally choose how tables are partitioned (see common/partitioner.h).
+//  # A table is named by the first character of its keys; keys that start
+//  # with a digit belong to "default". Unlisted tables are hashed.
+//  # partition.<table>=hash|range:<lo>-<hi>@<node>,...|lookup:<id>@<node>,...
+//  partition.w=range:0-7@0,8-15@1
+//  partition.default=hash
 //
 // Note: Epoch duration, application and other global global options are
 //       specified as command line options at invocation time (see
@@ -28,6 +34,7 @@
 #include <tr1/unordered_map>
 #include <pthread.h>
 
+#include "common/partitioner.h"
 #include "common/types.h"
 
 using std::map;
@@ -35,19 +42,6 @@ using std::string;
 using std::vector;
 using std::tr1::unordered_map;
 
-extern map<Key, Key> latest_order_id_for_customer;
-extern map<Key, int> latest_order_id_for_district;
-extern map<Key, int> smallest_order_id_for_district;
-extern map<Key, Key> customer_for_order;
-extern unordered_map<Key, int> next_order_id_for_district;
-extern map<Key, int> item_for_order_line;
-extern map<Key, int> order_line_number;
-
-extern vector<Key>* involed_customers;
-
-extern pthread_mutex_t mutex_;
-extern pthread_mutex_t mutex_for_item;
-
 #define ORDER_LINE_NUMBER 10
 
 struct Node {
@@ -70,9 +64,46 @@ struct Node {
 class Configuration {
  public:
   Configuration(int node_id, const string& filename);
-
-  // Returns the node_id of the partition at which 'key' is stored.
-  int LookupPartition(const Key& key) const;
+  ~Configuration();
+
+  // Returns the node_id of the partition at which 'key' is stored under the
+  // partitioning currently installed at this node. The key's table is given
+  // by its first character unless that is a digit, and its id by the digits
+  // that follow (see common/partitioner.h).
+  int LookupPartition(const Key& key) const {
+    return partition_map_->Lookup(key);
+  }
+
+  // Returns the partitioning currently installed at this node.
+  const PartitionMap* partition_map() const { return partition_map_; }
+
+  // Returns the partitioning that applies to txns in batch 'batch'. This can
+  // differ from the installed one when the caller (i.e. the sequencer) runs
+  // ahead of this node's scheduler and a migration is pending.
+  const PartitionMap* PartitionMapAt(int64 batch);
+
+  // Moves ids [lo, hi] of 'table' ('\0' for the default table) to 'node',
+  // starting with batch 'batch'. Migrations must be added in batch order.
+  void AddMigration(int64 batch, char table, int64 lo, int64 hi, int node);
+
+  // Returns the partitioning that starts at batch 'batch' if it is not
+  // installed yet, or NULL if no migration takes effect at 'batch'.
+  const PartitionMap* PendingPartitionMap(int64 batch);
+
+  // Switches LookupPartition() to the partitioning that starts at 'batch'.
+  void InstallPartitionMap(int64 batch);
+
+  // Number of batches between the batch ordering a migration and the batch it
+  // takes effect at.
+  int64 migration_lead() const;
+
+  // Highest batch number such that all migrations ordered in it or earlier
+  // batches have been added. Sequencers may only pick the partitioning for
+  // a batch once its migrations are known.
+  int64 migrations_known_through() const { return migrations_known_through_; }
+  void set_migrations_known_through(int64 batch) {
+    migrations_known_through_ = batch;
+  }
 
   // Dump the current config into the file in key=value format.
   // Returns true when success.
@@ -88,6 +119,31 @@ class Configuration {
   // TODO(alex): Comments.
   void ProcessConfigLine(char key[], char value[]);
   int ReadFromFile(const string& filename);
+
+  // Builds the partitioners from 'partition_specs_' once all nodes are known.
+  // Returns -1 if a spec is invalid.
+  int BuildPartitioners();
+
+  // Partitioning scheme per table as given in the config file.
+  map<string, string> partition_specs_;
+
+  // All partitioners referenced by the partition maps.
+  vector<Partitioner*> partitioners_;
+
+  // Partitioning for each range of batches, keyed by the first batch it
+  // applies to. Maps are never freed while the node runs since sequencer and
+  // workers may still be using an old one. Guarded by 'partition_mutex_'.
+  map<int64, PartitionMap*> partition_maps_;
+  pthread_mutex_t partition_mutex_;
+
+  // Partitioning used by LookupPartition().
+  const PartitionMap* volatile partition_map_;
+
+  volatile int64 migrations_known_through_;
+
+  // Not copyable: the partitioners are owned.
+  Configuration(const Configuration&);
+  Configuration& operator=(const Configuration&);
 };
 
 #endif  // _DB_COMMON_CONFIGURATION_H_
@@ -0,0 +1,203 @@
+// Hash, range and directory-based partitioning schemes.
+
+#include "common/partitioner.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// Parses a comma-separated list of "<first>[-<last>]@<node>" entries, calling
+// 'add(first, last, node)' for each. Returns false on malformed input, a node
+// outside [0, num_nodes) or if 'add' rejects an entry.
+template <typename Add>
+bool ParseEntries(const char* p, bool ranges, int num_nodes, Add add) {
+  while (*p != '\0') {
+    char* end;
+    int64 first = strtoll(p, &end, 10);
+    if (end == p)
+      return false;
+    int64 last = first;
+    p = end;
+    if (ranges) {
+      if (*p != '-')
+        return false;
+      last = strtoll(++p, &end, 10);
+      if (end == p)
+        return false;
+      p = end;
+    }
+    if (*p != '@')
+      return false;
+    int node = strtol(++p, &end, 10);
+    if (end == p || node < 0 || node >= num_nodes)
+      return false;
+    if (!add(first, last, node))
+      return false;
+    p = end;
+    if (*p == ',')
+      p++;
+    else if (*p != '\0')
+      return false;
+  }
+  return true;
+}
+
+struct AddRange {
+  RangePartitioner* partitioner;
+  bool operator()(int64 lo, int64 hi, int node) {
+    return partitioner->AddRange(lo, hi, node);
+  }
+};
+
+struct AddEntry {
+  LookupTablePartitioner* partitioner;
+  bool operator()(int64 id, int64, int node) {
+    if (id < 0)
+      return false;
+    partitioner->Assign(id, node);
+    return true;
+  }
+};
+
+}  // namespace
+
+Partitioner* Partitioner::Create(const string& spec, int num_nodes) {
+  if (num_nodes <= 0)
+    return NULL;
+
+  if (spec == "hash")
+    return new HashPartitioner(num_nodes);
+
+  if (spec.compare(0, 6, "range:") == 0) {
+    RangePartitioner* partitioner = new RangePartitioner(num_nodes);
+    AddRange add = {partitioner};
+    if (ParseEntries(spec.c_str() + 6, true, num_nodes, add))
+      return partitioner;
+    delete partitioner;
+    return NULL;
+  }
+
+  if (spec.compare(0, 7, "lookup:") == 0) {
+    LookupTablePartitioner* partitioner = new LookupTablePartitioner(num_nodes);
+    AddEntry add = {partitioner};
+    if (ParseEntries(spec.c_str() + 7, false, num_nodes, add))
+      return partitioner;
+    delete partitioner;
+    return NULL;
+  }
+
+  return NULL;
+}
+
+bool RangePartitioner::AddRange(int64 lo, int64 hi, int node) {
+  if (lo > hi)
+    return false;
+  Range range = {lo, hi, node};
+  vector<Range>::iterator it = ranges_.begin();
+  while (it != ranges_.end() && it->lo < lo)
+    ++it;
+  if ((it != ranges_.end() && it->lo <= hi) ||
+      (it != ranges_.begin() && (it - 1)->hi >= lo))
+    return false;
+  ranges_.insert(it, range);
+  return true;
+}
+
+int RangePartitioner::Find(int64 id) const {
+  // Find the last range starting at or below 'id'.
+  int low = 0;
+  int high = ranges_.size();
+  while (low < high) {
+    int mid = (low + high) / 2;
+    if (ranges_[mid].lo <= id)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  if (low > 0 && id <= ranges_[low - 1].hi)
+    return ranges_[low - 1].node;
+  return -1;
+}
+
+string RangePartitioner::ToString() const {
+  string spec("range:");
+  char buffer[64];
+  for (size_t i = 0; i < ranges_.size(); i++) {
+    snprintf(buffer, sizeof(buffer), "%s%ld-%ld@%d", i == 0 ? "" : ",",
+             static_cast<long>(ranges_[i].lo),
+             static_cast<long>(ranges_[i].hi), ranges_[i].node);
+    spec.append(buffer);
+  }
+  return spec;
+}
+
+void LookupTablePartitioner::Assign(int64 id, int node) {
+  if (id >= static_cast<int64>(directory_.size()))
+    directory_.resize(id + 1, -1);
+  directory_[id] = node;
+}
+
+string LookupTablePartitioner::ToString() const {
+  string spec("lookup:");
+  char buffer[64];
+  bool first = true;
+  for (size_t id = 0; id < directory_.size(); id++) {
+    if (directory_[id] < 0)
+      continue;
+    snprintf(buffer, sizeof(buffer), "%s%ld@%d", first ? "" : ",",
+             static_cast<long>(id), directory_[id]);
+    spec.append(buffer);
+    first = false;
+  }
+  return spec;
+}
+
+string MigratedPartitioner::ToString() const {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), ";move:%ld-%ld@%d", static_cast<long>(lo_),
+           static_cast<long>(hi_), node_);
+  return base_->ToString() + buffer;
+}
+
+PartitionMap::PartitionMap(const Partitioner* default_partitioner)
+    : default_(default_partitioner) {
+  for (int i = 0; i < 256; i++)
+    partitioners_[i] = NULL;
+}
+
+bool PartitionMap::ParseMigration(const string& spec, char* table, int64* lo,
+                                  int64* hi, int* node) {
+  size_t colon = spec.find(':');
+  if (colon == string::npos)
+    return false;
+  string name = spec.substr(0, colon);
+  if (name == "default")
+    *table = '\0';
+  else if (name.size() == 1 && (name[0] < '0' || name[0] > '9'))
+    *table = name[0];
+  else
+    return false;
+
+  const char* p = spec.c_str() + colon + 1;
+  char* end;
+  *lo = strtoll(p, &end, 10);
+  if (end == p || *end != '-')
+    return false;
+  p = end + 1;
+  *hi = strtoll(p, &end, 10);
+  if (end == p || *end != '@' || *hi < *lo)
+    return false;
+  p = end + 1;
+  *node = strtol(p, &end, 10);
+  return end != p && *end == '\0';
+}
+
+string PartitionMap::FormatMigration(char table, int64 lo, int64 hi,
+                                     int node) {
+  string name = (table == '\0') ? string("default") : string(1, table);
+  char buffer[96];
+  snprintf(buffer, sizeof(buffer), "%s:%ld-%ld@%d", name.c_str(),
+           static_cast<long>(lo), static_cast<long>(hi), node);
+  return string(buffer);
+}
@@ -0,0 +1,183 @@
+// A Partitioner maps the numeric id of a record (e.g. the warehouse number of
+// a TPC-C key, or the integer key of the microbenchmark) to the node that
+// stores it. Each table in the config file can pick its own scheme:
+//
+//   hash                          id % num_nodes
+//   range:<lo>-<hi>@<node>,...    ids in [lo, hi] go to <node>; listing
+//                                 several ranges on one node co-locates them
+//   lookup:<id>@<node>,...        explicit directory of ids
+//
+// Ids not covered by a range or directory entry fall back to hashing. All
+// schemes are precomputed when the config is loaded so that Lookup() does no
+// parsing and no allocation.
+//
+// A PartitionMap combines one partitioner per table into the full key-to-node
+// mapping. Maps are immutable; repartitioning derives a new map in which a
+// range of one table's ids is moved to another node (see
+// scheduler/partition_migrator.h).
+
+#ifndef _DB_COMMON_PARTITIONER_H_
+#define _DB_COMMON_PARTITIONER_H_
+
+#include <string>
+#include <vector>
+
+#include "common/types.h"
+
+using std::string;
+using std::vector;
+
+class Partitioner {
+ public:
+  virtual ~Partitioner() {}
+
+  // Returns the node_id of the node storing the record with id 'id'.
+  virtual int Lookup(int64 id) const = 0;
+
+  // Returns the spec string this partitioner was built from.
+  virtual string ToString() const = 0;
+
+  // Builds a partitioner over 'num_nodes' nodes from a spec string in one of
+  // the formats above. Returns NULL if 'spec' is malformed or names a node
+  // outside [0, num_nodes).
+  static Partitioner* Create(const string& spec, int num_nodes);
+};
+
+class HashPartitioner : public Partitioner {
+ public:
+  explicit HashPartitioner(int num_nodes) : num_nodes_(num_nodes) {}
+  virtual int Lookup(int64 id) const {
+    return static_cast<int>(id % num_nodes_);
+  }
+  virtual string ToString() const { return "hash"; }
+
+ private:
+  int num_nodes_;
+};
+
+class RangePartitioner : public Partitioner {
+ public:
+  explicit RangePartitioner(int num_nodes) : fallback_(num_nodes) {}
+
+  // Assigns ids in [lo, hi] to 'node'. Returns false if the range is empty or
+  // overlaps one added before.
+  bool AddRange(int64 lo, int64 hi, int node);
+
+  // Returns the node of the range containing 'id', or -1 if there is none.
+  int Find(int64 id) const;
+
+  virtual int Lookup(int64 id) const {
+    int node = Find(id);
+    return (node >= 0) ? node : fallback_.Lookup(id);
+  }
+  virtual string ToString() const;
+
+ private:
+  struct Range {
+    int64 lo;
+    int64 hi;
+    int node;
+  };
+
+  // Disjoint ranges sorted by 'lo', binary searched by Lookup().
+  vector<Range> ranges_;
+  HashPartitioner fallback_;
+};
+
+class LookupTablePartitioner : public Partitioner {
+ public:
+  explicit LookupTablePartitioner(int num_nodes) : fallback_(num_nodes) {}
+
+  // Places the record with id 'id' (>= 0) on 'node'.
+  void Assign(int64 id, int node);
+
+  virtual int Lookup(int64 id) const {
+    if (id >= 0 && id < static_cast<int64>(directory_.size()) &&
+        directory_[id] >= 0)
+      return directory_[id];
+    return fallback_.Lookup(id);
+  }
+  virtual string ToString() const;
+
+ private:
+  // Dense directory indexed by id; -1 marks ids that are hashed instead.
+  vector<int> directory_;
+  HashPartitioner fallback_;
+};
+
+// Moves ids [lo, hi] to 'node' and leaves all other ids where 'base' puts them.
+// Does not take ownership of 'base'.
+class MigratedPartitioner : public Partitioner {
+ public:
+  MigratedPartitioner(const Partitioner* base, int64 lo, int64 hi, int node)
+      : base_(base), lo_(lo), hi_(hi), node_(node) {}
+  virtual int Lookup(int64 id) const {
+    return (id >= lo_ && id <= hi_) ? node_ : base_->Lookup(id);
+  }
+  virtual string ToString() const;
+
+ private:
+  const Partitioner* base_;
+  int64 lo_;
+  int64 hi_;
+  int node_;
+};
+
+class PartitionMap {
+ public:
+  // Creates a map that sends every table to 'default_partitioner'. Does not
+  // take ownership of any partitioner.
+  explicit PartitionMap(const Partitioner* default_partitioner);
+
+  // Splits 'key' into its table and id. The table is named by the key's first
+  // character unless that is a digit, in which case it is '\0' (the default
+  // table); the id is the run of digits that follows.
+  static void ParseKey(const Key& key, char* table, int64* id) {
+    const char* p = key.c_str();
+    *table = '\0';
+    if (*p != '\0' && (*p < '0' || *p > '9'))
+      *table = *p++;
+    int64 value = 0;
+    while (*p >= '0' && *p <= '9')
+      value = value * 10 + (*p++ - '0');
+    *id = value;
+  }
+
+  // Parses a migration spec "<table>:<lo>-<hi>@<node>", where <table> is a
+  // key prefix character or "default". Returns false if 'spec' is malformed.
+  static bool ParseMigration(const string& spec, char* table, int64* lo,
+                             int64* hi, int* node);
+
+  // Formats a migration the way ParseMigration() reads it.
+  static string FormatMigration(char table, int64 lo, int64 hi, int node);
+
+  // Returns the node_id of the node storing 'key'.
+  int Lookup(const Key& key) const {
+    char table;
+    int64 id;
+    ParseKey(key, &table, &id);
+    return partitioner(table)->Lookup(id);
+  }
+
+  // Returns the partitioner of 'table' ('\0' for the default table).
+  const Partitioner* partitioner(char table) const {
+    const Partitioner* partitioner =
+        partitioners_[static_cast<unsigned char>(table)];
+    return (partitioner != NULL) ? partitioner : default_;
+  }
+
+  // Uses 'partitioner' for 'table'.
+  void set_partitioner(char table, const Partitioner* partitioner) {
+    if (table == '\0')
+      default_ = partitioner;
+    else
+      partitioners_[static_cast<unsigned char>(table)] = partitioner;
+  }
+
+ private:
+  // Indexed by table; NULL entries fall back to 'default_'.
+  const Partitioner* partitioners_[256];
+  const Partitioner* default_;
+};
+
+#endif  // _DB_COMMON_PARTITIONER_H_
@@ -7,6 +7,7 @@
 #define _DB_COMMON_UTILS_H_
 
 #include <assert.h>
+#include <pthread.h>
 #include <sys/time.h>
 #include <unistd.h>
 #include <cstdio>
@@ -89,11 +90,18 @@ static inline void SpinUntil(double time) {
   }
 }
 
+// Returns rand(), or rand_r(seed) if the caller keeps its own seed, e.g. so
+// that concurrent loader threads do not contend on rand()'s lock.
+static inline int Rand(unsigned int* seed) {
+  return (seed != NULL) ? rand_r(seed) : rand();
+}
+
 // Produces a random alphabet string of the specified length
-static inline string RandomString(int length) {
+static inline string RandomString(int length, unsigned int* seed = NULL) {
   string random_string;
+  random_string.reserve(length);
   for (int i = 0; i < length; i++)
-    random_string += rand() % 26 + 'A';
+    random_string += Rand(seed) % 26 + 'A';
 
   return random_string;
 }
@@ -131,6 +139,42 @@ static inline int OffsetStringToInt(const string& s, int n) {
   return atoi(s.c_str() + n);
 }
 
+// Lookup table for Crc32(), built on first use.
+struct Crc32Table {
+  Crc32Table() {
+    for (uint32 i = 0; i < 256; i++) {
+      uint32 entry = i;
+      for (int bit = 0; bit < 8; bit++)
+        entry = (entry & 1) ? (entry >> 1) ^ 0xEDB88320 : entry >> 1;
+      entries[i] = entry;
+    }
+  }
+  uint32 entries[256];
+};
+
+// Returns the CRC-32 (as used by zlib) of 'size' bytes at 'data', continuing
+// from a previous result 'crc' (0 to start).
+static inline uint32 Crc32(uint32 crc, const char* data, size_t size) {
+  static const Crc32Table table;
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc = table.entries[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^
+          (crc >> 8);
+  }
+  return ~crc;
+}
+
+// Returns the 64-bit FNV-1 hash of 'key', as used to spread keys over lock
+// table slots.
+static inline uint64 FnvHash(const Key& key) {
+  uint64 hash = 2166136261;
+  for (size_t i = 0; i < key.size(); i++) {
+    hash = hash ^ (key[i]);
+    hash = hash * 16777619;
+  }
+  return hash;
+}
+
 // Function for deleting a heap-allocated string after it has been sent on a
 // zmq socket connection. E.g., if you want to send a heap-allocated
 // string '*s' on a socket 'sock':
@@ -319,7 +363,8 @@ class AtomicMap {
 
   inline bool Lookup(const K& k, V* v) {
     ReadLock l(&mutex_);
-    typename unordered_map<K, V>::const_iterator lookup = map_.find(k);
+    typename std::tr1::unordered_map<K, V>::const_iterator lookup =
+        map_.find(k);
     if (lookup == map_.end()) {
       return false;
     }
@@ -342,7 +387,8 @@ class AtomicMap {
   // was there already).
   inline V PutNoClobber(const K& k, const V& v) {
     WriteLock l(&mutex_);
-    typename unordered_map<K, V>::const_iterator lookup = map_.find(k);
+    typename std::tr1::unordered_map<K, V>::const_iterator lookup =
+        map_.find(k);
     if (lookup != map_.end()) {
       return lookup->second;
     }
@@ -357,7 +403,7 @@ class AtomicMap {
 
   inline void DeleteVAndClear() {
     WriteLock l(&mutex_);
-    for (typename unordered_map<K, V>::iterator it = map_.begin();
+    for (typename std::tr1::unordered_map<K, V>::iterator it = map_.begin();
          it != map_.end(); ++it) {
       delete it->second;
     }
@@ -365,7 +411,7 @@ class AtomicMap {
   }
 
  private:
-  unordered_map<K, V> map_;
+  std::tr1::unordered_map<K, V> map_;
   MutexRW mutex_;
 
   // DISALLOW_COPY_AND_ASSIGN
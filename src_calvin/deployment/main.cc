@@ -3,9 +3,12 @@
 //
 // Main invokation of a single node in the system.
 
+#include <sys/stat.h>
+
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 #include "applications/microbenchmark.h"
@@ -15,25 +18,16 @@
 #include "common/definitions.hh"
 #include "backend/simple_storage.h"
 #include "backend/fetching_storage.h"
+#include "backend/checkpoint_loader.h"
 #include "backend/collapsed_versioned_storage.h"
+#include "backend/mvcc_storage.h"
 #include "scheduler/serial_scheduler.h"
-#include "scheduler/deterministic_scheduler.h"
+#include "scheduler/scheduler.h"
+#include "scheduler/snapshot_executor.h"
+#include "sequencer/command_log.h"
 #include "sequencer/sequencer.h"
 #include "proto/tpcc_args.pb.h"
 
-map<Key, Key> latest_order_id_for_customer;
-map<Key, int> latest_order_id_for_district;
-map<Key, int> smallest_order_id_for_district;
-map<Key, Key> customer_for_order;
-unordered_map<Key, int> next_order_id_for_district;
-map<Key, int> item_for_order_line;
-map<Key, int> order_line_number;
-
-vector<Key>* involed_customers;
-
-pthread_mutex_t mutex_;
-pthread_mutex_t mutex_for_item;
-
 // Microbenchmark load generation client.
 class MClient : public Client {
  public:
@@ -65,10 +59,15 @@ class MClient : public Client {
 // TPCC load generation client.
 class TClient : public Client {
  public:
-  TClient(Configuration* config, int mp) : config_(config), percent_mp_(mp) {}
+  // If 'storage' was restored from a checkpoint, new orders continue the
+  // ones it holds.
+  TClient(Configuration* config, int mp, Storage* storage, bool restored)
+      : config_(config), percent_mp_(mp), storage_(storage) {
+    if (restored)
+      tpcc_.RestoreOrderNumbers(storage_, config_);
+  }
   virtual ~TClient() {}
   virtual void GetTxn(TxnProto** txn, int txn_id) {
-    TPCC tpcc;
     TPCCArgs args;
 
     args.set_system_time(GetTime());
@@ -84,24 +83,30 @@ class TClient : public Client {
     int random_txn_type = rand() % 100;
     // New order txn
     if (random_txn_type < 45) {
-      *txn = tpcc.NewTxn(txn_id, TPCC::NEW_ORDER, args_string, config_);
+      *txn = tpcc_.NewTxn(txn_id, TPCC::NEW_ORDER, args_string, config_);
     } else if (random_txn_type < 88) {
-      *txn = tpcc.NewTxn(txn_id, TPCC::PAYMENT, args_string, config_);
+      *txn = tpcc_.NewTxn(txn_id, TPCC::PAYMENT, args_string, config_);
     } else if (random_txn_type < 92) {
-      *txn = tpcc.NewTxn(txn_id, TPCC::ORDER_STATUS, args_string, config_);
+      *txn = tpcc_.NewTxn(txn_id, TPCC::ORDER_STATUS, args_string, config_);
       args.set_multipartition(false);
     } else if (random_txn_type < 96) {
-      *txn = tpcc.NewTxn(txn_id, TPCC::DELIVERY, args_string, config_);
+      *txn = tpcc_.NewTxn(txn_id, TPCC::DELIVERY, args_string, config_);
       args.set_multipartition(false);
     } else {
-      *txn = tpcc.NewTxn(txn_id, TPCC::STOCK_LEVEL, args_string, config_);
+      *txn = tpcc_.NewTxn(txn_id, TPCC::STOCK_LEVEL, args_string, config_);
       args.set_multipartition(false);
     }
+    tpcc_.Reconnoiter(*txn, storage_, config_);
   }
 
  private:
+  // Keeps the order numbers handed out so far.
+  TPCC tpcc_;
   Configuration* config_;
   int percent_mp_;
+
+  // This node's storage, for reconnaissance reads of dependent txns.
+  Storage* storage_;
 };
 
 void stop(int sig) {
@@ -145,6 +150,89 @@ int main(int argc, char** argv) {
   bool useFetching = false;
   if (argc > 4 && argv[4][0] == 'f')
     useFetching = true;
+
+  // Optional flags, given as --<name>=<value> or --<name>:
+  //
+  //   --migrate=default:0-999@1,w:3-3@0   repartition part way through the
+  //   --migrate-after=30                  run (see partition_migrator.h)
+  //   --command-log=<path>                log every batch to <path>.<node-id>
+  //   --log-durability=buffered|fsync     whether to fdatasync each epoch
+  //   --replay                            replay the log before going on
+  //                                       (after --restore, only the txns
+  //                                       the checkpoint does not hold)
+  //   --checkpoint-every=<batches>        checkpoint to versioned storage
+  //   --checkpoint-dir=<path>             checkpoints go to <path>/node<id>
+  //   --restore[=<txn>]                   load the newest (or the given)
+  //                                       checkpoint instead of a fresh
+  //                                       database
+  //   --page-io=uring|aio                 how fetching storage reaches the
+  //                                       disk (see backend/page_io.h)
+  //   --prefetch                          hold txns back until their objects
+  //                                       have been read in from disk
+  //   --mvcc                              keep multiple versions of every
+  //                                       object for snapshot reads
+  //   --snapshot-reads                    run read-only txns at a snapshot,
+  //                                       without ordering them (needs --mvcc)
+  //   --scheduler=calvin|pdlr|vll         how txns are locked (see
+  //                                       scheduler/scheduler.h)
+  map<string, string> flags;
+  for (int i = 4; i < argc; i++) {
+    if (strncmp(argv[i], "--", 2) != 0)
+      continue;
+    const char* equals = strchr(argv[i], '=');
+    if (equals == NULL)
+      flags[string(argv[i] + 2)] = "";
+    else
+      flags[string(argv[i] + 2, equals - argv[i] - 2)] = string(equals + 1);
+  }
+  string migrations = flags["migrate"];
+  double migrate_after =
+      flags.count("migrate-after") ? atof(flags["migrate-after"].c_str()) : 30;
+
+  CommandLog::Durability durability = CommandLog::FSYNC;
+  if (flags.count("log-durability") &&
+      !CommandLog::ParseDurability(flags["log-durability"], &durability)) {
+    fprintf(stderr, "Unknown log durability %s\n",
+            flags["log-durability"].c_str());
+    exit(1);
+  }
+  int checkpoint_interval = atoi(flags["checkpoint-every"].c_str());
+  bool mvcc = flags.count("mvcc") > 0;
+  if (checkpoint_interval > 0 && (useFetching || mvcc)) {
+    fprintf(stderr, "Checkpoints need collapsed versioned storage\n");
+    exit(1);
+  }
+  if (!migrations.empty() && useFetching) {
+    fprintf(stderr, "--migrate needs storage that can list its objects\n");
+    exit(1);
+  }
+  if (mvcc && useFetching) {
+    fprintf(stderr, "--mvcc keeps everything in memory, not fetching\n");
+    exit(1);
+  }
+  bool snapshot_reads = flags.count("snapshot-reads") > 0;
+  if (snapshot_reads && !mvcc) {
+    fprintf(stderr, "--snapshot-reads needs --mvcc\n");
+    exit(1);
+  }
+  string page_io = flags.count("page-io") ? flags["page-io"] : "uring";
+  if (page_io != "uring" && page_io != "aio") {
+    fprintf(stderr, "Unknown page I/O backend %s\n", page_io.c_str());
+    exit(1);
+  }
+  string scheduler_name =
+      flags.count("scheduler") ? flags["scheduler"] : "calvin";
+  if (scheduler_name != "calvin" && scheduler_name != "pdlr" &&
+      scheduler_name != "vll") {
+    fprintf(stderr, "Unknown scheduler %s\n", scheduler_name.c_str());
+    exit(1);
+  }
+  bool prefetch = flags.count("prefetch") > 0;
+  bool replay = flags.count("replay") > 0;
+  if (replay && flags["command-log"].empty()) {
+    fprintf(stderr, "--replay needs a --command-log\n");
+    exit(1);
+  }
   // Catch ^C and kill signals and exit gracefully (for profiling).
   signal(SIGINT, &stop);
   signal(SIGTERM, &stop);
@@ -155,47 +243,111 @@ int main(int argc, char** argv) {
   // Build connection context and start multiplexer thread running.
   ConnectionMultiplexer multiplexer(&config);
 
-  // Artificial loadgen clients.
-  Client* client =
-      (argv[2][0] == 'm')
-          ? reinterpret_cast<Client*>(new MClient(&config, atoi(argv[3])))
-          : reinterpret_cast<Client*>(new TClient(&config, atoi(argv[3])));
-
   // #ifdef PAXOS
   //  StartZookeeper(ZOOKEEPER_CONF);
   // #endif
-  pthread_mutex_init(&mutex_, NULL);
-  pthread_mutex_init(&mutex_for_item, NULL);
-  involed_customers = new vector<Key>;
 
+  // Nodes sharing a machine must not share checkpoint files.
+  string checkpoint_dir =
+      (flags["checkpoint-dir"].empty() ? CHKPNTDIR : flags["checkpoint-dir"]) +
+      string("/node") + argv[1];
+  if (checkpoint_interval > 0)
+    mkdir(checkpoint_dir.c_str(), 0755);
   Storage* storage;
-  if (!useFetching) {
+  if (checkpoint_interval > 0) {
+    storage = new CollapsedVersionedStorage(checkpoint_dir);
+  } else if (mvcc) {
+    storage = new MvccStorage();
+  } else if (!useFetching) {
     storage = new SimpleStorage();
   } else {
-    storage = FetchingStorage::BuildStorage();
+    storage = FetchingStorage::BuildStorage(page_io);
   }
   storage->Initmutex();
-  if (argv[2][0] == 'm') {
+  int64 stable = -1;
+  if (flags.count("restore")) {
+    CheckpointLoader loader(checkpoint_dir);
+    stable = flags["restore"].empty() ? loader.FindLatest()
+                                      : atoll(flags["restore"].c_str());
+    double start = GetTime();
+    if (stable < 0 || !loader.Load(stable, storage)) {
+      fprintf(stderr, "No usable checkpoint in %s\n", checkpoint_dir.c_str());
+      exit(1);
+    }
+    double elapsed = GetTime() - start;
+    std::cout << "Restored " << loader.objects() << " objects ("
+              << loader.bytes() / 1048576 << " MB) as of txn " << stable
+              << " in " << elapsed << " s ("
+              << (elapsed > 0 ? loader.objects() / elapsed : 0)
+              << " objects/s)\n" << std::flush;
+    if (argv[2][0] != 'm')
+      TPCC().InitializeItems();
+  } else if (argv[2][0] == 'm') {
     Microbenchmark(config.all_nodes.size(), HOT)
         .InitializeStorage(storage, &config);
   } else {
     TPCC().InitializeStorage(storage, &config);
   }
 
+  // Artificial loadgen clients. They make their reconnaissance reads in the
+  // loaded storage.
+  Client* client =
+      (argv[2][0] == 'm')
+          ? reinterpret_cast<Client*>(new MClient(&config, atoi(argv[3])))
+          : reinterpret_cast<Client*>(
+                new TClient(&config, atoi(argv[3]), storage, stable >= 0));
+
+  // The log of a node holds the batches its own sequencer ordered.
+  CommandLog* command_log = NULL;
+  if (!flags["command-log"].empty()) {
+    command_log = new CommandLog(flags["command-log"] + "." + argv[1],
+                                 durability, replay);
+  }
+
+  SnapshotExecutor* snapshot_executor = NULL;
+  if (snapshot_reads) {
+    Application* application =
+        (argv[2][0] == 'm')
+            ? reinterpret_cast<Application*>(
+                  new Microbenchmark(config.all_nodes.size(), HOT))
+            : reinterpret_cast<Application*>(new TPCC());
+    snapshot_executor = new SnapshotExecutor(
+        &config, static_cast<MvccStorage*>(storage), application);
+  }
+
   // Initialize sequencer component and start sequencer thread running.
   Sequencer sequencer(&config, multiplexer.NewConnection("sequencer"), client,
-                      storage);
+                      storage, command_log, replay, prefetch,
+                      snapshot_executor, stable);
 
   // Run scheduler in main thread.
-  if (argv[2][0] == 'm') {
-    DeterministicScheduler scheduler(
-        &config, multiplexer.NewConnection("scheduler_"), storage,
-        new Microbenchmark(config.all_nodes.size(), HOT));
-  } else {
-    DeterministicScheduler scheduler(
-        &config, multiplexer.NewConnection("scheduler_"), storage, new TPCC());
-  }
+  Application* application =
+      (argv[2][0] == 'm')
+          ? reinterpret_cast<Application*>(
+                new Microbenchmark(config.all_nodes.size(), HOT))
+          : reinterpret_cast<Application*>(new TPCC());
+  std::cout << "Scheduler: " << scheduler_name << std::endl;
+  Scheduler::Create(scheduler_name, &config,
+                    multiplexer.NewConnection("scheduler_"), storage,
+                    application, checkpoint_interval);
 
-  Spin(180);
+  double run_time = 180;
+  if (!migrations.empty() && migrate_after < run_time) {
+    Spin(migrate_after);
+    size_t start = 0;
+    while (start < migrations.size()) {
+      size_t end = migrations.find(',', start);
+      if (end == string::npos)
+        end = migrations.size();
+      string spec = migrations.substr(start, end - start);
+      if (sequencer.SubmitMigration(spec))
+        std::cout << "Submitted migration " << spec << "\n" << std::flush;
+      else
+        std::cout << "Invalid migration " << spec << "\n" << std::flush;
+      start = end + 1;
+    }
+    run_time -= migrate_after;
+  }
+  Spin(run_time);
   return 0;
 }
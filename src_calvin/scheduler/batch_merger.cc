@@ -0,0 +1,121 @@
+// Deterministic merge of the per-sequencer batch streams.
+
+#include "scheduler/batch_merger.h"
+
+#include <cstdio>
+
+#include "common/connection.h"
+#include "common/utils.h"
+#include "proto/message.pb.h"
+
+BatchMerger::BatchMerger(int num_sequencers, Connection* connection)
+    : num_sequencers_(num_sequencers),
+      connection_(connection),
+      watermarks_(num_sequencers),
+      stalled_on_(-1),
+      stall_start_(0),
+      stall_time_(num_sequencers, 0),
+      merged_batches_(0),
+      heartbeats_(0),
+      max_buffered_(0) {
+  // Sequencer i's first batch is batch i, so nothing is below watermark i - N.
+  for (int i = 0; i < num_sequencers_; i++)
+    watermarks_[i] = i - num_sequencers_;
+}
+
+BatchMerger::~BatchMerger() {
+  for (unordered_map<int64, MessageProto*>::iterator it = pending_.begin();
+       it != pending_.end(); ++it)
+    delete it->second;
+}
+
+void BatchMerger::AddBatch(MessageProto* batch) {
+  assert(batch->type() == MessageProto::TXN_BATCH);
+  int64 batch_number = batch->batch_number();
+  pending_[batch_number] = batch;
+  if (static_cast<int>(pending_.size()) > max_buffered_)
+    max_buffered_ = pending_.size();
+
+  // Advance the sender's watermark past every batch it has now delivered
+  // contiguously. Batches from one sequencer normally arrive in order, so this
+  // usually moves by exactly one step.
+  int sequencer = batch_number % num_sequencers_;
+  int64 next = watermarks_[sequencer] + num_sequencers_;
+  while (pending_.count(next) > 0) {
+    watermarks_[sequencer] = next;
+    next += num_sequencers_;
+  }
+}
+
+MessageProto* BatchMerger::GetBatch(int64 batch_number) {
+  if (connection_ != NULL) {
+    MessageProto* message = new MessageProto();
+    while (connection_->GetMessage(message)) {
+      AddBatch(message);
+      message = new MessageProto();
+    }
+    delete message;
+  }
+
+  unordered_map<int64, MessageProto*>::iterator it = pending_.find(batch_number);
+  if (it == pending_.end()) {
+    // The sequencer that owns this batch is holding everybody up.
+    if (stalled_on_ != batch_number) {
+      stalled_on_ = batch_number;
+      stall_start_ = GetTime();
+    }
+    return NULL;
+  }
+
+  if (stalled_on_ == batch_number) {
+    stall_time_[batch_number % num_sequencers_] += GetTime() - stall_start_;
+    stalled_on_ = -1;
+  }
+
+  MessageProto* batch = it->second;
+  pending_.erase(it);
+  merged_batches_++;
+  if (batch->data_size() == 0)
+    heartbeats_++;
+  return batch;
+}
+
+string BatchMerger::ReportStats() {
+  // Charge an ongoing stall to the interval being reported.
+  if (stalled_on_ != -1) {
+    double now = GetTime();
+    stall_time_[stalled_on_ % num_sequencers_] += now - stall_start_;
+    stall_start_ = now;
+  }
+
+  int64 max_watermark = watermarks_[0];
+  for (int i = 1; i < num_sequencers_; i++)
+    if (watermarks_[i] > max_watermark)
+      max_watermark = watermarks_[i];
+
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer),
+           "Merged %d batches (%d heartbeats), %d buffered (max %d)",
+           merged_batches_, heartbeats_, static_cast<int>(pending_.size()),
+           max_buffered_);
+  string output(buffer);
+  if (stalled_on_ != -1) {
+    snprintf(buffer, sizeof(buffer), ", waiting on batch %ld",
+             static_cast<long>(stalled_on_));
+    output.append(buffer);
+  }
+  output.append("\nSequencers (epochs behind / stalled secs):");
+  for (int i = 0; i < num_sequencers_; i++) {
+    snprintf(buffer, sizeof(buffer), " %d:%ld/%.3f", i,
+             static_cast<long>(
+                 (max_watermark - watermarks_[i]) / num_sequencers_),
+             stall_time_[i]);
+    output.append(buffer);
+    stall_time_[i] = 0;
+  }
+
+  merged_batches_ = 0;
+  heartbeats_ = 0;
+  max_buffered_ = pending_.size();
+  return output;
+}
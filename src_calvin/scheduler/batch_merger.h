@@ -0,0 +1,82 @@
+// The batch merger sits between the sequencers and a node's scheduler. Every
+// sequencer emits exactly one batch per epoch -- an empty heartbeat batch if it
+// had nothing to order -- and numbers them so that batch k * N + i comes from
+// sequencer i. The merger buffers batches that arrive ahead of time and hands
+// them to the scheduler strictly in batch-number order, which interleaves the
+// N sequencer streams into the same global order on every node.
+//
+// It also tracks a progress watermark per sequencer: the highest batch number
+// up to which every batch from that sequencer has arrived. Whenever the
+// scheduler asks for a batch that is not there yet, the sequencer it belongs
+// to is the straggler holding up the merge; the merger accounts how long each
+// sequencer stalls the scheduler and how many batches from the others pile up
+// in the meantime (backpressure).
+
+#ifndef _DB_SCHEDULER_BATCH_MERGER_H_
+#define _DB_SCHEDULER_BATCH_MERGER_H_
+
+#include <string>
+#include <tr1/unordered_map>
+#include <vector>
+
+#include "common/types.h"
+
+using std::string;
+using std::vector;
+using std::tr1::unordered_map;
+
+class Connection;
+class MessageProto;
+
+class BatchMerger {
+ public:
+  // Merges the batches of 'num_sequencers' sequencers arriving on
+  // 'connection'. If 'connection' is NULL, batches are only fed in through
+  // AddBatch().
+  BatchMerger(int num_sequencers, Connection* connection);
+  ~BatchMerger();
+
+  // Takes ownership of a TXN_BATCH message produced by some sequencer.
+  void AddBatch(MessageProto* batch);
+
+  // Returns the heap-allocated batch numbered 'batch_number' (ownership passes
+  // to the caller), or NULL if it has not arrived yet. Messages waiting on the
+  // connection are drained first. Batches must be requested in order.
+  MessageProto* GetBatch(int64 batch_number);
+
+  // Highest batch number such that all batches from 'sequencer' up to and
+  // including it have been received. Before its first batch arrives this is
+  // the number its first batch would follow, 'sequencer' - num_sequencers.
+  int64 watermark(int sequencer) const { return watermarks_[sequencer]; }
+
+  // Number of batches received but not yet handed to the scheduler.
+  int buffered_batches() const { return pending_.size(); }
+
+  // Returns a one-line summary of merge progress since the previous call:
+  // batches merged, heartbeats, backlog, and for each sequencer its lag behind
+  // the most advanced one and the time the scheduler spent waiting on it.
+  string ReportStats();
+
+ private:
+  int num_sequencers_;
+  Connection* connection_;
+
+  // Batches that have arrived but have not been requested yet.
+  unordered_map<int64, MessageProto*> pending_;
+
+  // Per-sequencer progress watermarks.
+  vector<int64> watermarks_;
+
+  // Batch number the scheduler is currently waiting on (-1 if it is not
+  // waiting) and the time it started waiting.
+  int64 stalled_on_;
+  double stall_start_;
+
+  // Counters for the current reporting interval.
+  vector<double> stall_time_;
+  int merged_batches_;
+  int heartbeats_;
+  int max_buffered_;
+};
+
+#endif  // _DB_SCHEDULER_BATCH_MERGER_H_
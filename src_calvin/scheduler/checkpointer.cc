@@ -0,0 +1,80 @@
+// Deterministic trigger for online checkpoints.
+
+#include "scheduler/checkpointer.h"
+
+#include <cstdio>
+
+#include "backend/storage.h"
+#include "common/definitions.hh"
+#include "proto/txn.pb.h"
+
+Checkpointer::Checkpointer(Storage* storage, int interval)
+    : storage_(storage), interval_(interval), stable_(-1), waiting_(-1),
+      active_(false), baseline_(0), checkpoint_txns_(0), checkpoint_time_(0) {}
+
+void Checkpointer::BatchLoaded(int batch, int in_flight) {
+  if (batch > 0) {
+    boundaries_.push_back(std::make_pair(
+        static_cast<int64>(batch) * MAX_LOCK_BATCH_SIZE - 1, in_flight));
+    AdvanceWatermark();
+  }
+
+  if (interval_ <= 0 || batch == 0 || batch % interval_ != 0)
+    return;
+  // The previous checkpoint is still being written; skip this one.
+  if (active_ || storage_->Checkpointing())
+    return;
+
+  stable_ = static_cast<int64>(batch) * MAX_LOCK_BATCH_SIZE - 1;
+  storage_->PrepareForCheckpoint(stable_);
+  active_ = true;
+  checkpoint_txns_ = 0;
+  checkpoint_time_ = 0;
+  waiting_ = in_flight;
+  if (waiting_ == 0) {
+    storage_->Checkpoint();
+    waiting_ = -1;
+  }
+}
+
+void Checkpointer::TxnDone(const TxnProto& txn) {
+  if (waiting_ > 0 && txn.txn_id() <= stable_ && --waiting_ == 0) {
+    storage_->Checkpoint();
+    waiting_ = -1;
+  }
+
+  for (deque<pair<int64, int> >::reverse_iterator it = boundaries_.rbegin();
+       it != boundaries_.rend() && txn.txn_id() <= it->first; ++it)
+    it->second--;
+  AdvanceWatermark();
+}
+
+void Checkpointer::AdvanceWatermark() {
+  while (!boundaries_.empty() && boundaries_.front().second <= 0) {
+    storage_->AdvanceWatermark(boundaries_.front().first);
+    boundaries_.pop_front();
+  }
+}
+
+string Checkpointer::ReportStats(int txns, double elapsed) {
+  char buffer[160];
+  if (!active_) {
+    baseline_ = txns / elapsed;
+    return string();
+  }
+
+  checkpoint_txns_ += txns;
+  checkpoint_time_ += elapsed;
+  if (waiting_ >= 0 || storage_->Checkpointing()) {
+    snprintf(buffer, sizeof(buffer),
+             "Checkpointing as of txn %ld: %.0f txns/sec (%.0f before)",
+             static_cast<long>(stable_), txns / elapsed, baseline_);
+  } else {
+    active_ = false;
+    snprintf(buffer, sizeof(buffer),
+             "Checkpoint as of txn %ld done: %.0f txns/sec during it over "
+             "%.1f s (%.0f before)", static_cast<long>(stable_),
+             checkpoint_txns_ / checkpoint_time_, checkpoint_time_, baseline_);
+  }
+  return string(buffer);
+}
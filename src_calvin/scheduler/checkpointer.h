@@ -0,0 +1,79 @@
+// Takes consistent checkpoints of the storage while execution goes on. Every
+// 'interval' batches, the state as of the end of the previous batch is
+// captured. That point is the same on every replica, since it only depends on
+// the global order:
+//
+//  - When the scheduler loads the checkpoint batch, before it locks any of its
+//    txns, the storage is told to preserve the versions as of the last txn id
+//    of the previous batch (Storage::PrepareForCheckpoint).
+//  - Txns of earlier batches may still be running then. Once the last of them
+//    has completed, the storage starts writing the checkpoint in the
+//    background (Storage::Checkpoint) while later txns keep executing.
+//
+// The same bookkeeping tells the storage whenever every txn of a batch and the
+// batches before it has completed (Storage::AdvanceWatermark), so that
+// multi-version storages can collect old versions.
+
+#ifndef _DB_SCHEDULER_CHECKPOINTER_H_
+#define _DB_SCHEDULER_CHECKPOINTER_H_
+
+#include <deque>
+#include <string>
+#include <utility>
+
+#include "common/types.h"
+
+using std::deque;
+using std::pair;
+using std::string;
+
+class Storage;
+class TxnProto;
+
+class Checkpointer {
+ public:
+  // Checkpoints 'storage' every 'interval' batches; never if 'interval' is 0.
+  Checkpointer(Storage* storage, int interval);
+
+  // Called when batch 'batch' is loaded, before any of its txns is locked,
+  // with the number of txns of earlier batches that have not completed yet.
+  void BatchLoaded(int batch, int in_flight);
+
+  // Called for every txn that completes.
+  void TxnDone(const TxnProto& txn);
+
+  // Takes the number of txns completed in the last 'elapsed' seconds and
+  // returns a line on the checkpoint in progress or just finished, comparing
+  // throughput during the checkpoint with the throughput before it. Returns
+  // an empty string if there is nothing to report.
+  string ReportStats(int txns, double elapsed);
+
+ private:
+  // Passes on every boundary in 'boundaries_' whose txns have all completed.
+  void AdvanceWatermark();
+
+  Storage* storage_;
+  int interval_;
+
+  // Last txn id included in the current checkpoint.
+  int64 stable_;
+
+  // Txns up to 'stable_' still running, or -1 if none are awaited.
+  int waiting_;
+
+  // True from BatchLoaded() starting a checkpoint until it has been reported
+  // as finished.
+  bool active_;
+
+  // Throughput of the last reporting interval without a checkpoint, and txns
+  // and time accumulated while the current one is in progress.
+  double baseline_;
+  int64 checkpoint_txns_;
+  double checkpoint_time_;
+
+  // Last txn ids of loaded batches the watermark has not passed yet, each with
+  // the number of txns up to it still running.
+  deque<pair<int64, int> > boundaries_;
+};
+
+#endif  // _DB_SCHEDULER_CHECKPOINTER_H_
@@ -0,0 +1,99 @@
+// Slot bitmap for VLL's selective contention analysis.
+
+#include "scheduler/conflict_bitmap.h"
+
+#include <immintrin.h>
+
+static bool AnySetScalar(const uint32* words, const int* slots, int count) {
+  for (int i = 0; i < count; i++) {
+    if (words[slots[i] >> 5] & (1u << (slots[i] & 31)))
+      return true;
+  }
+  return false;
+}
+
+// Compiled for AVX2 regardless of the build flags, and only called once the
+// CPU is known to support it.
+__attribute__((target("avx2"))) static bool AnySetAvx2(const uint32* words,
+                                                        const int* slots,
+                                                        int count) {
+  const __m256i low_bits = _mm256_set1_epi32(31);
+  const __m256i one = _mm256_set1_epi32(1);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i slot =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slots + i));
+    __m256i word = _mm256_i32gather_epi32(reinterpret_cast<const int*>(words),
+                                          _mm256_srli_epi32(slot, 5), 4);
+    __m256i bit = _mm256_sllv_epi32(one, _mm256_and_si256(slot, low_bits));
+    if (!_mm256_testz_si256(word, bit))
+      return true;
+  }
+  return AnySetScalar(words, slots + i, count - i);
+}
+
+static bool AnyLockedScalar(const int* counts, const int* slots, int count) {
+  for (int i = 0; i < count; i++) {
+    if (counts[slots[i]] > 0)
+      return true;
+  }
+  return false;
+}
+
+__attribute__((target("avx2"))) static bool AnyLockedAvx2(const int* counts,
+                                                          const int* slots,
+                                                          int count) {
+  const __m256i zero = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i slot =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slots + i));
+    __m256i held = _mm256_cmpgt_epi32(_mm256_i32gather_epi32(counts, slot, 4),
+                                      zero);
+    if (!_mm256_testz_si256(held, held))
+      return true;
+  }
+  return AnyLockedScalar(counts, slots + i, count - i);
+}
+
+typedef bool (*AnySetFunction)(const uint32*, const int*, int);
+typedef bool (*AnyLockedFunction)(const int*, const int*, int);
+
+static bool HasAvx2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+static const bool avx2 = HasAvx2();
+static const AnySetFunction any_set = avx2 ? AnySetAvx2 : AnySetScalar;
+static const AnyLockedFunction any_locked =
+    avx2 ? AnyLockedAvx2 : AnyLockedScalar;
+
+ConflictBitmap::ConflictBitmap(int slots) : words_((slots + 31) / 32, 0) {}
+
+bool ConflictBitmap::AnySet(const int* slots, int count) const {
+  return any_set(&words_[0], slots, count);
+}
+
+void ConflictBitmap::Set(const int* slots, int count) {
+  for (int i = 0; i < count; i++) {
+    uint32* word = &words_[slots[i] >> 5];
+    if (*word == 0)
+      touched_.push_back(slots[i] >> 5);
+    *word |= 1u << (slots[i] & 31);
+  }
+}
+
+void ConflictBitmap::Clear() {
+  for (size_t i = 0; i < touched_.size(); i++)
+    words_[touched_[i]] = 0;
+  touched_.clear();
+}
+
+bool ConflictBitmap::Vectorized() {
+  return avx2;
+}
+
+bool AnyLocked(const int* counts, const int* slots, int count) {
+  return any_locked(counts, slots, count);
+}
@@ -0,0 +1,48 @@
+// Set of lock table slots, as built up by VLL's selective contention analysis
+// (SCA) while it walks the txn queue. Every txn's slots are tested before they
+// are set, so the test is the hot path: where the CPU supports AVX2 it gathers
+// the words of eight slots at once.
+//
+// A pass only touches the words of the slots of queued txns, so instead of
+// wiping the whole bitmap Clear() zeroes just the words that were set.
+//
+// AnyLocked() tests slots against a lock table of counters the same way.
+
+#ifndef _DB_SCHEDULER_CONFLICT_BITMAP_H_
+#define _DB_SCHEDULER_CONFLICT_BITMAP_H_
+
+#include <vector>
+
+#include "common/types.h"
+
+using std::vector;
+
+class ConflictBitmap {
+ public:
+  // Covers slots [0, 'slots').
+  explicit ConflictBitmap(int slots);
+
+  // Returns true if any of the 'count' slots starting at 'slots' is set.
+  bool AnySet(const int* slots, int count) const;
+
+  // Sets the 'count' slots starting at 'slots'.
+  void Set(const int* slots, int count);
+
+  // Clears every slot set since the previous call.
+  void Clear();
+
+  // Returns true if the AVX2 path is in use.
+  static bool Vectorized();
+
+ private:
+  vector<uint32> words_;
+
+  // Indices of the nonzero words.
+  vector<int> touched_;
+};
+
+// Returns true if 'counts' is positive at any of the 'count' slots starting at
+// 'slots'.
+bool AnyLocked(const int* counts, const int* slots, int count);
+
+#endif  // _DB_SCHEDULER_CONFLICT_BITMAP_H_
@@ -0,0 +1,60 @@
+// Sliding-window lock contention estimates for the PDLR lock manager.
+
+#include "scheduler/contention_estimator.h"
+
+#include <cstdio>
+
+ContentionEstimator::ContentionEstimator(int entries)
+    : window_(0), requests_(0), queued_(MAX_QUEUED + 1, 0), threshold_(1),
+      txns_(0), contended_txns_(0) {
+  Entry empty = {0, 0};
+  entries_.resize(entries, empty);
+}
+
+bool ContentionEstimator::Record(int entry, int queued) {
+  if (queued > MAX_QUEUED)
+    queued = MAX_QUEUED;
+
+  // Halve the average once per window since the entry was last requested,
+  // then move it an eighth of the way towards this request's queue length.
+  Entry* e = &entries_[entry];
+  uint32 elapsed = window_ - e->window;
+  e->average = elapsed >= 32 ? 0 : e->average >> elapsed;
+  e->window = window_;
+  int sample = queued << SCALE_BITS;
+  e->average += (sample - static_cast<int>(e->average)) / 8;
+  bool contended = e->average > (static_cast<uint32>(threshold_) << SCALE_BITS);
+
+  queued_[queued]++;
+  if (++requests_ == CONTENTION_WINDOW) {
+    // Pick the threshold for the next window.
+    int below = requests_ * CONTENTION_PERCENTILE / 100;
+    int length = 0;
+    for (int seen = queued_[0]; seen < below; seen += queued_[++length]) {
+    }
+    threshold_ = length < 1 ? 1 : length;
+
+    window_++;
+    requests_ = 0;
+    queued_.assign(MAX_QUEUED + 1, 0);
+  }
+  return contended;
+}
+
+void ContentionEstimator::CountTxn(bool contended) {
+  txns_++;
+  if (contended)
+    contended_txns_++;
+}
+
+string ContentionEstimator::ReportStats() {
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer),
+           "Contention: queue length threshold %d, %d of %d txns contended "
+           "(%.1f%%)",
+           threshold_, contended_txns_, txns_,
+           txns_ == 0 ? 0 : 100.0 * contended_txns_ / txns_);
+  txns_ = 0;
+  contended_txns_ = 0;
+  return string(buffer);
+}
@@ -0,0 +1,71 @@
+// Estimates how contended each lock table entry is, so that the PDLR lock
+// manager can tell txns on hot keys from the rest.
+//
+// Every lock request reports the length of the queue it waits behind (zero if
+// it is granted at once). Each entry keeps a moving average of those lengths,
+// which also halves for every window of CONTENTION_WINDOW requests (at any
+// entry) that passes, so an entry that stops being hot cools down within a few
+// windows whether or not it is requested again.
+//
+// An entry is contended while its average exceeds a threshold that is chosen
+// anew after every window: the CONTENTION_PERCENTILE-th percentile of the
+// queue lengths requests reported during it, and at least 1. Under low skew
+// queues are short and few entries qualify; under high skew the threshold
+// rises with the queues of the hottest keys.
+
+#ifndef _DB_SCHEDULER_CONTENTION_ESTIMATOR_H_
+#define _DB_SCHEDULER_CONTENTION_ESTIMATOR_H_
+
+#include <string>
+#include <vector>
+
+#include "common/definitions.hh"
+#include "common/types.h"
+
+using std::string;
+using std::vector;
+
+class ContentionEstimator {
+ public:
+  // Tracks entries [0, 'entries').
+  explicit ContentionEstimator(int entries);
+
+  // Records a lock request on 'entry' that waits behind 'queued' earlier
+  // requests, and returns true if the entry is contended.
+  bool Record(int entry, int queued);
+
+  // Queue length averages must exceed to count as contended.
+  int threshold() const { return threshold_; }
+
+  // Called once per txn, with whether any of its keys was contended.
+  void CountTxn(bool contended);
+
+  // Returns the threshold and the share of contended txns since the previous
+  // call, then starts a new interval.
+  string ReportStats();
+
+ private:
+  // Longest queue length told apart in the percentile.
+  enum { MAX_QUEUED = 255 };
+
+  // Averages are fixed point, with this many fractional bits.
+  enum { SCALE_BITS = 4 };
+
+  struct Entry {
+    uint32 average;
+    uint32 window;
+  };
+  vector<Entry> entries_;
+
+  // Requests in the current window, and how many reported each queue length.
+  uint32 window_;
+  int requests_;
+  vector<int> queued_;
+
+  int threshold_;
+
+  int txns_;
+  int contended_txns_;
+};
+
+#endif  // _DB_SCHEDULER_CONTENTION_ESTIMATOR_H_
@@ -14,7 +14,10 @@ using std::vector;
 
 DeterministicLockManager::DeterministicLockManager(deque<TxnProto*>* ready_txns,
                                                    Configuration* config)
-    : configuration_(config), ready_txns_(ready_txns) {
+    : configuration_(config),
+      ready_txns_(ready_txns),
+      hold_stats_(config->this_node_id),
+      advisor_(config) {
   for (int i = 0; i < LOCK_TABLE_SIZE; i++)
     lock_table_[i] = new deque<KeysList>();
 }
@@ -45,8 +48,10 @@ int DeterministicLockManager::Lock(TxnProto* txn) {
       if (requests->empty() || txn != requests->back().txn) {
         requests->push_back(LockRequest(WRITE, txn));
         // Write lock request fails if there is any previous request at all.
-        if (requests->size() > 1)
+        if (requests->size() > 1) {
           not_acquired++;
+          advisor_.RecordWait(txn->read_write_set(i));
+        }
       }
     }
   }
@@ -78,6 +83,7 @@ int DeterministicLockManager::Lock(TxnProto* txn) {
              it != requests->end(); ++it) {
           if (it->mode == WRITE) {
             not_acquired++;
+            advisor_.RecordWait(txn->read_set(i));
             break;
           }
         }
@@ -88,12 +94,15 @@ int DeterministicLockManager::Lock(TxnProto* txn) {
   // Record and return the number of locks that the txn is blocked on.
   if (not_acquired > 0)
     txn_waits_[txn] = not_acquired;
-  else
+  else {
     ready_txns_->push_back(txn);
+    hold_stats_.Granted(txn);
+  }
   return not_acquired;
 }
 
 void DeterministicLockManager::Release(TxnProto* txn) {
+  hold_stats_.Released(txn);
   for (int i = 0; i < txn->read_set_size(); i++)
     if (IsLocal(txn->read_set(i)))
       Release(txn->read_set(i), txn);
@@ -165,6 +174,7 @@ void DeterministicLockManager::Release(const Key& key, TxnProto* txn) {
           // The txn that just acquired the released lock is no longer waiting
           // on any lock requests.
           ready_txns_->push_back(new_owners[j]);
+          hold_stats_.Granted(new_owners[j]);
           txn_waits_.erase(new_owners[j]);
         }
       }
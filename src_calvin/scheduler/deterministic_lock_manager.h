@@ -12,6 +12,8 @@
 
 #include "common/configuration.h"
 #include "scheduler/lock_manager.h"
+#include "scheduler/lock_hold_stats.h"
+#include "scheduler/rebalance_advisor.h"
 #include "common/utils.h"
 #include "common/definitions.hh"
 
@@ -30,15 +32,14 @@ class DeterministicLockManager {
   virtual void Release(const Key& key, TxnProto* txn);
   virtual void Release(TxnProto* txn);
 
+  // Lock hold times of the txns that went through this lock manager.
+  LockHoldStats* hold_stats() { return &hold_stats_; }
+
+  // Per-key lock contention at this node.
+  RebalanceAdvisor* advisor() { return &advisor_; }
+
  private:
-  int Hash(const Key& key) {
-    uint64 hash = 2166136261;
-    for (size_t i = 0; i < key.size(); i++) {
-      hash = hash ^ (key[i]);
-      hash = hash * 16777619;
-    }
-    return hash % LOCK_TABLE_SIZE;
-  }
+  int Hash(const Key& key) { return FnvHash(key) % LOCK_TABLE_SIZE; }
 
   bool IsLocal(const Key& key) {
     return configuration_->LookupPartition(key) == configuration_->this_node_id;
@@ -80,5 +81,8 @@ class DeterministicLockManager {
   // 'txn_waits_' are invalided by any call to Release() with the entry's
   // txn.
   unordered_map<TxnProto*, int> txn_waits_;
+
+  LockHoldStats hold_stats_;
+  RebalanceAdvisor advisor_;
 };
 #endif  // _DB_SCHEDULER_DETERMINISTIC_LOCK_MANAGER_H_
@@ -0,0 +1,66 @@
+// Lock manager latency percentiles.
+
+#include "scheduler/latency_stats.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include "common/utils.h"
+
+// Bucket 0 holds latencies below a microsecond, bucket b > 0 those of up to
+// 1.05^b microseconds (about two minutes for the last one).
+static const int kBuckets = 480;
+static const double kBase = 1.05;
+
+LatencyStats::LatencyStats() : buckets_(kBuckets, 0), count_(0), max_(0) {}
+
+int LatencyStats::Bucket(double latency) {
+  if (latency < 1e-6)
+    return 0;
+  int bucket = 1 + static_cast<int>(log(latency * 1e6) / log(kBase));
+  return bucket < kBuckets ? bucket : kBuckets - 1;
+}
+
+double LatencyStats::Latency(int bucket) {
+  return 1e-6 * pow(kBase, bucket);
+}
+
+void LatencyStats::Requested(const TxnProto* txn) {
+  request_times_[txn] = GetTime();
+}
+
+void LatencyStats::Released(const TxnProto* txn) {
+  unordered_map<const TxnProto*, double>::iterator it =
+      request_times_.find(txn);
+  if (it == request_times_.end())
+    return;
+  double latency = GetTime() - it->second;
+  request_times_.erase(it);
+
+  buckets_[Bucket(latency)]++;
+  count_++;
+  if (latency > max_)
+    max_ = latency;
+}
+
+double LatencyStats::Percentile(double percentile) const {
+  double below = count_ * percentile / 100;
+  int seen = 0;
+  for (int i = 0; i < kBuckets; i++) {
+    seen += buckets_[i];
+    if (seen > 0 && seen >= below)
+      return Latency(i) < max_ ? Latency(i) : max_;
+  }
+  return 0;
+}
+
+string LatencyStats::ReportStats() {
+  char buffer[96];
+  snprintf(buffer, sizeof(buffer),
+           "Lock manager latency ms (txns/p50/p99/max): %d/%.3f/%.3f/%.3f",
+           count_, 1000 * Percentile(50), 1000 * Percentile(99), 1000 * max_);
+  buckets_.assign(kBuckets, 0);
+  count_ = 0;
+  max_ = 0;
+  return string(buffer);
+}
@@ -0,0 +1,52 @@
+// Measures how long txns spend in the lock manager at this node, from the
+// moment they request their locks until they release them, and reports
+// percentiles of that latency. Latencies are counted in buckets 5% apart, so
+// percentiles are accurate to within 5%.
+
+#ifndef _DB_SCHEDULER_LATENCY_STATS_H_
+#define _DB_SCHEDULER_LATENCY_STATS_H_
+
+#include <string>
+#include <tr1/unordered_map>
+#include <vector>
+
+using std::string;
+using std::tr1::unordered_map;
+using std::vector;
+
+class TxnProto;
+
+class LatencyStats {
+ public:
+  LatencyStats();
+
+  // Called when 'txn' requests its locks.
+  void Requested(const TxnProto* txn);
+
+  // Called when 'txn' releases its locks.
+  void Released(const TxnProto* txn);
+
+  // Returns the latency of the 'percentile'-th percentile txn released since
+  // the previous call to ReportStats(), in seconds.
+  double Percentile(double percentile) const;
+
+  // Returns a one-line summary (txn count, median, 99th percentile and max
+  // latency) of the txns released since the previous call.
+  string ReportStats();
+
+ private:
+  // Returns the bucket of 'latency' seconds, and the latency a bucket
+  // stands for.
+  static int Bucket(double latency);
+  static double Latency(int bucket);
+
+  // Request times of txns in the lock manager.
+  unordered_map<const TxnProto*, double> request_times_;
+
+  // Txns released in the current interval, per bucket.
+  vector<int> buckets_;
+  int count_;
+  double max_;
+};
+
+#endif  // _DB_SCHEDULER_LATENCY_STATS_H_
@@ -0,0 +1,69 @@
+// Per-role lock hold time accounting.
+
+#include "scheduler/lock_hold_stats.h"
+
+#include <cstdio>
+
+#include "common/utils.h"
+#include "proto/txn.pb.h"
+
+LockHoldStats::LockHoldStats(int this_node_id) : this_node_id_(this_node_id) {
+  for (int i = 0; i < ROLE_COUNT; i++) {
+    count_[i] = 0;
+    total_time_[i] = 0;
+    max_time_[i] = 0;
+  }
+}
+
+LockHoldStats::Role LockHoldStats::RoleOf(const TxnProto& txn, int node_id) {
+  bool writer = false;
+  bool others = false;
+  for (int i = 0; i < txn.writers_size(); i++) {
+    if (txn.writers(i) == node_id)
+      writer = true;
+    else
+      others = true;
+  }
+  for (int i = 0; i < txn.readers_size(); i++) {
+    if (txn.readers(i) != node_id)
+      others = true;
+  }
+  if (!others)
+    return SINGLE_PARTITION;
+  return writer ? WRITER : READER_ONLY;
+}
+
+void LockHoldStats::Granted(const TxnProto* txn) {
+  grant_times_[txn] = GetTime();
+}
+
+void LockHoldStats::Released(const TxnProto* txn) {
+  unordered_map<const TxnProto*, double>::iterator it = grant_times_.find(txn);
+  if (it == grant_times_.end())
+    return;
+  double held = GetTime() - it->second;
+  grant_times_.erase(it);
+
+  Role role = RoleOf(*txn, this_node_id_);
+  count_[role]++;
+  total_time_[role] += held;
+  if (held > max_time_[role])
+    max_time_[role] = held;
+}
+
+string LockHoldStats::ReportStats() {
+  static const char* kRoleNames[ROLE_COUNT] = {"single-partition", "writer",
+                                               "reader-only"};
+  string output("Lock hold ms (txns/mean/max):");
+  char buffer[96];
+  for (int i = 0; i < ROLE_COUNT; i++) {
+    snprintf(buffer, sizeof(buffer), " %s %d/%.3f/%.3f", kRoleNames[i],
+             count_[i], count_[i] == 0 ? 0 : 1000 * total_time_[i] / count_[i],
+             1000 * max_time_[i]);
+    output.append(buffer);
+    count_[i] = 0;
+    total_time_[i] = 0;
+    max_time_[i] = 0;
+  }
+  return output;
+}
@@ -0,0 +1,54 @@
+// Measures how long txns hold their locks at this node, from the moment the
+// last of their locks is granted until they are released, separately for each
+// role the node can play in a txn. Multi-partition txns for which this node
+// only supplies reads should release almost immediately; writers hold their
+// locks until the remote reads they need have arrived and they have executed.
+
+#ifndef _DB_SCHEDULER_LOCK_HOLD_STATS_H_
+#define _DB_SCHEDULER_LOCK_HOLD_STATS_H_
+
+#include <string>
+#include <tr1/unordered_map>
+
+using std::string;
+using std::tr1::unordered_map;
+
+class TxnProto;
+
+class LockHoldStats {
+ public:
+  enum Role {
+    SINGLE_PARTITION,  // Only this node participates in the txn.
+    WRITER,            // Multi-partition txn that writes at this node.
+    READER_ONLY,       // Multi-partition txn this node only reads for.
+    ROLE_COUNT
+  };
+
+  explicit LockHoldStats(int this_node_id);
+
+  // Returns the role node 'node_id' plays in 'txn'.
+  static Role RoleOf(const TxnProto& txn, int node_id);
+
+  // Called when 'txn' has been granted all of its locks.
+  void Granted(const TxnProto* txn);
+
+  // Called when 'txn' releases its locks.
+  void Released(const TxnProto* txn);
+
+  // Returns a one-line summary (txn count, mean and max hold time per role)
+  // of the txns released since the previous call.
+  string ReportStats();
+
+ private:
+  int this_node_id_;
+
+  // Grant times of txns currently holding their locks.
+  unordered_map<const TxnProto*, double> grant_times_;
+
+  // Counters for the current reporting interval.
+  int count_[ROLE_COUNT];
+  double total_time_[ROLE_COUNT];
+  double max_time_[ROLE_COUNT];
+};
+
+#endif  // _DB_SCHEDULER_LOCK_HOLD_STATS_H_
@@ -0,0 +1,87 @@
+// Key to counter slot mapping for the VLL lock manager.
+
+#include "scheduler/lock_slots.h"
+
+#include <cassert>
+
+#include "common/utils.h"
+
+LockSlots::LockSlots(Mode mode, int dense_ids)
+    : mode_(mode), dense_ids_(mode == EXACT ? dense_ids : 0),
+      size_(dense_ids_ + LOCK_TABLE_SIZE), assigned_(0) {
+  if (mode_ == EXACT)
+    hashes_.resize(LOCK_TABLE_SIZE, FREE);
+}
+
+int LockSlots::Acquire(const Key& key) {
+  int slot;
+  uint64 hash;
+  if (Fixed(key, &slot, &hash))
+    return slot;
+  return Acquire(hash);
+}
+
+bool LockSlots::Fixed(const Key& key, int* slot, uint64* hash) const {
+  if (mode_ == HASHED) {
+    *slot = FnvHash(key) % LOCK_TABLE_SIZE;
+    return true;
+  }
+
+  // Plain ids (no leading zeros, so that each id has one key) are their own
+  // slots.
+  if (!key.empty() && key.size() <= 9 && (key[0] != '0' || key.size() == 1)) {
+    int id = 0;
+    size_t i = 0;
+    while (i < key.size() && key[i] >= '0' && key[i] <= '9')
+      id = id * 10 + (key[i++] - '0');
+    if (i == key.size() && id < dense_ids_) {
+      *slot = id;
+      return true;
+    }
+  }
+
+  *hash = FnvHash(key);
+  if (*hash == FREE || *hash == RELEASED)
+    *hash = 2;
+  return false;
+}
+
+int LockSlots::Acquire(uint64 hash) {
+  int released = -1;
+  int slot = hash % LOCK_TABLE_SIZE;
+  for (int probes = 0; probes < LOCK_TABLE_SIZE; probes++) {
+    if (hashes_[slot] == hash)
+      return dense_ids_ + slot;
+    if (hashes_[slot] == RELEASED && released == -1)
+      released = slot;
+    if (hashes_[slot] == FREE)
+      break;
+    slot = (slot + 1) % LOCK_TABLE_SIZE;
+  }
+
+  // The key has no slot yet. Take the first reusable one on its way.
+  if (released != -1)
+    slot = released;
+  // Every key in flight needs a slot of its own.
+  assert(hashes_[slot] == FREE || hashes_[slot] == RELEASED);
+  hashes_[slot] = hash;
+  assigned_++;
+  return dense_ids_ + slot;
+}
+
+void LockSlots::Release(int slot) {
+  if (mode_ == HASHED || slot < dense_ids_)
+    return;
+  slot -= dense_ids_;
+  hashes_[slot] = RELEASED;
+  assigned_--;
+
+  // At the end of a probe run, this and the released slots before it no
+  // longer lead lookups on to anything.
+  if (hashes_[(slot + 1) % LOCK_TABLE_SIZE] == FREE) {
+    while (hashes_[slot] == RELEASED) {
+      hashes_[slot] = FREE;
+      slot = (slot + LOCK_TABLE_SIZE - 1) % LOCK_TABLE_SIZE;
+    }
+  }
+}
@@ -0,0 +1,77 @@
+// Maps the keys the VLL lock manager locks to slots of its counter arrays.
+//
+// HASHED slots are FNV hashes modulo LOCK_TABLE_SIZE: cheap and stateless, but
+// keys whose hashes collide share counters and block each other although
+// they do not conflict. The more keys the database has, the more such phantom
+// conflicts there are.
+//
+// EXACT slots are distinct for every key in flight. Keys that are plain ids
+// below 'dense_ids' (e.g. the microbenchmark's) index the first 'dense_ids'
+// slots directly. Any other key claims one of the LOCK_TABLE_SIZE slots after
+// those when it is first locked, and gives it back once no queued txn locks it
+// any more. Those slots form an open addressing table: a key takes the first
+// slot from its hash onwards that is free or its own, so it usually gets the
+// same slot as with HASHED and the counter array is the hash table. Slots of
+// keys in flight never move, as queued txns refer to them; freed slots are
+// tombstones until the end of their probe run is free as well.
+//
+// Keys are told apart by their full 64-bit hash, which keeps the table to one
+// word per slot. Two keys in flight sharing one only makes them conflict, as
+// with HASHED, and at 500K keys in flight that happens with odds of ~1e-8.
+
+#ifndef _DB_SCHEDULER_LOCK_SLOTS_H_
+#define _DB_SCHEDULER_LOCK_SLOTS_H_
+
+#include <vector>
+
+#include "common/definitions.hh"
+#include "common/types.h"
+
+using std::vector;
+
+class LockSlots {
+ public:
+  enum Mode { HASHED, EXACT };
+
+  LockSlots(Mode mode, int dense_ids);
+
+  // Number of slots counter arrays must have.
+  int size() const { return size_; }
+
+  // Returns the slot of 'key', assigning it one if it has none.
+  int Acquire(const Key& key);
+
+  // Returns true and sets '*slot' if the slot of 'key' does not depend on
+  // which keys are in flight (HASHED slots and dense ids), so that it can be
+  // looked up without touching the table. Otherwise sets '*hash' to what
+  // Acquire() needs to find or assign the key's slot.
+  bool Fixed(const Key& key, int* slot, uint64* hash) const;
+
+  // Returns the slot of the key whose hash Fixed() returned, assigning it one
+  // if it has none.
+  int Acquire(uint64 hash);
+
+  // True if 'slot' is a fixed slot, which need not be released.
+  bool fixed(int slot) const { return mode_ == HASHED || slot < dense_ids_; }
+
+  // Called once no queued txn locks the key in 'slot' any more.
+  void Release(int slot);
+
+  // Number of keys currently holding a (non-dense) slot.
+  int assigned() const { return assigned_; }
+
+ private:
+  // Hashes of unassigned slots. Keys hashing to these use 2 instead.
+  enum { FREE = 0, RELEASED = 1 };
+
+  Mode mode_;
+  int dense_ids_;
+  int size_;
+
+  // Hash of the key in every slot above 'dense_ids_' (indexed by slot -
+  // dense_ids_).
+  vector<uint64> hashes_;
+  int assigned_;
+};
+
+#endif  // _DB_SCHEDULER_LOCK_SLOTS_H_
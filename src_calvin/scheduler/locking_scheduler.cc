@@ -0,0 +1,303 @@
+// Author: Kun Ren (kun@cs.yale.edu)
+// Author: Alexander Thomson (thomson@cs.yale.edu)
+//
+// What the deterministic locking schedulers have in common: the workers that
+// execute txns holding all their locks, and the batch, migration and
+// checkpoint handling of the lock manager thread.
+
+#include "scheduler/locking_scheduler.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <tr1/unordered_map>
+#include <utility>
+#include <sched.h>
+
+#include "applications/application.h"
+#include "common/configuration.h"
+#include "common/utils.h"
+#include "common/connection.h"
+#include "common/definitions.hh"
+#include "backend/storage.h"
+#include "backend/storage_manager.h"
+#include "proto/message.pb.h"
+#include "proto/txn.pb.h"
+#include "scheduler/batch_merger.h"
+#include "scheduler/checkpointer.h"
+#include "scheduler/lock_hold_stats.h"
+#include "scheduler/partition_migrator.h"
+#include "scheduler/txn_restarter.h"
+
+#include "common/debug.hh"
+
+using std::pair;
+using std::string;
+using std::tr1::unordered_map;
+
+LockingScheduler::LockingScheduler(Configuration* conf,
+                                   Connection* batch_connection,
+                                   Storage* storage,
+                                   const Application* application,
+                                   int checkpoint_interval)
+    : configuration_(conf),
+      batch_connection_(batch_connection),
+      storage_(storage),
+      application_(application),
+      batch_message_(NULL),
+      batch_offset_(0),
+      batch_number_(0),
+      migrating_(false),
+      txns_(0),
+      report_time_(0) {
+  txns_queue = new AtomicQueue<TxnProto*>();
+  done_queue = new AtomicQueue<TxnProto*>();
+  batch_merger_ =
+      new BatchMerger(configuration_->all_nodes.size(), batch_connection_);
+  migrator_ = new PartitionMigrator(
+      configuration_,
+      batch_connection_->multiplexer()->NewConnection("migration"), storage_);
+  checkpointer_ = new Checkpointer(storage_, checkpoint_interval);
+  restarter_ = new TxnRestarter(configuration_, application_);
+
+  for (int i = 0; i < NUM_WORKERS; i++) {
+    message_queues[i] = new AtomicQueue<MessageProto>();
+  }
+}
+
+LockingScheduler::~LockingScheduler() {}
+
+void LockingScheduler::Start() {
+  Spin(1);
+
+  // start lock manager thread
+  cpu_set_t cpuset;
+  pthread_attr_t attr1;
+  pthread_attr_init(&attr1);
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(LOCK_MANAGER_CORE, &cpuset);
+  pthread_attr_setaffinity_np(&attr1, sizeof(cpu_set_t), &cpuset);
+  pthread_create(&lock_manager_thread_, &attr1, LockManagerThread,
+                 reinterpret_cast<void*>(this));
+
+  // Start all worker threads.
+  for (int i = 0; i < NUM_WORKERS; i++) {
+    string channel("scheduler");
+    channel.append(IntToString(i));
+    thread_connections_[i] = batch_connection_->multiplexer()->NewConnection(
+        channel, &message_queues[i]);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    CPU_ZERO(&cpuset);
+    CPU_SET(GET_WORKER_CORE(i), &cpuset);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset);
+
+    pthread_create(&(threads_[i]), &attr, RunWorkerThread,
+                   reinterpret_cast<void*>(
+                       new pair<int, LockingScheduler*>(i, this)));
+  }
+}
+
+void LockingScheduler::Done(TxnProto* txn) {
+  done_queue->Push(txn);
+}
+
+void* LockingScheduler::RunWorkerThread(void* arg) {
+  int thread =
+      reinterpret_cast<pair<int, LockingScheduler*>*>(arg)->first;
+  LockingScheduler* scheduler =
+      reinterpret_cast<pair<int, LockingScheduler*>*>(arg)->second;
+
+  unordered_map<string, StorageManager*> active_txns;
+  StorageManagerPool managers(scheduler->configuration_,
+                              scheduler->thread_connections_[thread],
+                              scheduler->storage_);
+
+  PrintCpu("Worker", thread);
+
+  // Begin main loop.
+  MessageProto message;
+  while (true) {
+    bool got_message = scheduler->message_queues[thread]->Pop(&message);
+    if (got_message == true) {
+      // Remote read result.
+      assert(message.type() == MessageProto::READ_RESULT);
+      StorageManager* manager = active_txns[message.destination_channel()];
+      manager->HandleReadResult(message);
+      if (manager->ReadyToExecute()) {
+        // Execute and clean up.
+        TxnProto* txn = manager->txn_;
+        scheduler->restarter_->Executed(
+            *txn, scheduler->application_->Execute(txn, manager),
+            scheduler->thread_connections_[thread]);
+        managers.Release(manager);
+
+        scheduler->thread_connections_[thread]->UnlinkChannel(
+            IntToString(txn->txn_id()));
+        active_txns.erase(message.destination_channel());
+        // Respond to scheduler;
+        scheduler->Done(txn);
+      }
+    } else {
+      // No remote read result found, start on the next group of ready txns.
+      // Txns in txns_queue already hold all their locks, so the group cannot
+      // conflict. Managers (and with them all local storage lookups) are set
+      // up for the whole group and their objects prefetched before the first
+      // body runs, overlapping the memory accesses of later txns with the
+      // execution of earlier ones.
+      StorageManager* group[WORKER_BATCH_SIZE];
+      int group_size = 0;
+      TxnProto* txn;
+      while (group_size < WORKER_BATCH_SIZE &&
+             scheduler->txns_queue->Pop(&txn)) {
+        StorageManager* manager = managers.Get(txn);
+        if (!manager->Executes()) {
+          // This node only supplies reads to the txn's writers, and setting
+          // up the manager has already sent them. Skip execution and hand the
+          // txn straight back so that its locks are released now.
+          managers.Release(manager);
+          scheduler->Done(txn);
+          continue;
+        }
+        manager->PrefetchObjects();
+        group[group_size++] = manager;
+      }
+
+      // The data of each txn's objects is prefetched one txn ahead of its
+      // execution, when the objects themselves have arrived.
+      if (group_size > 0)
+        group[0]->PrefetchValues();
+      for (int i = 0; i < group_size; i++) {
+        StorageManager* manager = group[i];
+        txn = manager->txn_;
+        if (i + 1 < group_size)
+          group[i + 1]->PrefetchValues();
+
+        // Writes occur at this node.
+        if (manager->ReadyToExecute()) {
+          // No remote reads. Execute and clean up.
+          scheduler->restarter_->Executed(
+              *txn, scheduler->application_->Execute(txn, manager),
+              scheduler->thread_connections_[thread]);
+          managers.Release(manager);
+
+          // Respond to scheduler;
+          scheduler->Done(txn);
+        } else {
+          scheduler->thread_connections_[thread]->LinkChannel(
+              IntToString(txn->txn_id()));
+          // There are outstanding remote reads.
+          active_txns[IntToString(txn->txn_id())] = manager;
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
+void* LockingScheduler::LockManagerThread(void* arg) {
+  PrintCpu("Lock Manager", 0);
+
+  LockingScheduler* scheduler = reinterpret_cast<LockingScheduler*>(arg);
+  scheduler->report_time_ = GetTime();
+  scheduler->RunLockManager();
+  return NULL;
+}
+
+void LockingScheduler::LoadBatch(int active) {
+  batch_message_ = batch_merger_->GetBatch(batch_number_);
+  if (batch_message_ != NULL) {
+    migrating_ = migrator_->MigrationPending(batch_number_);
+    if (!migrating_)
+      checkpointer_->BatchLoaded(batch_number_, active);
+  }
+}
+
+bool LockingScheduler::HandleBatch(int active, bool holding) {
+  // Have we run out of txns in our batch? Let's get some new ones.
+  if (batch_message_ == NULL) {
+    LoadBatch(active);
+    return false;
+  }
+
+  // The partitioning changes with this batch. Let every txn of earlier
+  // batches finish before moving data and switching over.
+  if (migrating_) {
+    if (active == 0) {
+      migrator_->Migrate(batch_number_);
+      migrating_ = false;
+    }
+    return false;
+  }
+
+  // Done with current batch, get next.
+  if (batch_offset_ >= batch_message_->data_size() && !holding) {
+    migrator_->BatchDone(batch_number_);
+    batch_offset_ = 0;
+    batch_number_++;
+    delete batch_message_;
+    LoadBatch(active);
+    return false;
+  }
+  return true;
+}
+
+string* LockingScheduler::NextTxnData() {
+  if (batch_message_ == NULL || migrating_ ||
+      batch_offset_ >= batch_message_->data_size())
+    return NULL;
+  return batch_message_->mutable_data(batch_offset_++);
+}
+
+TxnProto* LockingScheduler::NextTxn() {
+  string* data;
+  while ((data = NextTxnData()) != NULL) {
+    TxnProto* txn = new TxnProto();
+    txn->ParseFromString(*data);
+    if (!RegisterMigration(txn))
+      return txn;
+  }
+  return NULL;
+}
+
+bool LockingScheduler::RegisterMigration(TxnProto* txn) {
+  if (!txn->has_migration())
+    return false;
+  migrator_->Register(*txn, batch_number_);
+  delete txn;
+  return true;
+}
+
+void LockingScheduler::Finish(TxnProto* txn) {
+  checkpointer_->TxnDone(*txn);
+
+  // Txns are counted once, by one of the nodes that execute them.
+  if (LockHoldStats::RoleOf(*txn, configuration_->this_node_id) !=
+          LockHoldStats::READER_ONLY &&
+      (txn->writers_size() == 0 || rand() % txn->writers_size() == 0))
+    txns_++;
+
+  delete txn;
+}
+
+bool LockingScheduler::ReportDue() {
+  return GetTime() > report_time_ + 1;
+}
+
+void LockingScheduler::Report(const string& lock_stats) {
+  double total_time = GetTime() - report_time_;
+  string checkpoint_output = checkpointer_->ReportStats(txns_, total_time);
+  if (!checkpoint_output.empty())
+    checkpoint_output.append("\n");
+
+  std::cout << "Completed " << (static_cast<double>(txns_) / total_time)
+            << " txns/sec, " << lock_stats << "\n"
+            << batch_merger_->ReportStats() << "\n"
+            << restarter_->ReportStats() << "\n"
+            << checkpoint_output << std::flush;
+  // Reset txn count.
+  report_time_ = GetTime();
+  txns_ = 0;
+}
@@ -0,0 +1,148 @@
+// Author: Alexander Thomson (thomson@cs.yale.edu)
+// Author: Kun Ren (kun.ren@yale.edu)
+//
+// What the deterministic locking schedulers (DeterministicScheduler,
+// PdlrScheduler and VllScheduler) have in common. Worker threads execute txns
+// once they hold all their locks and hand them back when done. A lock manager
+// thread takes the batches of the global order in turn, switches the
+// partitioning when migration txns take effect (see partition_migrator.h) and
+// checkpoints the storage between batches (see checkpointer.h). The schedulers
+// only differ in how their lock manager thread acquires and releases locks
+// (RunLockManager()), which it does with the helpers below.
+
+#ifndef _DB_SCHEDULER_LOCKING_SCHEDULER_H_
+#define _DB_SCHEDULER_LOCKING_SCHEDULER_H_
+
+#include <pthread.h>
+
+#include <string>
+
+#include "scheduler/scheduler.h"
+#include "common/utils.h"
+#include "common/definitions.hh"
+#include "proto/message.pb.h"
+
+using std::string;
+
+class BatchMerger;
+class Checkpointer;
+class Configuration;
+class Connection;
+class PartitionMigrator;
+class Storage;
+class TxnProto;
+class TxnRestarter;
+
+class LockingScheduler : public Scheduler {
+ public:
+  virtual ~LockingScheduler();
+
+ protected:
+  LockingScheduler(Configuration* conf,
+                   Connection* batch_connection,
+                   Storage* storage,
+                   const Application* application,
+                   int checkpoint_interval);
+
+  // Starts the lock manager thread and the workers. Called by the scheduler
+  // once it is constructed.
+  void Start();
+
+  // The lock manager thread's main loop. Pushes txns to 'txns_queue' once they
+  // hold all their locks, and releases the locks of those handed back.
+  virtual void RunLockManager() = 0;
+
+  // Hands 'txn' back from a worker once this node is done with it. Pushes it
+  // to 'done_queue' unless overridden.
+  virtual void Done(TxnProto* txn);
+
+  // Takes a step through the batches: loads the current batch, applies the
+  // migration due with it once the 'active' txns of earlier batches still
+  // holding or waiting for locks have finished, or moves on to the next batch
+  // once every txn of this one was taken and the scheduler is not 'holding'
+  // any of them back. Returns true if there was nothing to do, and the txns
+  // of the current batch can be taken.
+  bool HandleBatch(int active, bool holding);
+
+  // Returns the next txn of the current batch in its serialized form, or NULL
+  // if the batch is not loaded, waits for a migration, or was all taken.
+  string* NextTxnData();
+
+  // Like NextTxnData(), but parses the txn, which the caller takes ownership
+  // of. Migration txns are registered instead of returned.
+  TxnProto* NextTxn();
+
+  // If 'txn' is a migration txn, registers it with the migrator, deletes it
+  // and returns true. Migration txns take no locks; they only schedule the
+  // switch.
+  bool RegisterMigration(TxnProto* txn);
+
+  // Counts 'txn', whose locks were released, towards the throughput and the
+  // checkpoint, and deletes it.
+  void Finish(TxnProto* txn);
+
+  // Returns true once a second, when Report() is due.
+  bool ReportDue();
+
+  // Prints the throughput since the last report, followed by 'lock_stats' and
+  // the reports of the components shared by all schedulers.
+  void Report(const string& lock_stats);
+
+  // Configuration specifying node & system settings.
+  Configuration* configuration_;
+
+  // Queue of txns that hold all their locks, for the workers to execute.
+  AtomicQueue<TxnProto*>* txns_queue;
+
+  // Txns handed back by the workers (see Done()).
+  AtomicQueue<TxnProto*>* done_queue;
+
+ private:
+  // Function for starting main loops in a separate pthreads.
+  static void* RunWorkerThread(void* arg);
+  static void* LockManagerThread(void* arg);
+
+  // Loads batch 'batch_number_' and checks whether a migration is due with
+  // it, with 'active' txns of earlier batches left.
+  void LoadBatch(int active);
+
+  // Thread contexts and their associated Connection objects.
+  pthread_t threads_[NUM_WORKERS];
+  Connection* thread_connections_[NUM_WORKERS];
+
+  pthread_t lock_manager_thread_;
+  // Connection for receiving txn batches from sequencer.
+  Connection* batch_connection_;
+
+  // Merges the batches arriving from all sequencers into the global order.
+  BatchMerger* batch_merger_;
+
+  // Switches the partitioning when migration txns take effect.
+  PartitionMigrator* migrator_;
+
+  // Checkpoints the storage every 'checkpoint_interval' batches.
+  Checkpointer* checkpointer_;
+
+  // Storage layer used in application execution.
+  Storage* storage_;
+
+  // Application currently being run.
+  const Application* application_;
+
+  // Orders mispredicted dependent txns again, shared by the workers.
+  TxnRestarter* restarter_;
+
+  AtomicQueue<MessageProto>* message_queues[NUM_WORKERS];
+
+  // The current batch, the next of its txns to take, and whether it waits
+  // for a migration. Owned by the lock manager thread.
+  MessageProto* batch_message_;
+  int batch_offset_;
+  int batch_number_;
+  bool migrating_;
+
+  // Txns finished since the last report, and when that was.
+  int txns_;
+  double report_time_;
+};
+#endif  // _DB_SCHEDULER_LOCKING_SCHEDULER_H_
@@ -0,0 +1,141 @@
+// Deterministic migration of key ranges between partitions.
+
+#include "scheduler/partition_migrator.h"
+
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+
+#include "backend/storage.h"
+#include "common/configuration.h"
+#include "common/connection.h"
+#include "common/definitions.hh"
+#include "common/utils.h"
+#include "proto/message.pb.h"
+#include "proto/txn.pb.h"
+
+PartitionMigrator::PartitionMigrator(Configuration* config,
+                                     Connection* connection, Storage* storage)
+    : configuration_(config), connection_(connection), storage_(storage) {}
+
+PartitionMigrator::~PartitionMigrator() {
+  for (map<int64, vector<MessageProto*> >::iterator it =
+           early_messages_.begin();
+       it != early_messages_.end(); ++it)
+    for (size_t i = 0; i < it->second.size(); i++)
+      delete it->second[i];
+}
+
+void PartitionMigrator::Register(const TxnProto& txn, int64 batch) {
+  const MigrationProto& migration = txn.migration();
+  if (migration.node() < 0 ||
+      migration.node() >= static_cast<int>(configuration_->all_nodes.size())) {
+    std::cout << "Ignoring migration to unknown node " << migration.node()
+              << "\n" << std::flush;
+    return;
+  }
+  char table = migration.table().empty() ? '\0' : migration.table()[0];
+  configuration_->AddMigration(batch + configuration_->migration_lead(), table,
+                               migration.first_id(), migration.last_id(),
+                               migration.node());
+}
+
+void PartitionMigrator::BatchDone(int64 batch) {
+  configuration_->set_migrations_known_through(batch);
+}
+
+bool PartitionMigrator::MigrationPending(int64 batch) {
+  return configuration_->PendingPartitionMap(batch) != NULL;
+}
+
+void PartitionMigrator::Migrate(int64 batch) {
+  double start = GetTime();
+  int this_node_id = configuration_->this_node_id;
+  const PartitionMap* next = configuration_->PendingPartitionMap(batch);
+
+  // One message to every other node, even if empty, so that each node knows
+  // when it has received everything.
+  map<int, MessageProto> messages;
+  for (map<int, Node*>::iterator it = configuration_->all_nodes.begin();
+       it != configuration_->all_nodes.end(); ++it) {
+    if (it->first == this_node_id)
+      continue;
+    MessageProto* message = &messages[it->first];
+    message->set_destination_node(it->first);
+    message->set_destination_channel("migration");
+    message->set_source_node(this_node_id);
+    message->set_type(MessageProto::MIGRATION_DATA);
+    message->set_batch_number(batch);
+  }
+
+  // Going on without the objects this node gives up would lose them.
+  vector<Key> keys;
+  if (!storage_->ListKeys(&keys)) {
+    std::cerr << "Storage cannot list its objects, cannot migrate at batch "
+              << batch << "\n";
+    exit(EXIT_FAILURE);
+  }
+
+  // Objects leave and arrive as of the last txn before 'batch', so that a
+  // pending checkpoint still holds the objects this node owned until then.
+  int64 txn_id = batch * MAX_LOCK_BATCH_SIZE - 1;
+  int sent = 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    const Key& key = keys[i];
+    if (configuration_->LookupPartition(key) != this_node_id)
+      continue;
+    int owner = next->Lookup(key);
+    if (owner == this_node_id)
+      continue;
+    // The storage frees the value itself once it is deleted.
+    Value* value = storage_->ReadObject(key, LLONG_MAX);
+    messages[owner].add_keys(key);
+    messages[owner].add_values(*value);
+    storage_->DeleteObject(key, txn_id);
+    sent++;
+  }
+  for (map<int, MessageProto>::iterator it = messages.begin();
+       it != messages.end(); ++it)
+    connection_->Send(it->second);
+
+  // Collect the objects this node gains.
+  int received = 0;
+  int pending = messages.size();
+  map<int64, vector<MessageProto*> >::iterator early =
+      early_messages_.find(batch);
+  if (early != early_messages_.end()) {
+    for (size_t i = 0; i < early->second.size(); i++) {
+      received += Apply(*early->second[i], txn_id);
+      delete early->second[i];
+      pending--;
+    }
+    early_messages_.erase(early);
+  }
+  while (pending > 0) {
+    MessageProto* message = new MessageProto();
+    if (!connection_->GetMessage(message)) {
+      delete message;
+      Spin(0.001);
+      continue;
+    }
+    assert(message->type() == MessageProto::MIGRATION_DATA);
+    if (message->batch_number() != batch) {
+      early_messages_[message->batch_number()].push_back(message);
+      continue;
+    }
+    received += Apply(*message, txn_id);
+    delete message;
+    pending--;
+  }
+
+  configuration_->InstallPartitionMap(batch);
+  std::cout << "Repartitioned at batch " << batch << ": sent " << sent
+            << " objects, received " << received << " objects in "
+            << (GetTime() - start) * 1000 << " ms\n" << std::flush;
+}
+
+int PartitionMigrator::Apply(const MessageProto& message, int64 txn_id) {
+  for (int i = 0; i < message.keys_size(); i++)
+    storage_->PutObject(message.keys(i), new Value(message.values(i)), txn_id);
+  return message.keys_size();
+}
@@ -0,0 +1,77 @@
+// Online repartitioning. A migration is a txn like any other: a client hands
+// it to its sequencer (Sequencer::SubmitMigration), it gets ordered into some
+// batch M and is sent to every node. The move takes effect at batch
+// E = M + Configuration::migration_lead() on all nodes:
+//
+//  - Each scheduler registers the migration when it reaches it in batch M and
+//    from then on reports how far it has seen migrations
+//    (Configuration::migrations_known_through).
+//  - Sequencers route batch b with the partitioning for b, and do not route it
+//    before all migrations up to batch b - lead are known locally. The lead
+//    guarantees that any migration effective at or before b has been seen.
+//  - Each scheduler stops admitting txns when it reaches batch E until every
+//    earlier txn has completed. It then sends every object whose owner changes
+//    to its new owner, waits for the objects it gains from the other nodes and
+//    installs the new partitioning before it locks the first txn of batch E.
+//
+// Since every node switches between the same two batches of the global order,
+// each txn runs under a single partitioning everywhere.
+
+#ifndef _DB_SCHEDULER_PARTITION_MIGRATOR_H_
+#define _DB_SCHEDULER_PARTITION_MIGRATOR_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common/types.h"
+
+using std::map;
+using std::string;
+using std::vector;
+
+class Configuration;
+class Connection;
+class MessageProto;
+class Storage;
+class TxnProto;
+
+class PartitionMigrator {
+ public:
+  // Exchanges migrated objects over 'connection', which must be bound to the
+  // "migration" channel.
+  PartitionMigrator(Configuration* config, Connection* connection,
+                    Storage* storage);
+  ~PartitionMigrator();
+
+  // Registers the migration txn 'txn' found in batch 'batch'.
+  void Register(const TxnProto& txn, int64 batch);
+
+  // Called once every txn of 'batch' has been handed to the lock manager.
+  void BatchDone(int64 batch);
+
+  // Returns true if the partitioning changes at 'batch'. The scheduler must
+  // then complete all txns of earlier batches and call Migrate(batch) before
+  // it admits any txn of 'batch'.
+  bool MigrationPending(int64 batch);
+
+  // Moves the objects whose owner changes at 'batch' and installs the new
+  // partitioning. Blocks until all other nodes have sent their objects. Exits
+  // if the storage cannot list its objects, rather than drop them.
+  void Migrate(int64 batch);
+
+ private:
+  // Stores the objects carried by a MIGRATION_DATA message as written by txn
+  // 'txn_id'.
+  int Apply(const MessageProto& message, int64 txn_id);
+
+  Configuration* configuration_;
+  Connection* connection_;
+  Storage* storage_;
+
+  // MIGRATION_DATA messages from nodes that already moved on to a later
+  // migration than the one this node is working on.
+  map<int64, vector<MessageProto*> > early_messages_;
+};
+
+#endif  // _DB_SCHEDULER_PARTITION_MIGRATOR_H_
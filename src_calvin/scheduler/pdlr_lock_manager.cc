@@ -4,7 +4,7 @@
 // Lock manager implementing deterministic two-phase locking as described in
 // 'The Case for Determinism in Database Systems'.
 
-#include "scheduler/deterministic_lock_manager.h"
+#include "scheduler/pdlr_lock_manager.h"
 
 #include <vector>
 
@@ -12,24 +12,28 @@
 
 using std::vector;
 
-DeterministicLockManager::DeterministicLockManager(
-    AtomicQueue<TxnProto*>* txns_queue,
-    Configuration* config)
-    : configuration_(config), txns_queue_(txns_queue) {
+PdlrLockManager::PdlrLockManager(AtomicQueue<TxnProto*>* txns_queue,
+                                 Configuration* config)
+    : configuration_(config),
+      txns_queue_(txns_queue),
+      hold_stats_(config->this_node_id),
+      advisor_(config),
+      contention_(LOCK_TABLE_SIZE) {
   for (int i = 0; i < LOCK_TABLE_SIZE; i++)
     lock_table_[i] = new deque<KeysList>();
 }
 
-int DeterministicLockManager::Lock(TxnProto* txn) {
-  txn->set_is_contented(false);
-
+int PdlrLockManager::Lock(TxnProto* txn) {
+  latency_.Requested(txn);
+  bool contended = false;
   int not_acquired = 0;
 
   // Handle read/write lock requests.
   for (int i = 0; i < txn->read_write_set_size(); i++) {
     // Only lock local keys.
     if (IsLocal(txn->read_write_set(i))) {
-      deque<KeysList>* key_requests = lock_table_[Hash(txn->read_write_set(i))];
+      int entry = Hash(txn->read_write_set(i));
+      deque<KeysList>* key_requests = lock_table_[entry];
 
       deque<KeysList>::iterator it;
       for (it = key_requests->begin();
@@ -48,14 +52,13 @@ int DeterministicLockManager::Lock(TxnProto* txn) {
       if (requests->empty() || txn != requests->back().txn) {
         requests->push_back(LockRequest(WRITE, txn));
         // Write lock request fails if there is any previous request at all.
-        if (requests->size() > 1) {
+        int queued = requests->size() - 1;
+        if (queued > 0) {
           not_acquired++;
-          it->failed_cnt_++;
+          advisor_.RecordWait(txn->read_write_set(i));
         }
-      }
-
-      if (MAX_FAILED_LOCK < it->failed_cnt_) {
-        txn->set_is_contented(true);
+        if (contention_.Record(entry, queued))
+          contended = true;
       }
     }
   }
@@ -65,7 +68,8 @@ int DeterministicLockManager::Lock(TxnProto* txn) {
   for (int i = 0; i < txn->read_set_size(); i++) {
     // Only lock local keys.
     if (IsLocal(txn->read_set(i))) {
-      deque<KeysList>* key_requests = lock_table_[Hash(txn->read_set(i))];
+      int entry = Hash(txn->read_set(i));
+      deque<KeysList>* key_requests = lock_table_[entry];
 
       deque<KeysList>::iterator it;
       for (it = key_requests->begin();
@@ -83,34 +87,111 @@ int DeterministicLockManager::Lock(TxnProto* txn) {
       if (requests->empty() || txn != requests->back().txn) {
         requests->push_back(LockRequest(READ, txn));
         // Read lock request fails if there is any previous write request.
+        int queued = 0;
         for (deque<LockRequest>::iterator itr = requests->begin();
              itr != requests->end(); ++itr) {
           if (itr->mode == WRITE) {
             not_acquired++;
-            it->failed_cnt_++;
+            advisor_.RecordWait(txn->read_set(i));
+            queued = requests->size() - 1;
             break;
           }
         }
-      }
-
-      if (MAX_FAILED_LOCK < it->failed_cnt_) {
-        txn->set_is_contented(true);
+        if (contention_.Record(entry, queued))
+          contended = true;
       }
     }
   }
+  txn->set_is_contented(contended);
+  contention_.CountTxn(contended);
 
   // Record and return the number of locks that the txn is blocked on.
   if (not_acquired > 0) {
     txn_waits_[txn] = not_acquired;
     pending_++;
   } else {
+    hold_stats_.Granted(txn);
     txns_queue_->Push(txn);
     executing_++;
   }
   return not_acquired;
 }
 
-void DeterministicLockManager::Release(TxnProto* txn) {
+deque<PdlrLockManager::LockRequest>*
+PdlrLockManager::Requests(const Key& key) {
+  deque<KeysList>* key_requests = lock_table_[Hash(key)];
+  for (deque<KeysList>::iterator it = key_requests->begin();
+       it != key_requests->end(); ++it) {
+    if (it->key == key)
+      return it->locksrequest;
+  }
+  return NULL;
+}
+
+int PdlrLockManager::QueuedAhead(const TxnProto& txn) {
+  int queued = 0;
+  for (int i = 0; i < txn.read_write_set_size(); i++) {
+    if (IsLocal(txn.read_write_set(i))) {
+      deque<LockRequest>* requests = Requests(txn.read_write_set(i));
+      if (requests != NULL)
+        queued += requests->size();
+    }
+  }
+  for (int i = 0; i < txn.read_set_size(); i++) {
+    if (IsLocal(txn.read_set(i))) {
+      // Reads only wait if a write is queued.
+      deque<LockRequest>* requests = Requests(txn.read_set(i));
+      if (requests == NULL)
+        continue;
+      for (deque<LockRequest>::iterator it = requests->begin();
+           it != requests->end(); ++it) {
+        if (it->mode == WRITE) {
+          queued += requests->size();
+          break;
+        }
+      }
+    }
+  }
+  return queued;
+}
+
+int PdlrLockManager::ReleaseBenefit(TxnProto* txn) {
+  int benefit = 0;
+  for (int i = 0; i < txn->read_set_size(); i++)
+    if (IsLocal(txn->read_set(i)))
+      benefit += KeyReleaseBenefit(txn->read_set(i), txn);
+  for (int i = 0; i < txn->read_write_set_size(); i++)
+    if (IsLocal(txn->read_write_set(i)))
+      benefit += KeyReleaseBenefit(txn->read_write_set(i), txn);
+  return benefit;
+}
+
+int PdlrLockManager::KeyReleaseBenefit(const Key& key, TxnProto* txn) {
+  deque<LockRequest>* requests = Requests(key);
+  if (requests == NULL)
+    return 0;
+  deque<LockRequest>::iterator it;
+  for (it = requests->begin(); it != requests->end() && it->txn != txn; ++it) {
+  }
+  if (it == requests->end())
+    return 0;
+
+  // Only the owner's release grants anything. The next request is granted if
+  // the owner wrote or the next one writes (see Release()).
+  int benefit = requests->end() - it - 1;
+  deque<LockRequest>::iterator next = it + 1;
+  if (it == requests->begin() && next != requests->end() &&
+      (it->mode == WRITE || next->mode == WRITE)) {
+    unordered_map<TxnProto*, int>::iterator waits = txn_waits_.find(next->txn);
+    if (waits != txn_waits_.end() && waits->second == 1)
+      benefit += RUNNABLE_WEIGHT;
+  }
+  return benefit;
+}
+
+void PdlrLockManager::Release(TxnProto* txn) {
+  hold_stats_.Released(txn);
+  latency_.Released(txn);
   for (int i = 0; i < txn->read_set_size(); i++)
     if (IsLocal(txn->read_set(i)))
       Release(txn->read_set(i), txn);
@@ -124,7 +205,7 @@ void DeterministicLockManager::Release(TxnProto* txn) {
       Release(txn->read_write_set(i), txn);
 }
 
-void DeterministicLockManager::Release(const Key& key, TxnProto* txn) {
+void PdlrLockManager::Release(const Key& key, TxnProto* txn) {
   // Avoid repeatedly looking up key in the unordered_map.
   deque<KeysList>* key_requests = lock_table_[Hash(key)];
 
@@ -181,6 +262,7 @@ void DeterministicLockManager::Release(const Key& key, TxnProto* txn) {
         if (txn_waits_[new_owners[j]] == 0) {
           // The txn that just acquired the released lock is no longer waiting
           // on any lock requests.
+          hold_stats_.Granted(new_owners[j]);
           txns_queue_->Push(new_owners[j]);
           executing_++;
           pending_--;
@@ -0,0 +1,121 @@
+// Author: Alexander Thomson (thomson@cs.yale.edu)
+// Author: Kun Ren (kun@cs.yale.edu)
+//
+// Lock manager implementing deterministic two-phase locking as described in
+// 'The Case for Determinism in Database Systems', for PdlrScheduler. Unlike
+// DeterministicLockManager it tracks the txns executing and pending, marks
+// txns that wait on contended keys, and ranks txns by how many others their
+// release would unblock.
+
+#ifndef _DB_SCHEDULER_PDLR_LOCK_MANAGER_H_
+#define _DB_SCHEDULER_PDLR_LOCK_MANAGER_H_
+
+#include <deque>
+#include <tr1/unordered_map>
+
+#include "common/configuration.h"
+#include "scheduler/contention_estimator.h"
+#include "scheduler/latency_stats.h"
+#include "scheduler/lock_manager.h"
+#include "scheduler/lock_hold_stats.h"
+#include "scheduler/rebalance_advisor.h"
+#include "common/utils.h"
+#include "common/definitions.hh"
+
+using std::deque;
+using std::tr1::unordered_map;
+
+class TxnProto;
+
+class PdlrLockManager {
+ public:
+  PdlrLockManager(AtomicQueue<TxnProto*>* txns_queue,
+                  Configuration* config);
+  virtual ~PdlrLockManager() {}
+  virtual int Lock(TxnProto* txn);
+  virtual void Release(const Key& key, TxnProto* txn);
+  virtual void Release(TxnProto* txn);
+
+  // Lock hold times of the txns that went through this lock manager.
+  LockHoldStats* hold_stats() { return &hold_stats_; }
+
+  // Time txns spend between requesting and releasing their locks.
+  LatencyStats* latency() { return &latency_; }
+
+  // Per-key lock contention at this node.
+  RebalanceAdvisor* advisor() { return &advisor_; }
+
+  // Contention of each lock table entry, which decides whether a txn is
+  // marked contended.
+  ContentionEstimator* contention() { return &contention_; }
+
+  // Number of earlier requests 'txn' would wait behind if it requested its
+  // locks now, summed over its local keys.
+  int QueuedAhead(const TxnProto& txn);
+
+  // Estimated gain of releasing the locks of 'txn' now: the txns it is the
+  // last lock wait of, weighted by RUNNABLE_WEIGHT, plus the length of the
+  // chains of requests queued behind it.
+  int ReleaseBenefit(TxnProto* txn);
+  enum { RUNNABLE_WEIGHT = 1000 };
+
+  uint64_t pending_ = 0;
+  uint64_t executing_ = 0;
+
+ private:
+  int Hash(const Key& key) { return FnvHash(key) % LOCK_TABLE_SIZE; }
+
+  bool IsLocal(const Key& key) {
+    return configuration_->LookupPartition(key) == configuration_->this_node_id;
+  }
+
+  // Configuration object (needed to avoid locking non-local keys).
+  Configuration* configuration_;
+
+  // The PdlrLockManager's lock table tracks all lock requests. For a
+  // given key, if 'lock_table_' contains a nonempty queue, then the item with
+  // that key is locked and either:
+  //  (a) first element in the queue specifies the owner if that item is a
+  //      request for a write lock, or
+  //  (b) a read lock is held by all elements of the longest prefix of the queue
+  //      containing only read lock requests.
+  // Note: using STL deque rather than queue for erase(iterator position).
+  struct LockRequest {
+    LockRequest(LockMode m, TxnProto* t) : txn(t), mode(m) {}
+    TxnProto* txn;  // Pointer to txn requesting the lock.
+    LockMode mode;  // Specifies whether this is a read or write lock request.
+  };
+
+  struct KeysList {
+    KeysList(Key m, deque<LockRequest>* t) : key(m), locksrequest(t) {}
+    Key key;
+    deque<LockRequest>* locksrequest;
+  };
+
+  deque<KeysList>* lock_table_[LOCK_TABLE_SIZE];
+
+  // Returns the queued requests for 'key', or NULL if there are none.
+  deque<LockRequest>* Requests(const Key& key);
+
+  // Returns the share of ReleaseBenefit() due to 'txn's request for 'key'.
+  int KeyReleaseBenefit(const Key& key, TxnProto* txn);
+
+  // Queue of pointers to transactions that have acquired all locks that
+  // they have requested. 'ready_txns_[key].front()' is the owner of the lock
+  // for a specified key.
+  //
+  // Owned by the PdlrScheduler.
+  // deque<TxnProto*>* ready_txns_;
+  AtomicQueue<TxnProto*>* txns_queue_;
+
+  // Tracks all txns still waiting on acquiring at least one lock. Entries
+  // in 'txn_waits_' are invalided by any call to Release() with the entry's
+  // txn.
+  unordered_map<TxnProto*, int> txn_waits_;
+
+  LockHoldStats hold_stats_;
+  LatencyStats latency_;
+  RebalanceAdvisor advisor_;
+  ContentionEstimator contention_;
+};
+#endif  // _DB_SCHEDULER_PDLR_LOCK_MANAGER_H_
@@ -0,0 +1,116 @@
+// Author: Kun Ren (kun@cs.yale.edu)
+// Author: Alexander Thomson (thomson@cs.yale.edu)
+//
+// The deterministic lock manager implements deterministic locking as described
+// in 'The Case for Determinism in Database Systems', VLDB 2010. Each
+// transaction must request all locks it will ever need before the next
+// transaction in the specified order may acquire any locks. Each lock is then
+// granted to transactions in the order in which they requested them (i.e. in
+// the global transaction order).
+
+#include "scheduler/pdlr_scheduler.h"
+
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "proto/txn.pb.h"
+#include "scheduler/contention_estimator.h"
+#include "scheduler/latency_stats.h"
+#include "scheduler/lock_hold_stats.h"
+#include "scheduler/pdlr_lock_manager.h"
+#include "scheduler/rebalance_advisor.h"
+#include "scheduler/scheduling_policy.h"
+
+using std::string;
+
+PdlrScheduler::PdlrScheduler(Configuration* conf,
+                             Connection* batch_connection,
+                             Storage* storage,
+                             const Application* application,
+                             int checkpoint_interval)
+    : LockingScheduler(conf, batch_connection, storage, application,
+                       checkpoint_interval) {
+  contented_done_queue = new AtomicQueue<TxnProto*>();
+
+  lock_manager_ = new PdlrLockManager(txns_queue, configuration_);
+  policy_ = SchedulingPolicy::Create(PDLR_POLICY);
+  assert(policy_ != NULL);
+  Start();
+}
+
+PdlrScheduler::~PdlrScheduler() {}
+
+void PdlrScheduler::Done(TxnProto* txn) {
+  if (txn->is_contented()) {
+    contented_done_queue->Push(txn);
+  } else {
+    done_queue->Push(txn);
+  }
+}
+
+void PdlrScheduler::RunLockManager() {
+  int tasks[Task::Size] = {0};
+
+  std::string task_names[Task::Size] = {"Locking", "ReleaseUncontentedTx",
+                                        "ReleaseContentedTx"};
+
+  TxnProto* done_txn;
+  // Next txn of the batch, parsed but held back by the policy.
+  TxnProto* next_txn = NULL;
+
+  while (true) {
+    HandleBatch(lock_manager_->executing_ + lock_manager_->pending_,
+                 next_txn != NULL);
+
+    // Lock the next txns of the batch as long as the policy lets them in.
+    while (next_txn != NULL || (next_txn = NextTxn()) != NULL) {
+      if (!policy_->Admit(lock_manager_, *next_txn))
+        break;
+
+      lock_manager_->Lock(next_txn);
+      next_txn = NULL;
+      tasks[Task::Locking]++;
+    }
+
+    while (contented_done_queue->Pop(&done_txn))
+      policy_->Done(done_txn);
+    while (done_queue->Pop(&done_txn))
+      policy_->Done(done_txn);
+
+    while ((done_txn = policy_->NextRelease(lock_manager_)) != NULL) {
+      lock_manager_->executing_--;
+
+      // We have received a finished transaction back, release the lock
+      if (done_txn->is_contented())
+        tasks[Task::ReleaseContentedTx]++;
+      else
+        tasks[Task::ReleaseUncontentedTx]++;
+      lock_manager_->Release(done_txn);
+      Finish(done_txn);
+    }
+
+    // Report throughput.
+    if (ReportDue()) {
+      std::string task_output = "Tasks: ";
+      for (int i = 0; i < Task::Size; i++) {
+        task_output.append(task_names[i] + ": " + std::to_string(tasks[i]) +
+                           ", ");
+      }
+
+      Report(std::to_string(lock_manager_->executing_) + " executing, " +
+             std::to_string(lock_manager_->pending_) + " pending, \n" +
+             task_output + "\n" + "Released " +
+             std::to_string(tasks[Task::ReleaseContentedTx]) +
+             " contended, " +
+             std::to_string(tasks[Task::ReleaseUncontentedTx]) +
+             " uncontended txns. " +
+             lock_manager_->contention()->ReportStats() + "\n" +
+             lock_manager_->hold_stats()->ReportStats() + "\n" +
+             policy_->name() + " policy. " +
+             lock_manager_->latency()->ReportStats() + "\n" +
+             lock_manager_->advisor()->ReportStats());
+      memset(tasks, 0, sizeof(tasks));
+    }
+  }
+}
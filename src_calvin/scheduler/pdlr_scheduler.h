@@ -0,0 +1,53 @@
+// Author: Alexander Thomson (thomson@cs.yale.edu)
+// Author: Kun Ren (kun.ren@yale.edu)
+//
+// Deterministic locking as in DeterministicScheduler (see
+// deterministic_scheduler.h), except that the lock manager thread decides
+// when the next txn requests its locks and when finished txns release theirs
+// (see scheduling_policy.h). Workers hand finished txns back on separate
+// queues for txns that did and did not wait on contended keys, as estimated
+// by the lock manager (see contention_estimator.h).
+
+#ifndef _DB_SCHEDULER_PDLR_SCHEDULER_H_
+#define _DB_SCHEDULER_PDLR_SCHEDULER_H_
+
+#include "scheduler/locking_scheduler.h"
+
+class PdlrLockManager;
+class SchedulingPolicy;
+
+class PdlrScheduler : public LockingScheduler {
+ public:
+  enum Task {
+    Locking,
+    ReleaseUncontentedTx,
+    ReleaseContentedTx,
+    Size
+  };
+
+  PdlrScheduler(Configuration* conf,
+                Connection* batch_connection,
+                Storage* storage,
+                const Application* application,
+                int checkpoint_interval = 0);
+  virtual ~PdlrScheduler();
+
+ private:
+  virtual void RunLockManager();
+
+  // Hands 'txn' back on the queue for whether it was contended.
+  virtual void Done(TxnProto* txn);
+
+  // The per-node lock manager tracks what transactions have temporary ownership
+  // of what database objects, allowing the scheduler to track LOCAL conflicts
+  // and enforce equivalence to transaction orders.
+  PdlrLockManager* lock_manager_;
+
+  // Decides when txns request their locks and when finished ones release
+  // them.
+  SchedulingPolicy* policy_;
+
+  // Finished txns that did not wait on contended keys go to 'done_queue'.
+  AtomicQueue<TxnProto*>* contented_done_queue;
+};
+#endif  // _DB_SCHEDULER_PDLR_SCHEDULER_H_
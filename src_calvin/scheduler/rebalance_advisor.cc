@@ -0,0 +1,74 @@
+// Contention-driven migration suggestions.
+
+#include "scheduler/rebalance_advisor.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "common/configuration.h"
+#include "common/definitions.hh"
+#include "common/partitioner.h"
+
+using std::pair;
+using std::vector;
+
+static const int kIdBits = 56;
+
+RebalanceAdvisor::RebalanceAdvisor(const Configuration* config)
+    : configuration_(config), total_waits_(0) {}
+
+void RebalanceAdvisor::RecordWait(const Key& key) {
+  char table;
+  int64 id;
+  PartitionMap::ParseKey(key, &table, &id);
+  uint64 unit = (static_cast<uint64>(static_cast<unsigned char>(table))
+                 << kIdBits) |
+                (static_cast<uint64>(id) & ((1ULL << kIdBits) - 1));
+  waits_[unit]++;
+  total_waits_++;
+}
+
+string RebalanceAdvisor::ReportStats() {
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer), "Lock waits: %d", total_waits_);
+  string output(buffer);
+
+  if (total_waits_ > 0) {
+    vector<pair<int, uint64> > hottest;
+    for (unordered_map<uint64, int>::const_iterator it = waits_.begin();
+         it != waits_.end(); ++it)
+      hottest.push_back(std::make_pair(it->second, it->first));
+    int count = std::min(static_cast<int>(hottest.size()), REBALANCE_HOT_KEYS);
+    std::partial_sort(hottest.begin(), hottest.begin() + count, hottest.end(),
+                      std::greater<pair<int, uint64> >());
+
+    // Keep the hottest unit here and deal the others out to the other nodes
+    // round-robin, so that no node ends up with two of them.
+    int num_nodes = configuration_->all_nodes.size();
+    int this_node_id = configuration_->this_node_id;
+    string moves;
+    output.append(", hottest:");
+    for (int i = 0; i < count; i++) {
+      char table = static_cast<char>(hottest[i].second >> kIdBits);
+      int64 id = hottest[i].second & ((1ULL << kIdBits) - 1);
+      snprintf(buffer, sizeof(buffer), " %s:%ld (%d)",
+               table == '\0' ? "default" : string(1, table).c_str(),
+               static_cast<long>(id), hottest[i].first);
+      output.append(buffer);
+      if (i > 0 && num_nodes > 1) {
+        int node = (this_node_id + 1 + (i - 1) % (num_nodes - 1)) % num_nodes;
+        moves.append(moves.empty() ? "" : ",");
+        moves.append(PartitionMap::FormatMigration(table, id, id, node));
+      }
+    }
+    if (!moves.empty())
+      output.append("\nSuggested: --migrate=" + moves);
+  }
+
+  waits_.clear();
+  total_waits_ = 0;
+  return output;
+}
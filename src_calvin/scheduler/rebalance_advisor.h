@@ -0,0 +1,41 @@
+// The rebalance advisor watches lock contention at this node: every lock
+// request that cannot be granted immediately is charged to the partitioning
+// unit (table and id, see common/partitioner.h) of its key. Once per second it
+// reports the units that caused the most waits, together with a migration
+// spec (the format taken by the --migrate flag of deployment/main.cc) that
+// would spread all but the hottest of them over the other nodes.
+
+#ifndef _DB_SCHEDULER_REBALANCE_ADVISOR_H_
+#define _DB_SCHEDULER_REBALANCE_ADVISOR_H_
+
+#include <string>
+#include <tr1/unordered_map>
+
+#include "common/types.h"
+
+using std::string;
+using std::tr1::unordered_map;
+
+class Configuration;
+
+class RebalanceAdvisor {
+ public:
+  explicit RebalanceAdvisor(const Configuration* config);
+
+  // Called whenever a lock request on 'key' has to wait.
+  void RecordWait(const Key& key);
+
+  // Returns the hottest units and suggested moves since the previous call,
+  // then starts a new interval.
+  string ReportStats();
+
+ private:
+  const Configuration* configuration_;
+
+  // Waits per unit, keyed by the table character in the top 8 bits and the
+  // id in the rest.
+  unordered_map<uint64, int> waits_;
+  int total_waits_;
+};
+
+#endif  // _DB_SCHEDULER_REBALANCE_ADVISOR_H_
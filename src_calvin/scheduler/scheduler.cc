@@ -0,0 +1,23 @@
+// Chooses the deterministic scheduler a node runs.
+
+#include "scheduler/scheduler.h"
+
+#include "scheduler/deterministic_scheduler.h"
+#include "scheduler/pdlr_scheduler.h"
+#include "scheduler/vll_scheduler.h"
+
+Scheduler* Scheduler::Create(const string& name, Configuration* conf,
+                             Connection* batch_connection, Storage* storage,
+                             const Application* application,
+                             int checkpoint_interval) {
+  if (name == "calvin")
+    return new DeterministicScheduler(conf, batch_connection, storage,
+                                      application, checkpoint_interval);
+  if (name == "pdlr")
+    return new PdlrScheduler(conf, batch_connection, storage, application,
+                             checkpoint_interval);
+  if (name == "vll")
+    return new VllScheduler(conf, batch_connection, storage, application,
+                            checkpoint_interval);
+  return NULL;
+}
@@ -5,14 +5,38 @@
 // necessary to determine whether a transaction can be scheduled. It also
 // forwards messages on to the backend that are sent from other nodes
 // participating in distributed transactions.
+//
+// Every node runs one of several deterministic schedulers, chosen when the
+// node starts (see Create()). They execute the same global order and only
+// differ in how they track lock conflicts between txns.
 
 #ifndef _DB_SCHEDULER_SCHEDULER_H_
 #define _DB_SCHEDULER_SCHEDULER_H_
 
+#include <string>
+
+using std::string;
+
 class Application;
+class Configuration;
+class Connection;
+class Storage;
 
 class Scheduler {
  public:
   virtual ~Scheduler() {}
+
+  // Returns a new, running deterministic scheduler of the given name, or NULL
+  // if there is none of that name:
+  //
+  //  calvin  Deterministic two-phase locking with a lock table
+  //          (DeterministicScheduler).
+  //  pdlr    Deterministic two-phase locking with pluggable admission and
+  //          release order (PdlrScheduler).
+  //  vll     Very lightweight locking (VllScheduler).
+  static Scheduler* Create(const string& name, Configuration* conf,
+                           Connection* batch_connection, Storage* storage,
+                           const Application* application,
+                           int checkpoint_interval);
 };
 #endif  // _DB_SCHEDULER_SCHEDULER_H_
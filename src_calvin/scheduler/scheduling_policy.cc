@@ -0,0 +1,106 @@
+// Admission and release policies for the PDLR lock manager thread.
+
+#include "scheduler/scheduling_policy.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/definitions.hh"
+#include "proto/txn.pb.h"
+#include "scheduler/pdlr_lock_manager.h"
+
+using std::pair;
+
+SchedulingPolicy* SchedulingPolicy::Create(const string& name) {
+  if (name == "PDLR")
+    return new PdlrPolicy();
+  if (name == "FIFO")
+    return new FifoPolicy();
+  if (name == "COST")
+    return new CostPolicy();
+  return NULL;
+}
+
+bool PdlrPolicy::Admit(PdlrLockManager* locks, const TxnProto& txn) {
+  return locks->executing_ < NUM_WORKERS &&
+         locks->pending_ <= locks->executing_;
+}
+
+void PdlrPolicy::Done(TxnProto* txn) {
+  if (txn->is_contented())
+    contended_.push_back(txn);
+  else
+    uncontended_.push_back(txn);
+}
+
+TxnProto* PdlrPolicy::NextRelease(PdlrLockManager* locks) {
+  // Once the held back txns are all that is executing, nothing else would
+  // release a lock or let another txn in.
+  TxnProto* txn = NULL;
+  if (!contended_.empty() && (locks->executing_ < locks->pending_ ||
+                              locks->executing_ <= contended_.size())) {
+    txn = contended_.front();
+    contended_.pop_front();
+  } else if (!uncontended_.empty()) {
+    txn = uncontended_.front();
+    uncontended_.pop_front();
+  }
+  return txn;
+}
+
+bool FifoPolicy::Admit(PdlrLockManager* locks, const TxnProto& txn) {
+  return locks->executing_ + locks->pending_ < MAX_ACTIVE_TXNS;
+}
+
+void FifoPolicy::Done(TxnProto* txn) {
+  done_.push_back(txn);
+}
+
+TxnProto* FifoPolicy::NextRelease(PdlrLockManager* locks) {
+  if (done_.empty())
+    return NULL;
+  TxnProto* txn = done_.front();
+  done_.pop_front();
+  return txn;
+}
+
+static bool BenefitAbove(const pair<int, TxnProto*>& a,
+                         const pair<int, TxnProto*>& b) {
+  return a.first > b.first;
+}
+
+bool CostPolicy::Admit(PdlrLockManager* locks, const TxnProto& txn) {
+  // Granted txns beyond a second one per worker only queue up for workers.
+  if (locks->executing_ >= 2 * NUM_WORKERS)
+    return false;
+  if (locks->QueuedAhead(txn) == 0)
+    return true;
+  // A txn that would wait lengthens the chains of all later txns on its keys.
+  return locks->executing_ < NUM_WORKERS &&
+         locks->pending_ <= locks->executing_;
+}
+
+void CostPolicy::Done(TxnProto* txn) {
+  done_.push_back(txn);
+}
+
+TxnProto* CostPolicy::NextRelease(PdlrLockManager* locks) {
+  if (ranked_.empty()) {
+    if (done_.empty())
+      return NULL;
+    // Rank the txns finished since the last ranking once; releasing some of
+    // them changes the others' benefits, but only slightly.
+    vector<pair<int, TxnProto*> > benefits;
+    for (size_t i = 0; i < done_.size(); i++)
+      benefits.push_back(std::make_pair(locks->ReleaseBenefit(done_[i]),
+                                        done_[i]));
+    // Best first, and ties in the order the txns finished.
+    std::stable_sort(benefits.begin(), benefits.end(), BenefitAbove);
+    for (size_t i = benefits.size(); i > 0; i--)
+      ranked_.push_back(benefits[i - 1].second);
+    done_.clear();
+  }
+  TxnProto* txn = ranked_.back();
+  ranked_.pop_back();
+  return txn;
+}
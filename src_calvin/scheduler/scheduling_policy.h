@@ -0,0 +1,90 @@
+// Decides, in the PDLR lock manager thread, when the next txn of the batch
+// requests its locks and in which order finished txns release theirs.
+// Deterministic locking grants each key's locks in txn order whatever the
+// policy does, so policies only trade throughput against latency:
+//
+//  PDLR  Admits while fewer txns are blocked than executing and workers are
+//        free. Releases uncontended txns at once, and contended ones only
+//        while more txns are blocked than executing, or once they are the
+//        only txns executing.
+//  FIFO  Calvin's policy: admits up to MAX_ACTIVE_TXNS txns in flight and
+//        releases finished txns in the order they finish.
+//  COST  Admits a txn that would not wait while fewer than two txns per
+//        worker are executing, and one that would only while workers are
+//        free and fewer txns are blocked than executing. Releases every
+//        finished txn, those whose release makes the most blocked txns
+//        runnable, or frees the longest chains of blocked requests, first.
+
+#ifndef _DB_SCHEDULER_SCHEDULING_POLICY_H_
+#define _DB_SCHEDULER_SCHEDULING_POLICY_H_
+
+#include <deque>
+#include <string>
+#include <vector>
+
+using std::deque;
+using std::string;
+using std::vector;
+
+class PdlrLockManager;
+class TxnProto;
+
+class SchedulingPolicy {
+ public:
+  virtual ~SchedulingPolicy() {}
+
+  // Returns a new policy of the given name (see above), or NULL if there is
+  // none of that name.
+  static SchedulingPolicy* Create(const string& name);
+
+  virtual const char* name() const = 0;
+
+  // Returns true if 'txn', the next txn in order, should request its locks
+  // now.
+  virtual bool Admit(PdlrLockManager* locks, const TxnProto& txn) = 0;
+
+  // Called with every txn that has finished executing.
+  virtual void Done(TxnProto* txn) = 0;
+
+  // Returns the next finished txn to release its locks, or NULL if no more
+  // should be released for now.
+  virtual TxnProto* NextRelease(PdlrLockManager* locks) = 0;
+};
+
+class PdlrPolicy : public SchedulingPolicy {
+ public:
+  virtual const char* name() const { return "PDLR"; }
+  virtual bool Admit(PdlrLockManager* locks, const TxnProto& txn);
+  virtual void Done(TxnProto* txn);
+  virtual TxnProto* NextRelease(PdlrLockManager* locks);
+
+ private:
+  deque<TxnProto*> contended_;
+  deque<TxnProto*> uncontended_;
+};
+
+class FifoPolicy : public SchedulingPolicy {
+ public:
+  virtual const char* name() const { return "FIFO"; }
+  virtual bool Admit(PdlrLockManager* locks, const TxnProto& txn);
+  virtual void Done(TxnProto* txn);
+  virtual TxnProto* NextRelease(PdlrLockManager* locks);
+
+ private:
+  deque<TxnProto*> done_;
+};
+
+class CostPolicy : public SchedulingPolicy {
+ public:
+  virtual const char* name() const { return "COST"; }
+  virtual bool Admit(PdlrLockManager* locks, const TxnProto& txn);
+  virtual void Done(TxnProto* txn);
+  virtual TxnProto* NextRelease(PdlrLockManager* locks);
+
+ private:
+  // Finished txns not ranked yet, and those ranked, best last.
+  vector<TxnProto*> done_;
+  vector<TxnProto*> ranked_;
+};
+
+#endif  // _DB_SCHEDULER_SCHEDULING_POLICY_H_
@@ -0,0 +1,153 @@
+// Lock-free execution of read-only txns at a snapshot.
+
+#include "scheduler/snapshot_executor.h"
+
+#include <cstdio>
+#include <iostream>
+#include <utility>
+
+#include "applications/application.h"
+#include "backend/mvcc_storage.h"
+#include "backend/storage_manager.h"
+#include "common/configuration.h"
+#include "proto/txn.pb.h"
+
+using std::pair;
+
+SnapshotExecutor::SnapshotExecutor(Configuration* config,
+                                   MvccStorage* storage,
+                                   const Application* application)
+    : configuration_(config), storage_(storage), application_(application),
+      stopped_(false), interval_start_(GetTime()), txns_(0), latency_(0),
+      max_latency_(0), retries_(0), dropped_(0) {
+  pthread_mutex_init(&stats_mutex_, NULL);
+  for (int i = 0; i < SNAPSHOT_THREADS; i++)
+    pthread_create(&threads_[i], NULL, RunThread,
+                   new pair<int, SnapshotExecutor*>(i, this));
+}
+
+SnapshotExecutor::~SnapshotExecutor() {
+  stopped_ = true;
+  for (int i = 0; i < SNAPSHOT_THREADS; i++)
+    pthread_join(threads_[i], NULL);
+  Request request;
+  while (requests_.Pop(&request))
+    delete request.txn;
+  pthread_mutex_destroy(&stats_mutex_);
+}
+
+bool SnapshotExecutor::Divert(TxnProto* txn) {
+  if (txn->has_migration() || txn->write_set_size() > 0 ||
+      txn->read_write_set_size() > 0 || txn->read_set_size() == 0)
+    return false;
+  for (int i = 0; i < txn->read_set_size(); i++) {
+    if (configuration_->LookupPartition(txn->read_set(i)) !=
+        configuration_->this_node_id)
+      return false;
+  }
+
+  // The txn is its own only reader and writer.
+  txn->clear_readers();
+  txn->clear_writers();
+  txn->add_readers(configuration_->this_node_id);
+  txn->add_writers(configuration_->this_node_id);
+  Request request = {txn, GetTime()};
+  requests_.Push(request);
+  return true;
+}
+
+void* SnapshotExecutor::RunThread(void* arg) {
+  pair<int, SnapshotExecutor*>* thread =
+      reinterpret_cast<pair<int, SnapshotExecutor*>*>(arg);
+  thread->second->Run(thread->first);
+  delete thread;
+  return NULL;
+}
+
+void SnapshotExecutor::Run(int thread) {
+  while (!stopped_) {
+    Request request;
+    if (!requests_.Pop(&request)) {
+      Spin(0.0001);
+    } else if (Execute(request.txn)) {
+      double latency = GetTime() - request.submitted;
+      delete request.txn;
+      pthread_mutex_lock(&stats_mutex_);
+      txns_++;
+      latency_ += latency;
+      if (latency > max_latency_)
+        max_latency_ = latency;
+      pthread_mutex_unlock(&stats_mutex_);
+    } else {
+      // Try again once the watermark has moved on.
+      bool drop = GetTime() > request.submitted + SNAPSHOT_MAX_WAIT;
+      if (drop)
+        delete request.txn;
+      else
+        requests_.Push(request);
+      pthread_mutex_lock(&stats_mutex_);
+      if (drop)
+        dropped_++;
+      else
+        retries_++;
+      pthread_mutex_unlock(&stats_mutex_);
+      Spin(0.0001);
+    }
+
+    // Report once per second while there is anything to report.
+    if (thread == 0 && GetTime() > interval_start_ + 1 && txns_ + dropped_ > 0)
+      std::cout << ReportStats() << "\n" << std::flush;
+  }
+}
+
+bool SnapshotExecutor::Readable(const TxnProto& txn, int64 snapshot) {
+  for (int i = 0; i < txn.read_set_size(); i++) {
+    if (configuration_->LookupPartition(txn.read_set(i)) !=
+            configuration_->this_node_id ||
+        storage_->ReadSnapshot(txn.read_set(i), snapshot) == NULL)
+      return false;
+  }
+  return true;
+}
+
+bool SnapshotExecutor::Execute(TxnProto* txn) {
+  int64 snapshot = storage_->BeginSnapshot();
+  bool done = false;
+
+  // A dependent txn whose prediction the snapshot does not match gets the keys
+  // it found instead. They were read at the same snapshot, so the second run
+  // matches them.
+  for (int run = 0; run < 2 && !done && Readable(*txn, snapshot); run++) {
+    // The storage manager reads as of the txn's id, which for a txn outside
+    // the global order is the snapshot.
+    txn->set_txn_id(snapshot);
+    StorageManager manager(configuration_, NULL, storage_, txn);
+    if (application_->Execute(txn, &manager) == REDO)
+      application_->Repredict(txn);
+    else
+      done = true;
+  }
+  storage_->EndSnapshot(snapshot);
+  return done;
+}
+
+string SnapshotExecutor::ReportStats() {
+  pthread_mutex_lock(&stats_mutex_);
+  double now = GetTime();
+  double elapsed = now - interval_start_;
+  char buffer[200];
+  snprintf(buffer, sizeof(buffer),
+           "Snapshot reads: %.0f txns/sec, latency %.3f ms avg, %.3f ms max, "
+           "%.0f retries/sec, %ld dropped",
+           elapsed > 0 ? txns_ / elapsed : 0,
+           txns_ > 0 ? latency_ * 1000 / txns_ : 0, max_latency_ * 1000,
+           elapsed > 0 ? retries_ / elapsed : 0, static_cast<long>(dropped_));
+  interval_start_ = now;
+  txns_ = 0;
+  latency_ = 0;
+  max_latency_ = 0;
+  retries_ = 0;
+  dropped_ = 0;
+  pthread_mutex_unlock(&stats_mutex_);
+  return string(buffer);
+}
@@ -0,0 +1,82 @@
+// Runs read-only txns against a snapshot of MvccStorage instead of ordering
+// them. A txn that only reads objects stored at this node is handed over by
+// the sequencer as soon as the client produces it: it takes no locks, never
+// enters a batch, and runs at the last batch boundary by which every txn has
+// completed, which is a consistent state of the partition.
+//
+// Reads the client expects to find (e.g. an order placed by a txn it generated
+// just before) may be missing from the snapshot if their writer has not
+// completed yet. Such txns are retried at later snapshots for up to
+// SNAPSHOT_MAX_WAIT, and then dropped. So are dependent txns whose keys,
+// predicted again from the snapshot, are not all stored at this node.
+
+#ifndef _DB_SCHEDULER_SNAPSHOT_EXECUTOR_H_
+#define _DB_SCHEDULER_SNAPSHOT_EXECUTOR_H_
+
+#include <pthread.h>
+
+#include <string>
+
+#include "common/definitions.hh"
+#include "common/types.h"
+#include "common/utils.h"
+#include "sequencer/sequencer.h"
+
+using std::string;
+
+class Application;
+class Configuration;
+class MvccStorage;
+class TxnProto;
+
+class SnapshotExecutor : public ReadOnlyExecutor {
+ public:
+  // Starts SNAPSHOT_THREADS threads running txns of 'application'.
+  SnapshotExecutor(Configuration* config, MvccStorage* storage,
+                   const Application* application);
+  virtual ~SnapshotExecutor();
+
+  // Takes over 'txn' if it only reads objects stored at this node.
+  virtual bool Divert(TxnProto* txn);
+
+  // Returns throughput, latency (from hand-over to completion), retries and
+  // dropped txns since the last call.
+  string ReportStats();
+
+ private:
+  struct Request {
+    TxnProto* txn;
+    double submitted;
+  };
+
+  static void* RunThread(void* arg);
+  void Run(int thread);
+
+  // Returns true if every object 'txn' reads is stored at this node and exists
+  // at 'snapshot'.
+  bool Readable(const TxnProto& txn, int64 snapshot);
+
+  // Runs 'txn' at a new snapshot, repredicting it if it returns REDO. Returns
+  // false if it could not run there because some object it reads, predicted
+  // or repredicted, does not exist there or is stored elsewhere.
+  bool Execute(TxnProto* txn);
+
+  Configuration* configuration_;
+  MvccStorage* storage_;
+  const Application* application_;
+
+  AtomicQueue<Request> requests_;
+  pthread_t threads_[SNAPSHOT_THREADS];
+  volatile bool stopped_;
+
+  // Statistics since the last ReportStats(), guarded by 'stats_mutex_'.
+  pthread_mutex_t stats_mutex_;
+  double interval_start_;
+  int64 txns_;
+  double latency_;
+  double max_latency_;
+  int64 retries_;
+  int64 dropped_;
+};
+
+#endif  // _DB_SCHEDULER_SNAPSHOT_EXECUTOR_H_
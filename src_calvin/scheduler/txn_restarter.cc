@@ -0,0 +1,74 @@
+// Restarts of mispredicted dependent txns.
+
+#include "scheduler/txn_restarter.h"
+
+#include <cstdio>
+
+#include "applications/application.h"
+#include "common/configuration.h"
+#include "common/connection.h"
+#include "common/definitions.hh"
+#include "proto/message.pb.h"
+#include "proto/txn.pb.h"
+
+TxnRestarter::TxnRestarter(Configuration* config,
+                           const Application* application)
+    : configuration_(config),
+      application_(application),
+      executed_(0),
+      restarted_(0) {}
+
+void TxnRestarter::Executed(const TxnProto& txn, int result,
+                            Connection* connection) {
+  __atomic_add_fetch(&executed_, 1, __ATOMIC_RELAXED);
+  if (result != REDO)
+    return;
+  __atomic_add_fetch(&restarted_, 1, __ATOMIC_RELAXED);
+
+  // The nodes executing the txn all found it mispredicted, one of them orders
+  // it again.
+  if (RestarterOf(txn) != configuration_->this_node_id)
+    return;
+  TxnProto* restart = NewRestart(txn);
+  MessageProto message;
+  message.set_type(MessageProto::TXN_PROTO);
+  message.set_destination_channel("sequencer");
+  message.set_destination_node(SequencerOf(txn));
+  restart->SerializeToString(message.add_data());
+  connection->Send(message);
+  delete restart;
+}
+
+TxnProto* TxnRestarter::NewRestart(const TxnProto& txn) {
+  TxnProto* restart = new TxnProto(txn);
+  // The sequencer that orders it works out its participants again.
+  restart->clear_readers();
+  restart->clear_writers();
+  restart->set_status(TxnProto::NEW);
+  application_->Repredict(restart);
+  return restart;
+}
+
+int TxnRestarter::RestarterOf(const TxnProto& txn) {
+  // Txns without writers are executed by all their readers (see
+  // StorageManager::Executes()).
+  if (txn.writers_size() > 0)
+    return txn.writers(0);
+  return txn.readers_size() > 0 ? txn.readers(0) : -1;
+}
+
+int TxnRestarter::SequencerOf(const TxnProto& txn) {
+  // Sequencers take turns numbering batches (see Sequencer::RunWriter()).
+  return (txn.txn_id() / MAX_LOCK_BATCH_SIZE) %
+         configuration_->all_nodes.size();
+}
+
+string TxnRestarter::ReportStats() {
+  int executed = __atomic_exchange_n(&executed_, 0, __ATOMIC_RELAXED);
+  int restarted = __atomic_exchange_n(&restarted_, 0, __ATOMIC_RELAXED);
+  char buffer[96];
+  snprintf(buffer, sizeof(buffer),
+           "Restarted %d of %d executed txns (%.2f%%)", restarted, executed,
+           executed == 0 ? 0 : 100.0 * restarted / executed);
+  return string(buffer);
+}
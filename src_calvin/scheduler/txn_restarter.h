@@ -0,0 +1,53 @@
+// Orders dependent txns (see applications/application.h) again when the read
+// and write sets they were ordered with turned out wrong. Every node that
+// executes such a txn finds the same keys, and the first of its writers (or
+// of its readers, if it writes nothing) has the application predict them in a
+// copy of the txn and sends the copy to the sequencer that ordered the
+// original, to be ordered in its place. The workers of all schedulers share
+// one restarter, which also keeps the rate of restarts at this node.
+
+#ifndef _DB_SCHEDULER_TXN_RESTARTER_H_
+#define _DB_SCHEDULER_TXN_RESTARTER_H_
+
+#include <string>
+
+using std::string;
+
+class Application;
+class Configuration;
+class Connection;
+class TxnProto;
+
+class TxnRestarter {
+ public:
+  TxnRestarter(Configuration* config, const Application* application);
+
+  // Called by a worker after Execute() returned 'result' for 'txn'. Sends
+  // the txn to be ordered again over 'connection' if it has to be.
+  void Executed(const TxnProto& txn, int result, Connection* connection);
+
+  // Returns the txn to order in place of 'txn', which Execute() returned
+  // REDO for. The caller takes ownership.
+  TxnProto* NewRestart(const TxnProto& txn);
+
+  // Returns the node that orders 'txn' again if it was mispredicted.
+  int RestarterOf(const TxnProto& txn);
+
+  // Returns the node whose sequencer ordered 'txn'.
+  int SequencerOf(const TxnProto& txn);
+
+  // Returns a one-line summary of the txns executed and restarted at this
+  // node since the previous call.
+  string ReportStats();
+
+ private:
+  Configuration* configuration_;
+  const Application* application_;
+
+  // Txns executed and found mispredicted since the last report, counted by
+  // all workers.
+  int executed_;
+  int restarted_;
+};
+
+#endif  // _DB_SCHEDULER_TXN_RESTARTER_H_
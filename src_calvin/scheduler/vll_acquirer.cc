@@ -0,0 +1,183 @@
+// Parallel lock acquisition for the VLL lock manager.
+
+#include "scheduler/vll_acquirer.h"
+
+#include <immintrin.h>
+#include <sched.h>
+
+#include "common/configuration.h"
+#include "proto/txn.pb.h"
+#include "scheduler/vll_queue.h"
+
+// Busy-waits briefly, then yields the core in case the thread being waited
+// for shares it.
+static void Pause(int spins) {
+  if (spins < 1000)
+    _mm_pause();
+  else
+    sched_yield();
+}
+
+VllAcquirer::VllAcquirer(Configuration* conf, LockSlots::Mode mode,
+                         int dense_ids, int threads, int capacity)
+    : configuration_(conf), slots_(mode, dense_ids), Cx_(slots_.size(), 0),
+      Cs_(slots_.size(), 0), threads_(threads), lock_threads_(threads),
+      capacity_(capacity), jobs_(capacity), submitted_(0), taken_(0),
+      ticket_(0), stopped_(false) {
+  for (int i = 0; i < threads_; i++) {
+    pthread_create(&lock_threads_[i], NULL, RunLockThread,
+                   reinterpret_cast<void*>(
+                       new pair<int, VllAcquirer*>(i, this)));
+  }
+}
+
+VllAcquirer::~VllAcquirer() {
+  __atomic_store_n(&stopped_, true, __ATOMIC_RELAXED);
+  for (int i = 0; i < threads_; i++)
+    pthread_join(lock_threads_[i], NULL);
+  for (int64 i = taken_; i < submitted_; i++)
+    delete jobs_[i % capacity_].txn;
+}
+
+void* VllAcquirer::RunLockThread(void* arg) {
+  int thread = reinterpret_cast<pair<int, VllAcquirer*>*>(arg)->first;
+  VllAcquirer* acquirer =
+      reinterpret_cast<pair<int, VllAcquirer*>*>(arg)->second;
+  delete reinterpret_cast<pair<int, VllAcquirer*>*>(arg);
+
+  for (int64 number = thread; true; number += acquirer->threads_) {
+    // Wait for the txn to be submitted...
+    for (int spins = 0; __atomic_load_n(&acquirer->submitted_,
+                                        __ATOMIC_ACQUIRE) <= number;
+         spins++) {
+      if (__atomic_load_n(&acquirer->stopped_, __ATOMIC_RELAXED))
+        return NULL;
+      Pause(spins);
+    }
+    VllJob* job = &acquirer->jobs_[number % acquirer->capacity_];
+    acquirer->Prepare(job);
+
+    // ...and for every txn before it to have requested its locks.
+    for (int spins = 0; __atomic_load_n(&acquirer->ticket_,
+                                        __ATOMIC_ACQUIRE) != number;
+         spins++) {
+      if (__atomic_load_n(&acquirer->stopped_, __ATOMIC_RELAXED))
+        return NULL;
+      Pause(spins);
+    }
+    acquirer->RequestLocks(job);
+    __atomic_store_n(&acquirer->ticket_, number + 1, __ATOMIC_RELEASE);
+  }
+  return NULL;
+}
+
+void VllAcquirer::Submit(string* data) {
+  VllJob* job = &jobs_[submitted_ % capacity_];
+  job->data.swap(*data);
+  job->txn = NULL;
+  __atomic_store_n(&submitted_, submitted_ + 1, __ATOMIC_RELEASE);
+}
+
+VllJob* VllAcquirer::Next() {
+  if (__atomic_load_n(&ticket_, __ATOMIC_ACQUIRE) == taken_)
+    return NULL;
+  return &jobs_[taken_++ % capacity_];
+}
+
+void VllAcquirer::Prepare(VllJob* job) {
+  job->txn = new TxnProto();
+  job->txn->ParseFromString(job->data);
+  job->txn->set_status(TxnProto::ACTIVE);
+  job->slots.clear();
+  job->waits.clear();
+  job->keys.clear();
+  job->unassigned.clear();
+  job->writes = 0;
+
+  // Migration txns take no locks; they only schedule the switch.
+  if (job->txn->has_migration())
+    return;
+
+  TxnProto* txn = job->txn;
+  for (int i = 0; i < txn->read_write_set_size(); i++)
+    AddKey(job, txn->read_write_set(i));
+  job->writes = job->slots.size();
+  for (int i = 0; i < txn->read_set_size(); i++)
+    AddKey(job, txn->read_set(i));
+}
+
+void VllAcquirer::AddKey(VllJob* job, const Key& key) {
+  if (configuration_->LookupPartition(key) != configuration_->this_node_id)
+    return;
+
+  int slot;
+  uint64 hash;
+  if (!slots_.Fixed(key, &slot, &hash)) {
+    job->unassigned.push_back(std::make_pair(job->slots.size(), hash));
+    slot = -1;
+  }
+  job->slots.push_back(slot);
+  job->keys.push_back(&key);
+}
+
+void VllAcquirer::RequestLocks(VllJob* job) {
+  if (!job->unassigned.empty()) {
+    Lock l(&mutex_);
+    for (size_t i = 0; i < job->unassigned.size(); i++) {
+      int index = job->unassigned[i].first;
+      job->slots[index] = slots_.Acquire(job->unassigned[i].second);
+      Request(job, index);
+    }
+  }
+
+  for (size_t i = 0; i < job->slots.size(); i++) {
+    if (slots_.fixed(job->slots[i]))
+      Request(job, i);
+  }
+}
+
+void VllAcquirer::Request(VllJob* job, int i) {
+  int slot = job->slots[i];
+  bool held;
+  if (i < job->writes) {
+    held = __atomic_add_fetch(&Cx_[slot], 1, __ATOMIC_RELAXED) > 1 ||
+           __atomic_load_n(&Cs_[slot], __ATOMIC_RELAXED) > 0;
+  } else {
+    __atomic_add_fetch(&Cs_[slot], 1, __ATOMIC_RELAXED);
+    held = __atomic_load_n(&Cx_[slot], __ATOMIC_RELAXED) > 0;
+  }
+  if (held) {
+    job->txn->set_status(TxnProto::BLOCKED);
+    job->waits.push_back(job->keys[i]);
+  }
+}
+
+void VllAcquirer::Release(const VllTxn& entry) {
+  int unfixed = 0;
+  for (size_t i = 0; i < entry.slots.size(); i++) {
+    int slot = entry.slots[i];
+    if (!slots_.fixed(slot))
+      unfixed++;
+    else if (static_cast<int>(i) < entry.writes)
+      __atomic_sub_fetch(&Cx_[slot], 1, __ATOMIC_RELAXED);
+    else
+      __atomic_sub_fetch(&Cs_[slot], 1, __ATOMIC_RELAXED);
+  }
+  if (unfixed == 0)
+    return;
+
+  // Lock threads only touch these counters while holding the mutex as well,
+  // so a slot found unused here cannot be in the middle of being requested.
+  Lock l(&mutex_);
+  for (size_t i = 0; i < entry.slots.size(); i++) {
+    int slot = entry.slots[i];
+    if (slots_.fixed(slot))
+      continue;
+    if (static_cast<int>(i) < entry.writes)
+      __atomic_sub_fetch(&Cx_[slot], 1, __ATOMIC_RELAXED);
+    else
+      __atomic_sub_fetch(&Cs_[slot], 1, __ATOMIC_RELAXED);
+    if (Cx_[slot] == 0 && Cs_[slot] == 0)
+      slots_.Release(slot);
+  }
+}
@@ -0,0 +1,131 @@
+// Requests the VLL locks of a stream of txns on several lock threads at once.
+//
+// Txns are submitted in txn order and numbered; lock thread i takes txns i,
+// i + threads, i + 2 * threads, ... Parsing a txn and finding its local keys
+// and their slots, which is most of the work, touches no shared state, so the
+// lock threads do that for their txns in parallel. Requesting the locks then
+// happens in submission order: a ticket passes from txn to txn, and only the
+// thread holding a txn's ticket increments its counters. Every key's counters
+// thus see requests in txn order, exactly as with a single lock manager thread,
+// and each txn is granted or blocked the same way.
+//
+// Counters are updated with atomics, as locks are released (by the thread
+// calling Release()) while others are being requested. A lock thread may see
+// a counter before a concurrent release lowers it, and then blocks its txn
+// without need; it never misses a request made before it.
+//
+// Slots that depend on which keys are in flight (EXACT slots of keys that are
+// not plain ids) are assigned and given back under a mutex.
+
+#ifndef _DB_SCHEDULER_VLL_ACQUIRER_H_
+#define _DB_SCHEDULER_VLL_ACQUIRER_H_
+
+#include <pthread.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+#include "common/utils.h"
+#include "scheduler/lock_slots.h"
+
+using std::pair;
+using std::string;
+using std::vector;
+
+class Configuration;
+class TxnProto;
+struct VllTxn;
+
+struct VllJob {
+  // The serialized txn, as submitted.
+  string data;
+
+  // The parsed txn, ACTIVE or BLOCKED. Migration txns request no locks.
+  TxnProto* txn;
+
+  // Slots of the keys the txn locks at this node: its write slots, followed by
+  // its read slots.
+  vector<int> slots;
+  int writes;
+
+  // Keys whose locks were held by earlier txns when requested.
+  vector<const Key*> waits;
+
+  // The key of each slot, and the (index, hash) of each slot that must be
+  // assigned from the table while holding the ticket.
+  vector<const Key*> keys;
+  vector<pair<int, uint64> > unassigned;
+};
+
+class VllAcquirer {
+ public:
+  // Starts 'threads' lock threads, which keep up to 'capacity' submitted txns
+  // in flight.
+  VllAcquirer(Configuration* conf, LockSlots::Mode mode, int dense_ids,
+              int threads, int capacity);
+  ~VllAcquirer();
+
+  // Number of lock table slots.
+  int slots() const { return slots_.size(); }
+
+  // Number of txns submitted but not returned by Next() yet.
+  int pending() const { return submitted_ - taken_; }
+
+  // True if no txn can be submitted until Next() returns one.
+  bool full() const { return submitted_ - taken_ == capacity_; }
+
+  // Hands the serialized txn in '*data' (which is swapped out) to the lock
+  // threads.
+  void Submit(string* data);
+
+  // Returns the next submitted txn, in submission order, once its locks have
+  // been requested, or NULL. The job stays valid until the next Submit().
+  VllJob* Next();
+
+  // Releases the locks of 'entry', whose slots were taken from a job.
+  void Release(const VllTxn& entry);
+
+ private:
+  static void* RunLockThread(void* arg);
+
+  // Parses the txn of 'job' and looks up its keys' slots.
+  void Prepare(VllJob* job);
+
+  // Adds 'key' to 'job' if it is stored at this node.
+  void AddKey(VllJob* job, const Key& key);
+
+  // Requests the locks of 'job'. Only called while holding its ticket.
+  void RequestLocks(VllJob* job);
+
+  // Increments the counter of the lock on 'job's 'i'th slot.
+  void Request(VllJob* job, int i);
+
+  Configuration* configuration_;
+  LockSlots slots_;
+
+  // Write and read lock counters of each slot.
+  vector<int> Cx_;
+  vector<int> Cs_;
+
+  // Guards slots_ and the counters of its unfixed slots.
+  Mutex mutex_;
+
+  int threads_;
+  vector<pthread_t> lock_threads_;
+
+  // Ring of in-flight jobs, indexed by submission number.
+  int capacity_;
+  vector<VllJob> jobs_;
+
+  // Txns submitted so far (written by the submitting thread only), txns
+  // returned by Next(), and the number of the txn holding the ticket.
+  int64 submitted_;
+  int64 taken_;
+  int64 ticket_;
+
+  bool stopped_;
+};
+
+#endif  // _DB_SCHEDULER_VLL_ACQUIRER_H_
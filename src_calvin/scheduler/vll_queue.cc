@@ -0,0 +1,75 @@
+// Ring of queued txns for the VLL lock manager.
+
+#include "scheduler/vll_queue.h"
+
+#include <cassert>
+
+#include "proto/txn.pb.h"
+
+VllQueue::VllQueue(int capacity)
+    : entries_(capacity), capacity_(capacity), head_(0), tail_(0), size_(0),
+      first_blocked_(NULL), last_blocked_(NULL), blocked_(0) {}
+
+VllTxn* VllQueue::Append(TxnProto* txn) {
+  assert(!full());
+  assert(tail_ == head_ || at(tail_ - 1)->txn_id < txn->txn_id());
+  VllTxn* entry = at(tail_++);
+  entry->txn_id = txn->txn_id();
+  entry->txn = txn;
+  entry->slots.clear();
+  entry->writes = 0;
+  entry->prev_blocked = NULL;
+  entry->next_blocked = NULL;
+  size_++;
+  return entry;
+}
+
+VllTxn* VllQueue::Find(int64 txn_id) {
+  int64 low = head_;
+  int64 high = tail_ - 1;
+  while (low < high) {
+    int64 middle = low + (high - low) / 2;
+    if (at(middle)->txn_id < txn_id)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  assert(at(low)->txn_id == txn_id && at(low)->txn != NULL);
+  return at(low);
+}
+
+void VllQueue::Remove(VllTxn* entry) {
+  entry->txn = NULL;
+  size_--;
+  while (head_ < tail_ && at(head_)->txn == NULL)
+    head_++;
+}
+
+VllTxn* VllQueue::front() {
+  return head_ == tail_ ? NULL : at(head_);
+}
+
+void VllQueue::Block(VllTxn* entry) {
+  entry->prev_blocked = last_blocked_;
+  entry->next_blocked = NULL;
+  if (last_blocked_ == NULL)
+    first_blocked_ = entry;
+  else
+    last_blocked_->next_blocked = entry;
+  last_blocked_ = entry;
+  blocked_++;
+}
+
+void VllQueue::Unblock(VllTxn* entry) {
+  if (entry->prev_blocked == NULL)
+    first_blocked_ = entry->next_blocked;
+  else
+    entry->prev_blocked->next_blocked = entry->next_blocked;
+  if (entry->next_blocked == NULL)
+    last_blocked_ = entry->prev_blocked;
+  else
+    entry->next_blocked->prev_blocked = entry->prev_blocked;
+  entry->prev_blocked = NULL;
+  entry->next_blocked = NULL;
+  blocked_--;
+}
@@ -0,0 +1,93 @@
+// The VLL lock manager's queue of txns that have requested their locks but not
+// released them yet. Txns arrive in txn id order, so instead of a sorted map the
+// queue is a fixed ring of entries in arrival order: appending a txn, checking
+// the oldest one and dropping completed ones off the front are O(1), and
+// entries (with their slot arrays) are reused rather than reallocated.
+//
+// Txn ids have gaps (batches are rarely full, heartbeat batches are empty), so
+// the ring is indexed by arrival position rather than by id, and a completed
+// txn is located by binary search on the ids in the ring.
+//
+// Blocked txns are additionally linked, in queue order, into an intrusive list
+// so that selective contention analysis only visits them.
+
+#ifndef _DB_SCHEDULER_VLL_QUEUE_H_
+#define _DB_SCHEDULER_VLL_QUEUE_H_
+
+#include <vector>
+
+#include "common/types.h"
+
+using std::vector;
+
+class TxnProto;
+
+struct VllTxn {
+  int64 txn_id;
+
+  // NULL once the txn has released its locks.
+  TxnProto* txn;
+
+  // Lock table slots of the keys the txn locks at this node, hashed once on
+  // arrival: its write slots, followed by its read slots.
+  vector<int> slots;
+  int writes;
+
+  // Neighbours in the blocked list, while the txn is blocked.
+  VllTxn* prev_blocked;
+  VllTxn* next_blocked;
+};
+
+class VllQueue {
+ public:
+  explicit VllQueue(int capacity);
+
+  // Number of txns in the queue.
+  int size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // True if no txn can be appended until the oldest one completes.
+  bool full() const { return tail_ - head_ == capacity_; }
+
+  // Appends 'txn', whose id must be larger than that of every queued txn, and
+  // returns its entry with no slots.
+  VllTxn* Append(TxnProto* txn);
+
+  // Returns the entry of the queued txn 'txn_id'.
+  VllTxn* Find(int64 txn_id);
+
+  // Removes 'entry' (which must not be blocked) from the queue.
+  void Remove(VllTxn* entry);
+
+  // Returns the oldest txn in the queue, or NULL if it is empty.
+  VllTxn* front();
+
+  // Links 'entry', which must be the last appended one, into the blocked list.
+  void Block(VllTxn* entry);
+
+  // Unlinks 'entry' from the blocked list.
+  void Unblock(VllTxn* entry);
+
+  // Returns the oldest blocked txn, or NULL if there is none. The rest follow
+  // through 'next_blocked'.
+  VllTxn* first_blocked() { return first_blocked_; }
+  int blocked() const { return blocked_; }
+
+ private:
+  VllTxn* at(int64 position) { return &entries_[position % capacity_]; }
+
+  vector<VllTxn> entries_;
+  int64 capacity_;
+
+  // Positions of the oldest entry and one past the newest. Entries in between
+  // whose txn is NULL have completed out of order.
+  int64 head_;
+  int64 tail_;
+  int size_;
+
+  VllTxn* first_blocked_;
+  VllTxn* last_blocked_;
+  int blocked_;
+};
+
+#endif  // _DB_SCHEDULER_VLL_QUEUE_H_
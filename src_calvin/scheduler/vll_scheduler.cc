@@ -0,0 +1,203 @@
+// Author: Kun Ren (kun.ren@yale.edu)
+// Author: Alexander Thomson (thomson@cs.yale.edu)
+//
+// The deterministic lock manager implements deterministic locking as described
+// in 'The Case for Determinism in Database Systems', VLDB 2010. Each
+// transaction must request all locks it will ever need before the next
+// transaction in the specified order may acquire any locks. Each lock is then
+// granted to transactions in the order in which they requested them (i.e. in
+// the global transaction order).
+
+#include "scheduler/vll_scheduler.h"
+
+#include <string>
+#include <vector>
+
+#include "common/configuration.h"
+#include "common/definitions.hh"
+#include "proto/txn.pb.h"
+#include "scheduler/conflict_bitmap.h"
+#include "scheduler/lock_hold_stats.h"
+#include "scheduler/lock_slots.h"
+#include "scheduler/rebalance_advisor.h"
+#include "scheduler/vll_acquirer.h"
+#include "scheduler/vll_queue.h"
+
+using std::string;
+using std::vector;
+
+VllScheduler::VllScheduler(Configuration* conf,
+                           Connection* batch_connection,
+                           Storage* storage,
+                           const Application* application,
+                           int checkpoint_interval)
+    : LockingScheduler(conf, batch_connection, storage, application,
+                       checkpoint_interval) {
+  Start();
+}
+
+VllScheduler::~VllScheduler() {}
+
+// Adds 'delta' to the granted lock counts of each of 'entry's slots.
+static void CountGranted(const VllTxn& entry, int delta, vector<int>* Gx,
+                         vector<int>* Gs) {
+  for (int i = 0; i < entry.writes; i++)
+    (*Gx)[entry.slots[i]] += delta;
+  for (size_t i = entry.writes; i < entry.slots.size(); i++)
+    (*Gs)[entry.slots[i]] += delta;
+}
+
+// Selective contention analysis: unblocks, counts as granted and hands to
+// 'ready' every blocked txn in 'queue' that conflicts neither with a granted
+// txn nor with a blocked txn ahead of it. 'Dx' and 'Ds' are scratch space.
+static void AnalyzeContention(VllQueue* queue, vector<int>* Gx,
+                              vector<int>* Gs, ConflictBitmap* Dx,
+                              ConflictBitmap* Ds, LockHoldStats* hold_stats,
+                              AtomicQueue<TxnProto*>* ready) {
+  // Only the words set by the previous pass need clearing.
+  Dx->Clear();
+  Ds->Clear();
+
+  VllTxn* next;
+  for (VllTxn* entry = queue->first_blocked(); entry != NULL; entry = next) {
+    next = entry->next_blocked;
+    const int* writes = entry->slots.data();
+    int write_count = entry->writes;
+    const int* reads = writes + write_count;
+    int read_count = entry->slots.size() - write_count;
+
+    if (!AnyLocked(Gx->data(), writes, write_count) &&
+        !AnyLocked(Gs->data(), writes, write_count) &&
+        !AnyLocked(Gx->data(), reads, read_count) &&
+        !Dx->AnySet(writes, write_count) && !Ds->AnySet(writes, write_count) &&
+        !Dx->AnySet(reads, read_count)) {
+      queue->Unblock(entry);
+      CountGranted(*entry, 1, Gx, Gs);
+      entry->txn->set_status(TxnProto::ACTIVE);
+      hold_stats->Granted(entry->txn);
+      ready->Push(entry->txn);
+    }
+
+    // Blocked txns behind this one conflict with it either way.
+    Dx->Set(writes, write_count);
+    Ds->Set(reads, read_count);
+  }
+}
+
+void VllScheduler::RunLockManager() {
+  Configuration* configuration = configuration_;
+  int this_node_id = configuration->this_node_id;
+
+  // Lock threads parse txns and request their locks; this thread admits them
+  // to the queue in order, releases locks and runs SCA. Microbenchmark keys
+  // are ids below DB_SIZE times the number of nodes.
+  VllAcquirer acquirer(configuration, LockSlots::VLL_LOCK_SLOTS,
+                       DB_SIZE * configuration->all_nodes.size(),
+                       VLL_LOCK_THREADS, VLL_LOCK_PIPELINE);
+  VllQueue TxnsQueue(VLL_MAX_IN_FLIGHT);
+  // Write and read locks held by granted (ACTIVE) txns. A txn that conflicts
+  // with a blocked one is either granted and ahead of it, or blocked itself,
+  // so SCA only needs these and the blocked txns.
+  vector<int> Gx(acquirer.slots(), 0);
+  vector<int> Gs(acquirer.slots(), 0);
+
+  int sca = 0;
+  // Txns completed since the last SCA pass.
+  int released = 0;
+
+  ConflictBitmap Dx(acquirer.slots());
+  ConflictBitmap Ds(acquirer.slots());
+
+  LockHoldStats hold_stats(this_node_id);
+  RebalanceAdvisor advisor(configuration);
+
+  while (true) {
+    VllJob* job;
+    string* data;
+    TxnProto* done_txn;
+    bool got_it = done_queue->Pop(&done_txn);
+    if (got_it == true) {
+      // We have received a finished transaction back, release the locks
+      VllTxn* done = TxnsQueue.Find(done_txn->txn_id());
+      acquirer.Release(*done);
+      CountGranted(*done, -1, &Gx, &Gs);
+
+      // Remove the transaction from TxnsQueue;
+      TxnsQueue.Remove(done);
+      released++;
+      hold_stats.Released(done_txn);
+      Finish(done_txn);
+
+      // If the first action in the ActionQueue is BLOCKED, execute it.
+      VllTxn* front = TxnsQueue.front();
+      if (front != NULL) {
+        TxnProto* txn = front->txn;
+        if (txn->status() == TxnProto::BLOCKED) {
+          TxnsQueue.Unblock(front);
+          CountGranted(*front, 1, &Gx, &Gs);
+          txn->set_status(TxnProto::ACTIVE);
+          hold_stats.Granted(txn);
+          txns_queue->Push(txn);
+        }
+      }
+
+    } else if (TxnsQueue.blocked() > 0 && released >= VLL_SCA_RELEASES) {
+      // Enough locks have been released since the last pass that blocked txns
+      // deep in a large window may be able to run, long before they reach the
+      // front of the queue.
+      sca++;
+      released = 0;
+      AnalyzeContention(&TxnsQueue, &Gx, &Gs, &Dx, &Ds, &hold_stats,
+                        txns_queue);
+    } else if ((job = acquirer.Next()) != NULL) {
+      // A lock thread has requested the locks of the next txn.
+      TxnProto* txn = job->txn;
+      if (RegisterMigration(txn))
+        continue;
+
+      VllTxn& entry = *TxnsQueue.Append(txn);
+      entry.slots.swap(job->slots);
+      entry.writes = job->writes;
+      for (size_t i = 0; i < job->waits.size(); i++)
+        advisor.RecordWait(*job->waits[i]);
+
+      // A txn blocked only by locks released while it was requesting them has
+      // nothing left to wait for once it is at the front.
+      if (txn->status() == TxnProto::ACTIVE || &entry == TxnsQueue.front()) {
+        txn->set_status(TxnProto::ACTIVE);
+        CountGranted(entry, 1, &Gx, &Gs);
+        hold_stats.Granted(txn);
+        txns_queue->Push(txn);
+      } else {
+        TxnsQueue.Block(&entry);
+      }
+
+      // The next batch is only taken once every txn of this one has left the
+      // lock threads, so that migration txns are registered and the queue
+      // holds all txns of earlier batches.
+    } else if (HandleBatch(TxnsQueue.size(), acquirer.pending() > 0)) {
+      // Keep handing txns to the lock threads as long as the window has room
+      // and not too many are blocked.
+      if (!acquirer.full() &&
+          TxnsQueue.size() + acquirer.pending() < VLL_MAX_IN_FLIGHT &&
+          TxnsQueue.blocked() < VLL_MAX_BLOCKED &&
+          (data = NextTxnData()) != NULL) {
+        acquirer.Submit(data);
+      } else {
+        sca++;
+        released = 0;
+        AnalyzeContention(&TxnsQueue, &Gx, &Gs, &Dx, &Ds, &hold_stats,
+                          txns_queue);
+      }
+    }
+
+    // Report throughput.
+    if (ReportDue()) {
+      Report(std::to_string(sca) + "  " + std::to_string(TxnsQueue.size()) +
+             " Queueing, " + std::to_string(TxnsQueue.blocked()) +
+             " Blocking\n" + hold_stats.ReportStats() + "\n" +
+             advisor.ReportStats());
+      sca = 0;
+    }
+  }
+}
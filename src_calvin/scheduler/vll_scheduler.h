@@ -0,0 +1,29 @@
+// Author: Alexander Thomson (thomson@cs.yale.edu)
+// Author: Kun Ren (kun.ren@yale.edu)
+//
+// Deterministic locking with very lightweight locking (VLL) instead of a lock
+// table: every key maps to a counter of exclusive and one of shared lock
+// requests (see lock_slots.h), which lock threads bump in txn order (see
+// vll_acquirer.h). A txn runs once none of its counters shows an earlier
+// conflicting request or it is first in the queue of txns holding locks (see
+// vll_queue.h). Blocked txns that conflict with no granted txn are run early
+// by selective contention analysis.
+
+#ifndef _DB_SCHEDULER_VLL_SCHEDULER_H_
+#define _DB_SCHEDULER_VLL_SCHEDULER_H_
+
+#include "scheduler/locking_scheduler.h"
+
+class VllScheduler : public LockingScheduler {
+ public:
+  VllScheduler(Configuration* conf,
+               Connection* batch_connection,
+               Storage* storage,
+               const Application* application,
+               int checkpoint_interval = 0);
+  virtual ~VllScheduler();
+
+ private:
+  virtual void RunLockManager();
+};
+#endif  // _DB_SCHEDULER_VLL_SCHEDULER_H_
@@ -0,0 +1,166 @@
+// Append-only, group-committed log of sequenced batches.
+
+#include "sequencer/command_log.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "common/utils.h"
+
+namespace {
+
+// Reads exactly 'size' bytes at 'offset'. Returns false on a short read.
+bool ReadAt(int fd, int64 offset, char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = pread(fd, data, size, offset);
+    if (n <= 0)
+      return false;
+    data += n;
+    offset += n;
+    size -= n;
+  }
+  return true;
+}
+
+}  // namespace
+
+CommandLog::CommandLog(const string& path, Durability durability,
+                       bool recover)
+    : durability_(durability), replay_offset_(0), replay_end_(0),
+      interval_start_(GetTime()), records_(0), bytes_(0), syncs_(0),
+      sync_time_(0) {
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    perror(("Cannot open command log " + path).c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  if (recover)
+    replay_end_ = FindEnd();
+  // Drop everything after the last intact record: a batch whose write was
+  // interrupted was never dispatched, so it must not be replayed.
+  if (ftruncate(fd_, replay_end_) != 0 ||
+      lseek(fd_, replay_end_, SEEK_SET) != replay_end_) {
+    perror(("Cannot truncate command log " + path).c_str());
+    exit(EXIT_FAILURE);
+  }
+}
+
+CommandLog::~CommandLog() {
+  Commit();
+  close(fd_);
+}
+
+bool CommandLog::ParseDurability(const string& name, Durability* durability) {
+  if (name == "buffered")
+    *durability = BUFFERED;
+  else if (name == "fsync")
+    *durability = FSYNC;
+  else
+    return false;
+  return true;
+}
+
+int64 CommandLog::FindEnd() {
+  struct stat status;
+  if (fstat(fd_, &status) != 0) {
+    perror("Cannot stat command log");
+    exit(EXIT_FAILURE);
+  }
+  int64 offset = 0;
+  char header[kHeaderSize];
+  string payload;
+  while (ReadAt(fd_, offset, header, kHeaderSize)) {
+    uint32 length, crc;
+    memcpy(&length, header, 4);
+    memcpy(&crc, header + 4, 4);
+    // A torn header may claim any length; only trust one that fits the file.
+    if (offset + kHeaderSize + length > status.st_size)
+      break;
+    payload.resize(length);
+    if (length > 0 && !ReadAt(fd_, offset + kHeaderSize, &payload[0], length))
+      break;
+    if (Crc32(Crc32(0, header + 8, 8), payload.data(), length) != crc)
+      break;
+    offset += kHeaderSize + length;
+  }
+  return offset;
+}
+
+bool CommandLog::Replay(int64* batch_number, string* batch) {
+  if (replay_offset_ >= replay_end_)
+    return false;
+  char header[kHeaderSize];
+  uint32 length;
+  ReadAt(fd_, replay_offset_, header, kHeaderSize);
+  memcpy(&length, header, 4);
+  memcpy(batch_number, header + 8, 8);
+  batch->resize(length);
+  if (length > 0)
+    ReadAt(fd_, replay_offset_ + kHeaderSize, &(*batch)[0], length);
+  replay_offset_ += kHeaderSize + length;
+  return true;
+}
+
+void CommandLog::Append(int64 batch_number, const string& batch) {
+  char header[kHeaderSize];
+  uint32 length = batch.size();
+  memcpy(header, &length, 4);
+  memcpy(header + 8, &batch_number, 8);
+  uint32 crc = Crc32(Crc32(0, header + 8, 8), batch.data(), batch.size());
+  memcpy(header + 4, &crc, 4);
+  buffer_.append(header, kHeaderSize);
+  buffer_.append(batch);
+  records_++;
+}
+
+void CommandLog::Commit() {
+  if (buffer_.empty())
+    return;
+
+  const char* data = buffer_.data();
+  size_t size = buffer_.size();
+  while (size > 0) {
+    ssize_t n = write(fd_, data, size);
+    if (n < 0) {
+      perror("Cannot write command log");
+      exit(EXIT_FAILURE);
+    }
+    data += n;
+    size -= n;
+  }
+  bytes_ += buffer_.size();
+  buffer_.clear();
+
+  if (durability_ == FSYNC) {
+    double start = GetTime();
+    if (fdatasync(fd_) != 0) {
+      perror("Cannot sync command log");
+      exit(EXIT_FAILURE);
+    }
+    sync_time_ += GetTime() - start;
+    syncs_++;
+  }
+}
+
+string CommandLog::ReportStats() {
+  double now = GetTime();
+  double elapsed = now - interval_start_;
+  char buffer[160];
+  snprintf(buffer, sizeof(buffer),
+           "Command log: %d batches, %.2f MB/s, %d syncs (avg %.3f ms)",
+           records_, elapsed > 0 ? bytes_ / elapsed / 1048576 : 0, syncs_,
+           syncs_ > 0 ? sync_time_ * 1000 / syncs_ : 0);
+  interval_start_ = now;
+  records_ = 0;
+  bytes_ = 0;
+  syncs_ = 0;
+  sync_time_ = 0;
+  return string(buffer);
+}
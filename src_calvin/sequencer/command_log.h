@@ -0,0 +1,84 @@
+// The command log persists the input of the system: every batch a sequencer
+// orders, before it is dispatched. Since execution is deterministic, replaying
+// the logged batches in order on top of the initial database rebuilds the
+// state the node had when it stopped.
+//
+// The log is a single append-only file of records
+//
+//   <length:uint32> <crc32:uint32> <batch_number:int64> <batch:length bytes>
+//
+// where the CRC covers the batch number and the batch. Appended records are
+// buffered and written out (group committed) by Commit(), which the sequencer
+// calls once per epoch. Depending on the durability mode, Commit() also
+// fdatasync()s the file, so that a batch is only dispatched once it is on
+// stable storage.
+
+#ifndef _DB_SEQUENCER_COMMAND_LOG_H_
+#define _DB_SEQUENCER_COMMAND_LOG_H_
+
+#include <string>
+
+#include "common/types.h"
+
+using std::string;
+
+class CommandLog {
+ public:
+  enum Durability {
+    BUFFERED,  // Written to the OS on commit; lost if the machine crashes.
+    FSYNC,     // fdatasync()ed on commit.
+  };
+
+  // Opens the log at 'path', creating it if needed. If 'recover' is true, the
+  // records already in the file are kept for Replay() and new records are
+  // appended after them; a partially written record at the end is cut off.
+  // Otherwise the file is truncated. Exits if the file cannot be opened.
+  CommandLog(const string& path, Durability durability, bool recover);
+  ~CommandLog();
+
+  // Parses a durability mode ("buffered" or "fsync"). Returns false if 'name'
+  // is not one.
+  static bool ParseDurability(const string& name, Durability* durability);
+
+  // Reads the next record kept at startup into '*batch_number' and '*batch'.
+  // Returns false once all of them have been read.
+  bool Replay(int64* batch_number, string* batch);
+
+  // Buffers a record for 'batch'.
+  void Append(int64 batch_number, const string& batch);
+
+  // Writes all buffered records and, in FSYNC mode, waits until they are
+  // durable.
+  void Commit();
+
+  // Returns a one-line summary of the records, bytes and time spent syncing
+  // since the previous call.
+  string ReportStats();
+
+ private:
+  static const int kHeaderSize = 16;
+
+  // Scans the file from the start and returns the offset just past the last
+  // complete record with a valid checksum.
+  int64 FindEnd();
+
+  int fd_;
+  Durability durability_;
+
+  // Offset of the next record for Replay() and of the end of the records
+  // found at startup.
+  int64 replay_offset_;
+  int64 replay_end_;
+
+  // Records appended since the last Commit().
+  string buffer_;
+
+  // Counters for the current reporting interval.
+  double interval_start_;
+  int records_;
+  int64 bytes_;
+  int syncs_;
+  double sync_time_;
+};
+
+#endif  // _DB_SEQUENCER_COMMAND_LOG_H_
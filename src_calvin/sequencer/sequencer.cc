@@ -8,6 +8,8 @@
 
 #include "sequencer/sequencer.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <map>
 #include <queue>
@@ -19,6 +21,7 @@
 #include "common/connection.h"
 #include "common/utils.h"
 #include "common/debug.hh"
+#include "sequencer/command_log.h"
 #include "proto/message.pb.h"
 #include "proto/txn.pb.h"
 #ifdef PAXOS
@@ -30,6 +33,17 @@ using std::multimap;
 using std::queue;
 using std::set;
 
+namespace {
+
+// A txn held back by the writer until its objects at this node are in memory.
+struct HeldTxn {
+  TxnProto* txn;
+  vector<const Key*> keys;
+  double held_since;
+};
+
+}  // namespace
+
 #ifdef LATENCY_TEST
 double sequencer_recv[SAMPLES];
 // double paxos_begin[SAMPLES];
@@ -55,12 +69,22 @@ void* Sequencer::RunSequencerReader(void* arg) {
 Sequencer::Sequencer(Configuration* conf,
                      Connection* connection,
                      Client* client,
-                     Storage* storage)
+                     Storage* storage,
+                     CommandLog* command_log,
+                     bool replay,
+                     bool prefetch,
+                     ReadOnlyExecutor* read_only_executor,
+                     int64 restored)
     : epoch_duration_(EPOCH_DURATION),
       configuration_(conf),
       connection_(connection),
       client_(client),
       storage_(storage),
+      command_log_(command_log),
+      replay_(replay),
+      restored_(restored),
+      prefetch_(prefetch),
+      read_only_executor_(read_only_executor),
       deconstructor_invoked_(false) {
   pthread_mutex_init(&mutex_, NULL);
   // Start Sequencer main loops running in background thread.
@@ -93,6 +117,26 @@ Sequencer::~Sequencer() {
   pthread_join(reader_thread_, NULL);
 }
 
+bool Sequencer::SubmitMigration(const string& spec) {
+  char table;
+  int64 lo, hi;
+  int node;
+  if (!PartitionMap::ParseMigration(spec, &table, &lo, &hi, &node) ||
+      node < 0 || node >= static_cast<int>(configuration_->all_nodes.size()))
+    return false;
+  MigrationProto migration;
+  migration.set_table(table == '\0' ? string() : string(1, table));
+  migration.set_first_id(lo);
+  migration.set_last_id(hi);
+  migration.set_node(node);
+  string migration_string;
+  migration.SerializeToString(&migration_string);
+  pthread_mutex_lock(&mutex_);
+  migrations_.push(migration_string);
+  pthread_mutex_unlock(&mutex_);
+  return true;
+}
+
 void Sequencer::FindParticipatingNodes(const TxnProto& txn, set<int>* nodes) {
   nodes->clear();
   for (int i = 0; i < txn.read_set_size(); i++)
@@ -103,29 +147,42 @@ void Sequencer::FindParticipatingNodes(const TxnProto& txn, set<int>* nodes) {
     nodes->insert(configuration_->LookupPartition(txn.read_write_set(i)));
 }
 
-#ifdef PREFETCHING
-double PrefetchAll(Storage* storage, TxnProto* txn) {
+void Sequencer::FindLocalKeys(const TxnProto& txn,
+                              vector<const Key*>* keys) {
+  keys->clear();
+  int node = configuration_->this_node_id;
+  for (int i = 0; i < txn.read_set_size(); i++)
+    if (configuration_->LookupPartition(txn.read_set(i)) == node)
+      keys->push_back(&txn.read_set(i));
+  for (int i = 0; i < txn.read_write_set_size(); i++)
+    if (configuration_->LookupPartition(txn.read_write_set(i)) == node)
+      keys->push_back(&txn.read_write_set(i));
+  for (int i = 0; i < txn.write_set_size(); i++)
+    if (configuration_->LookupPartition(txn.write_set(i)) == node)
+      keys->push_back(&txn.write_set(i));
+}
+
+double Sequencer::PrefetchAll(const vector<const Key*>& keys) {
   double max_wait_time = 0;
-  double wait_time = 0;
-  for (int i = 0; i < txn->read_set_size(); i++) {
-    storage->Prefetch(txn->read_set(i), &wait_time);
-    max_wait_time = MAX(max_wait_time, wait_time);
-  }
-  for (int i = 0; i < txn->read_write_set_size(); i++) {
-    storage->Prefetch(txn->read_write_set(i), &wait_time);
-    max_wait_time = MAX(max_wait_time, wait_time);
+  for (size_t i = 0; i < keys.size(); i++) {
+    double wait_time = 0;
+    storage_->Prefetch(*keys[i], &wait_time);
+    max_wait_time = std::max(max_wait_time, wait_time);
   }
-  for (int i = 0; i < txn->write_set_size(); i++) {
-    storage->Prefetch(txn->write_set(i), &wait_time);
-    max_wait_time = MAX(max_wait_time, wait_time);
-  }
-#ifdef LATENCY_TEST
-  if (txn->txn_id() % SAMPLE_RATE == 0)
-    prefetch_cold[txn->txn_id() / SAMPLE_RATE] = max_wait_time;
-#endif
   return max_wait_time;
 }
-#endif
+
+double Sequencer::FetchWait(const vector<const Key*>& keys) {
+  double max_wait_time = 0;
+  for (size_t i = 0; i < keys.size(); i++)
+    max_wait_time = std::max(max_wait_time, storage_->FetchWait(*keys[i]));
+  return max_wait_time;
+}
+
+void Sequencer::UnfetchAll(const vector<const Key*>& keys) {
+  for (size_t i = 0; i < keys.size(); i++)
+    storage_->Unfetch(*keys[i]);
+}
 
 void Sequencer::RunWriter() {
   PrintCpu("RunWriter", 0);
@@ -136,9 +193,13 @@ void Sequencer::RunWriter() {
   Paxos paxos(ZOOKEEPER_CONF, false);
 #endif
 
-#ifdef PREFETCHING
-  multimap<double, TxnProto*> fetching_txns;
-#endif
+  // Held back txns, by when to check on them next, and what became of them
+  // since the last report.
+  multimap<double, HeldTxn> held_txns;
+  int held_count = 0;
+  int admitted_resident = 0;
+  int admitted_cold = 0;
+  double held_time = 0;
 
   // Synchronization loadgen start with other sequencers.
   MessageProto synchronization_message;
@@ -166,15 +227,139 @@ void Sequencer::RunWriter() {
   string batch_string;
   batch.set_type(MessageProto::TXN_BATCH);
 
-  for (int batch_number = configuration_->this_node_id; !deconstructor_invoked_;
-       batch_number += configuration_->all_nodes.size()) {
+  // Dispatch the batches logged by an earlier run before ordering new ones.
+  // They keep their batch numbers, and new batches continue where they end.
+  int first_batch_number = configuration_->this_node_id;
+  if (command_log_ != NULL && replay_) {
+    double replay_start = GetTime();
+    int replayed_batches = 0;
+    int replayed_txns = 0;
+    int skipped_txns = 0;
+    int64 logged_batch_number;
+    while (command_log_->Replay(&logged_batch_number, &batch_string)) {
+      if (logged_batch_number != first_batch_number) {
+        std::cout << "Command log has batch " << logged_batch_number
+                  << " where " << first_batch_number
+                  << " was expected, not replaying further.\n" << std::flush;
+        break;
+      }
+      batch.ParseFromString(batch_string);
+      // The restored checkpoint already holds the effects of this batch.
+      if ((logged_batch_number + 1) * MAX_LOCK_BATCH_SIZE - 1 <= restored_) {
+        int kept = 0;
+        for (int i = 0; i < batch.data_size(); i++) {
+          TxnProto txn;
+          txn.ParseFromString(batch.data(i));
+          if (txn.has_migration())
+            batch.mutable_data()->SwapElements(i, kept++);
+        }
+        skipped_txns += batch.data_size() - kept;
+        while (batch.data_size() > kept)
+          batch.mutable_data()->RemoveLast();
+        batch.SerializeToString(&batch_string);
+      }
+      replayed_txns += batch.data_size();
+#ifdef PAXOS
+      paxos.SubmitBatch(batch_string);
+#else
+      pthread_mutex_lock(&mutex_);
+      batch_queue_.push(batch_string);
+      pthread_mutex_unlock(&mutex_);
+#endif
+      replayed_batches++;
+      first_batch_number += configuration_->all_nodes.size();
+    }
+    double replay_time = GetTime() - replay_start;
+    std::cout << "Replayed " << replayed_batches << " batches ("
+              << replayed_txns << " txns) from the command log in "
+              << replay_time << " s ("
+              << (replay_time > 0 ? replayed_txns / replay_time : 0)
+              << " txns/s), skipped " << skipped_txns
+              << " txns the checkpoint holds\n" << std::flush;
+  }
+  double report_time = GetTime();
+
+  // Epochs are laid out on a fixed schedule starting now rather than chained
+  // off the end of the previous one, so per-epoch overhead does not make this
+  // sequencer drift behind the others (every scheduler waits for the slowest
+  // sequencer's batch before it can move on). An epoch whose slot has already
+  // passed when we get to it is sent out immediately as an empty heartbeat
+  // batch, letting the sequencer catch up with the schedule.
+  double start_time = GetTime();
+  int64 epoch = 0;
+  for (int batch_number = first_batch_number; !deconstructor_invoked_;
+       batch_number += configuration_->all_nodes.size(), epoch++) {
     // Begin epoch.
-    double epoch_start = GetTime();
+    double epoch_start = start_time + epoch * epoch_duration_;
     batch.set_batch_number(batch_number);
     batch.clear_data();
 
     // Collect txn requests for this epoch.
     int txn_id_offset = 0;
+
+    // Migrations go first, ordered like any other txn.
+    pthread_mutex_lock(&mutex_);
+    while (!migrations_.empty() && batch.data_size() < MAX_LOCK_BATCH_SIZE) {
+      TxnProto txn;
+      string txn_string;
+      txn.set_txn_id(batch_number * MAX_LOCK_BATCH_SIZE + txn_id_offset);
+      txn.mutable_migration()->ParseFromString(migrations_.front());
+      migrations_.pop();
+      txn.SerializeToString(&txn_string);
+      batch.add_data(txn_string);
+      txn_id_offset++;
+    }
+    pthread_mutex_unlock(&mutex_);
+
+    // Then dependent txns restarted by the schedulers with their keys
+    // predicted again (see scheduler/txn_restarter.h). Restarts of replayed
+    // txns were logged with the batches that ordered them, and are dropped.
+    MessageProto restart_message;
+    while (batch.data_size() < MAX_LOCK_BATCH_SIZE &&
+           connection_->GetMessage(&restart_message)) {
+      assert(restart_message.type() == MessageProto::TXN_PROTO);
+      TxnProto txn;
+      string txn_string;
+      txn.ParseFromString(restart_message.data(0));
+      if (txn.txn_id() / MAX_LOCK_BATCH_SIZE < first_batch_number)
+        continue;
+      txn.set_txn_id(batch_number * MAX_LOCK_BATCH_SIZE + txn_id_offset);
+      txn.SerializeToString(&txn_string);
+      batch.add_data(txn_string);
+      txn_id_offset++;
+    }
+
+    // Then held back txns whose objects have arrived, or that have waited as
+    // long as they may (they will stall on the disk when they run). They are
+    // renumbered, as their ids were handed out again in the epoch that held
+    // them back.
+    double now = GetTime();
+    while (!held_txns.empty() && held_txns.begin()->first <= now &&
+           batch.data_size() < MAX_LOCK_BATCH_SIZE) {
+      HeldTxn held = held_txns.begin()->second;
+      held_txns.erase(held_txns.begin());
+      double wait_time = FetchWait(held.keys);
+      double deadline = held.held_since + PREFETCH_MAX_WAIT;
+      if (wait_time > 0 && now < deadline) {
+        held_txns.insert(
+            std::make_pair(std::min(now + wait_time, deadline), held));
+        continue;
+      }
+      if (wait_time > 0)
+        admitted_cold++;
+      else
+        admitted_resident++;
+      held_time += now - held.held_since;
+      UnfetchAll(held.keys);
+
+      string txn_string;
+      held.txn->set_txn_id(batch_number * MAX_LOCK_BATCH_SIZE + txn_id_offset);
+      held.txn->SerializeToString(&txn_string);
+      batch.add_data(txn_string);
+      txn_id_offset++;
+      delete held.txn;
+    }
+
     while (!deconstructor_invoked_ &&
            GetTime() < epoch_start + epoch_duration_) {
       // Add next txn request to batch.
@@ -183,6 +368,13 @@ void Sequencer::RunWriter() {
         string txn_string;
         client_->GetTxn(&txn,
                         batch_number * MAX_LOCK_BATCH_SIZE + txn_id_offset);
+#ifdef LATENCY_TEST
+        if (txn->txn_id() % SAMPLE_RATE == 0) {
+          sequencer_recv[txn->txn_id() / SAMPLE_RATE] =
+              epoch_start +
+              epoch_duration_ * (static_cast<double>(rand()) / RAND_MAX);
+        }
+#endif
 
         // Find a bad transaction
         if (txn->txn_id() == -1) {
@@ -190,6 +382,30 @@ void Sequencer::RunWriter() {
           continue;
         }
 
+        // Read-only txns may skip ordering altogether. Their id is handed
+        // out again.
+        if (read_only_executor_ != NULL && read_only_executor_->Divert(txn))
+          continue;
+
+        if (prefetch_) {
+          // Objects only count as in memory while pinned, so they are pinned
+          // until the txn goes into a batch.
+          HeldTxn held = {txn, vector<const Key*>(), GetTime()};
+          FindLocalKeys(*txn, &held.keys);
+          double wait_time = PrefetchAll(held.keys);
+#ifdef LATENCY_TEST
+          if (txn->txn_id() % SAMPLE_RATE == 0)
+            prefetch_cold[txn->txn_id() / SAMPLE_RATE] = wait_time;
+#endif
+          if (wait_time > 0) {
+            held_txns.insert(
+                std::make_pair(held.held_since + wait_time, held));
+            held_count++;
+            continue;
+          }
+          UnfetchAll(held.keys);
+        }
+
         txn->SerializeToString(&txn_string);
         batch.add_data(txn_string);
         txn_id_offset++;
@@ -197,8 +413,20 @@ void Sequencer::RunWriter() {
       }
     }
 
+    // Start reading the held back txns' objects together.
+    if (prefetch_)
+      storage_->SubmitPrefetches();
+
     // Send this epoch's requests to Paxos service.
     batch.SerializeToString(&batch_string);
+
+    // Log the batch before anyone can act on it. One commit per epoch, so
+    // in FSYNC mode each epoch costs a single fdatasync.
+    if (command_log_ != NULL) {
+      command_log_->Append(batch_number, batch_string);
+      command_log_->Commit();
+    }
+
 #ifdef PAXOS
     paxos.SubmitBatch(batch_string);
 #else
@@ -206,6 +434,31 @@ void Sequencer::RunWriter() {
     batch_queue_.push(batch_string);
     pthread_mutex_unlock(&mutex_);
 #endif
+
+    if ((command_log_ != NULL || prefetch_) && GetTime() > report_time + 1) {
+      if (command_log_ != NULL)
+        std::cout << command_log_->ReportStats() << "\n";
+      if (prefetch_) {
+        int admitted = admitted_resident + admitted_cold;
+        printf("Prefetch: %d txns held back, %d admitted (%d still on disk), "
+               "avg hold %.3f ms, %d waiting\n",
+               held_count, admitted, admitted_cold,
+               admitted > 0 ? held_time * 1000 / admitted : 0,
+               static_cast<int>(held_txns.size()));
+        held_count = 0;
+        admitted_resident = 0;
+        admitted_cold = 0;
+        held_time = 0;
+      }
+      std::cout << std::flush;
+      report_time = GetTime();
+    }
+  }
+
+  for (multimap<double, HeldTxn>::iterator it = held_txns.begin();
+       it != held_txns.end(); ++it) {
+    UnfetchAll(it->second.keys);
+    delete it->second.txn;
   }
 
   Spin(1);
@@ -231,6 +484,7 @@ void Sequencer::RunReader() {
   double time = GetTime();
   int txn_count = 0;
   int batch_count = 0;
+  int heartbeat_count = 0;
   int batch_number = configuration_->this_node_id;
 
 #ifdef LATENCY_TEST
@@ -258,10 +512,31 @@ void Sequencer::RunReader() {
     } while (!got_batch);
 #endif
     batch_message.ParseFromString(batch_string);
+
+    // Route the batch under the partitioning that applies to it. It is known
+    // once the local scheduler has seen every migration ordered at least
+    // migration_lead() batches earlier, since later ones cannot take effect by
+    // this batch (see scheduler/partition_migrator.h).
+    while (!deconstructor_invoked_ &&
+           configuration_->migrations_known_through() <
+               batch_number - configuration_->migration_lead())
+      Spin(0.001);
+    const PartitionMap* partition_map =
+        configuration_->PartitionMapAt(batch_number);
+
     for (int i = 0; i < batch_message.data_size(); i++) {
       TxnProto txn;
       txn.ParseFromString(batch_message.data(i));
 
+      // Every node switches partitioning, so every node gets the migration.
+      if (txn.has_migration()) {
+        for (map<int, MessageProto>::iterator it = batches.begin();
+             it != batches.end(); ++it)
+          it->second.add_data(batch_message.data(i));
+        txn_count++;
+        continue;
+      }
+
 #ifdef LATENCY_TEST
       if (txn.txn_id() % SAMPLE_RATE == 0)
         watched_txn = txn.txn_id();
@@ -271,12 +546,12 @@ void Sequencer::RunReader() {
       set<int> readers;
       set<int> writers;
       for (int i = 0; i < txn.read_set_size(); i++)
-        readers.insert(configuration_->LookupPartition(txn.read_set(i)));
+        readers.insert(partition_map->Lookup(txn.read_set(i)));
       for (int i = 0; i < txn.write_set_size(); i++)
-        writers.insert(configuration_->LookupPartition(txn.write_set(i)));
+        writers.insert(partition_map->Lookup(txn.write_set(i)));
       for (int i = 0; i < txn.read_write_set_size(); i++) {
-        writers.insert(configuration_->LookupPartition(txn.read_write_set(i)));
-        readers.insert(configuration_->LookupPartition(txn.read_write_set(i)));
+        writers.insert(partition_map->Lookup(txn.read_write_set(i)));
+        readers.insert(partition_map->Lookup(txn.read_write_set(i)));
       }
 
       for (set<int>::iterator it = readers.begin(); it != readers.end(); ++it)
@@ -297,8 +572,12 @@ void Sequencer::RunReader() {
 
       txn_count++;
     }
+    if (batch_message.data_size() == 0)
+      heartbeat_count++;
 
-    // Send this epoch's requests to all schedulers.
+    // Send this epoch's requests to all schedulers. Nodes not involved in any
+    // of them still get an (empty) batch, which serves as a heartbeat telling
+    // their schedulers that this sequencer has nothing to order in the epoch.
     for (map<int, MessageProto>::iterator it = batches.begin();
          it != batches.end(); ++it) {
       it->second.set_batch_number(batch_number);
@@ -319,13 +598,14 @@ void Sequencer::RunReader() {
     if (GetTime() > time + 1) {
 #ifdef VERBOSE_SEQUENCER
       std::cout << "Submitted " << txn_count << " txns in " << batch_count
-                << " batches,\n"
+                << " batches (" << heartbeat_count << " heartbeats),\n"
                 << std::flush;
 #endif
       // Reset txn count.
       time = GetTime();
       txn_count = 0;
       batch_count = 0;
+      heartbeat_count = 0;
     }
   }
   Spin(1);
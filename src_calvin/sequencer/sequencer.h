@@ -10,11 +10,12 @@
 #include <set>
 #include <string>
 #include <queue>
+#include <vector>
 
 #include "common/definitions.hh"
+#include "common/types.h"
 
 // #define PAXOS
-// #define PREFETCHING
 
 #define SAMPLES 100000
 #define SAMPLE_RATE 999
@@ -24,7 +25,9 @@
 using std::queue;
 using std::set;
 using std::string;
+using std::vector;
 
+class CommandLog;
 class Configuration;
 class Connection;
 class Storage;
@@ -48,24 +51,58 @@ class Client {
   virtual void GetTxn(TxnProto** txn, int txn_id) = 0;
 };
 
+// Serves txns that need not be ordered, such as read-only ones.
+class ReadOnlyExecutor {
+ public:
+  virtual ~ReadOnlyExecutor() {}
+
+  // Takes over 'txn' and returns true if it can be served without ordering,
+  // or returns false, leaving it to the caller.
+  virtual bool Divert(TxnProto* txn) = 0;
+};
+
 class Sequencer {
  public:
   // The constructor creates background threads and starts the Sequencer's main
-  // loops running.
+  // loops running. If 'command_log' is not NULL, every batch is logged to it
+  // before it is dispatched; if 'replay' is also true, the batches already in
+  // the log are dispatched again first, rebuilding the state they produced.
+  // If 'prefetch' is true, txns whose objects at this node are on disk are
+  // held back (for up to PREFETCH_MAX_WAIT) until 'storage' has read them in.
+  // If 'read_only_executor' is not NULL, txns it takes over are not ordered.
+  // If 'storage' was restored from the checkpoint as of txn 'restored', the
+  // replayed batches up to it are dispatched without their txns, whose
+  // effects the checkpoint holds; only migrations are kept, so that the
+  // partitioning still changes when it did.
   Sequencer(Configuration* conf,
             Connection* connection,
             Client* client,
-            Storage* storage);
+            Storage* storage,
+            CommandLog* command_log = NULL,
+            bool replay = false,
+            bool prefetch = false,
+            ReadOnlyExecutor* read_only_executor = NULL,
+            int64 restored = -1);
 
   // Halts the main loops.
   ~Sequencer();
 
+  // Orders a migration txn (see scheduler/partition_migrator.h) moving the
+  // range given by 'spec' ("<table>:<lo>-<hi>@<node>") in the next epoch.
+  // Returns false if 'spec' is malformed.
+  bool SubmitMigration(const string& spec);
+
  private:
   // Sequencer's main loops:
   //
   // RunWriter:
+  //  replay logged batches, if asked to
   //  while true:
-  //    Spend epoch_duration collecting client txn requests into a batch.
+  //    Add restarted dependent txns to a batch.
+  //    Add held back txns whose objects are now in memory to the batch.
+  //    Spend epoch_duration collecting client txn requests into the batch,
+  //    holding back those that have to wait for the disk.
+  //    Append batch to the command log.
   //    Send batch to Paxos service.
   //
   // RunReader:
@@ -84,6 +121,20 @@ class Sequencer {
   // Sets '*nodes' to contain the node_id of every node participating in 'txn'.
   void FindParticipatingNodes(const TxnProto& txn, set<int>* nodes);
 
+  // Sets '*keys' to the keys of 'txn' stored at this node.
+  void FindLocalKeys(const TxnProto& txn, vector<const Key*>* keys);
+
+  // Pins the objects in 'keys' in storage and returns the expected time until
+  // they are all in memory.
+  double PrefetchAll(const vector<const Key*>& keys);
+
+  // Returns the expected time until the objects in 'keys', pinned by
+  // PrefetchAll(), are all in memory.
+  double FetchWait(const vector<const Key*>& keys);
+
+  // Releases the pins taken by PrefetchAll().
+  void UnfetchAll(const vector<const Key*>& keys);
+
   // Length of time spent collecting client requests before they are ordered,
   // batched, and sent out to schedulers.
   double epoch_duration_;
@@ -100,6 +151,21 @@ class Sequencer {
   // Pointer to this node's storage object, for prefetching.
   Storage* storage_;
 
+  // Log of every batch ordered by this sequencer, or NULL.
+  CommandLog* command_log_;
+
+  // True if the batches in 'command_log_' are to be dispatched at startup.
+  bool replay_;
+
+  // Txn id of the checkpoint the storage was restored from, or -1.
+  int64 restored_;
+
+  // True if txns are held back until their objects are in memory.
+  bool prefetch_;
+
+  // Executor for txns that bypass ordering, or NULL.
+  ReadOnlyExecutor* read_only_executor_;
+
   // Separate pthread contexts in which to run the sequencer's main loops.
   pthread_t writer_thread_;
   pthread_t reader_thread_;
@@ -110,6 +176,9 @@ class Sequencer {
 
   // Queue for sending batches from writer to reader if not in paxos mode.
   queue<string> batch_queue_;
+
+  // Serialized MigrationProtos waiting to be ordered by the writer.
+  queue<string> migrations_;
   pthread_mutex_t mutex_;
 };
 #endif  // _DB_SEQUENCER_SEQUENCER_H_
@@ -0,0 +1,61 @@
+#include "scheduler/batch_merger.h"
+
+#include "common/testing.h"
+#include "proto/message.pb.h"
+
+MessageProto* NewBatch(int64 batch_number, int txns) {
+  MessageProto* batch = new MessageProto();
+  batch->set_type(MessageProto::TXN_BATCH);
+  batch->set_destination_channel("scheduler_");
+  batch->set_destination_node(0);
+  batch->set_batch_number(batch_number);
+  for (int i = 0; i < txns; i++)
+    batch->add_data("txn");
+  return batch;
+}
+
+TEST(BatchMergerOrderTest) {
+  BatchMerger merger(3, NULL);
+
+  // Sequencer 1 runs ahead of sequencer 0; sequencer 2 only sends heartbeats.
+  merger.AddBatch(NewBatch(1, 5));
+  merger.AddBatch(NewBatch(4, 5));
+  merger.AddBatch(NewBatch(2, 0));
+  EXPECT_EQ(3, merger.buffered_batches());
+  EXPECT_TRUE(merger.GetBatch(0) == NULL);
+
+  merger.AddBatch(NewBatch(0, 2));
+  for (int64 i = 0; i < 3; i++) {
+    MessageProto* batch = merger.GetBatch(i);
+    EXPECT_TRUE(batch != NULL);
+    EXPECT_EQ(i, batch->batch_number());
+    delete batch;
+  }
+  EXPECT_TRUE(merger.GetBatch(3) == NULL);
+  EXPECT_EQ(1, merger.buffered_batches());
+
+  END;
+}
+
+TEST(BatchMergerWatermarkTest) {
+  BatchMerger merger(2, NULL);
+  EXPECT_EQ(-2, merger.watermark(0));
+  EXPECT_EQ(-1, merger.watermark(1));
+
+  merger.AddBatch(NewBatch(0, 1));
+  EXPECT_EQ(0, merger.watermark(0));
+
+  // Batch 4 arrives before batch 2: the watermark waits for the gap to close.
+  merger.AddBatch(NewBatch(4, 1));
+  EXPECT_EQ(0, merger.watermark(0));
+  merger.AddBatch(NewBatch(2, 1));
+  EXPECT_EQ(4, merger.watermark(0));
+  EXPECT_EQ(-1, merger.watermark(1));
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  BatchMergerOrderTest();
+  BatchMergerWatermarkTest();
+}
@@ -0,0 +1,140 @@
+#include "backend/checkpoint_loader.h"
+
+#include <cstdio>
+
+#include "applications/tpcc.h"
+#include "backend/checkpoint.h"
+#include "backend/collapsed_versioned_storage.h"
+#include "backend/simple_storage.h"
+#include "backend/storage_manager.h"
+#include "common/configuration.h"
+#include "common/testing.h"
+#include "common/utils.h"
+#include "proto/tpcc_args.pb.h"
+
+// Writes a checkpoint as of txn 'stable' of objects "0" to "<objects - 1>".
+void WriteCheckpoint(int64 stable, int objects) {
+  CollapsedVersionedStorage storage;
+  for (int i = 0; i < objects; i++)
+    storage.PutObject(IntToString(i), new Value(IntToString(i * 2)), 0);
+  storage.PrepareForCheckpoint(stable);
+  storage.Checkpoint();
+  while (storage.Checkpointing())
+    Spin(0.01);
+}
+
+// Removes whatever parts of the checkpoint as of txn 'stable' exist.
+void RemoveCheckpoint(int64 stable) {
+  for (int part = 0; part < CHECKPOINT_THREADS; part++)
+    remove(CheckpointPath(CHKPNTDIR, stable, part).c_str());
+}
+
+TEST(CheckpointLoaderTest) {
+  WriteCheckpoint(41, 100);
+  WriteCheckpoint(43, 1000);
+
+  CheckpointLoader loader(CHKPNTDIR);
+  EXPECT_EQ(43, loader.FindLatest());
+
+  SimpleStorage storage;
+  storage.Initmutex();
+  EXPECT_TRUE(loader.Load(43, &storage));
+  EXPECT_EQ(1000, loader.objects());
+  EXPECT_EQ(string("0"), *storage.ReadObject("0"));
+  EXPECT_EQ(string("1998"), *storage.ReadObject("999"));
+  EXPECT_TRUE(storage.ReadObject("1000") == NULL);
+
+  // The storage owns every loaded value and frees it when it is deleted.
+  EXPECT_TRUE(storage.DeleteObject("0"));
+  EXPECT_TRUE(storage.ReadObject("0") == NULL);
+
+  END;
+}
+
+TEST(CorruptCheckpointTest) {
+  WriteCheckpoint(47, 100);
+
+  // Flip a byte in the middle of a part.
+  string path = CheckpointPath(CHKPNTDIR, 47, 1);
+  FILE* file = fopen(path.c_str(), "r+");
+  fseek(file, sizeof(CheckpointHeader) + 4, SEEK_SET);
+  int c = fgetc(file);
+  fseek(file, sizeof(CheckpointHeader) + 4, SEEK_SET);
+  fputc(c ^ 0x40, file);
+  fclose(file);
+
+  CheckpointLoader loader(CHKPNTDIR);
+  SimpleStorage storage;
+  storage.Initmutex();
+  EXPECT_FALSE(loader.Load(47, &storage));
+
+  // A missing part makes the checkpoint incomplete.
+  remove(path.c_str());
+  EXPECT_FALSE(loader.Load(47, &storage));
+  EXPECT_EQ(43, loader.FindLatest());
+
+  RemoveCheckpoint(41);
+  RemoveCheckpoint(43);
+  RemoveCheckpoint(47);
+  END;
+}
+
+// Generates 'count' new orders with 'client' and runs them against 'storage',
+// numbering them from '*txn_id' on. Each order must be a new one.
+void RunNewOrders(const TPCC& client, Storage* storage, Configuration* config,
+                  int64* txn_id, int count) {
+  for (int i = 0; i < count; i++) {
+    TPCCArgs args;
+    args.set_system_time(GetTime());
+    args.set_multipartition(false);
+    string args_string;
+    args.SerializeToString(&args_string);
+    TxnProto* txn =
+        client.NewTxn((*txn_id)++, TPCC::NEW_ORDER, args_string, config);
+    txn->add_readers(0);
+    txn->add_writers(0);
+
+    // The write set ends in the new order, the order and the customer's
+    // latest order.
+    Value order;
+    EXPECT_FALSE(storage->CopyObject(
+        txn->write_set(txn->write_set_size() - 2), &order));
+    StorageManager manager(config, NULL, storage, txn);
+    EXPECT_EQ(SUCCESS, TPCC().Execute(txn, &manager));
+    delete txn;
+  }
+}
+
+TEST(TpccRestoreTest) {
+  Configuration config(0, "common/configuration_test_one_node.conf");
+  int64 txn_id = 0;
+  {
+    CollapsedVersionedStorage storage;
+    TPCC client;
+    client.InitializeStorage(&storage, &config);
+    RunNewOrders(client, &storage, &config, &txn_id, 100);
+    storage.PrepareForCheckpoint(txn_id - 1);
+    storage.Checkpoint();
+    while (storage.Checkpointing())
+      Spin(0.01);
+  }
+
+  // A restored node builds its items and continues the restored orders.
+  SimpleStorage storage;
+  storage.Initmutex();
+  CheckpointLoader loader(CHKPNTDIR);
+  EXPECT_TRUE(loader.Load(txn_id - 1, &storage));
+  TPCC().InitializeItems();
+  TPCC client;
+  client.RestoreOrderNumbers(&storage, &config);
+  RunNewOrders(client, &storage, &config, &txn_id, 100);
+  RemoveCheckpoint(txn_id - 101);
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  CheckpointLoaderTest();
+  CorruptCheckpointTest();
+  TpccRestoreTest();
+}
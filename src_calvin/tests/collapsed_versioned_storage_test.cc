@@ -2,6 +2,9 @@
 
 #include "backend/collapsed_versioned_storage.h"
 
+#include <unistd.h>
+
+#include "backend/checkpoint.h"
 #include "common/testing.h"
 
 TEST(CollapsedVersionedStorageTest) {
@@ -12,11 +15,11 @@ TEST(CollapsedVersionedStorageTest) {
   Value value_two = bytes("value_two");
   Value* result = storage->ReadObject(key);
 
-  EXPECT_TRUE(storage->PutObject(key, &value_one, 10));
+  EXPECT_TRUE(storage->PutObject(key, new Value(value_one), 10));
   storage->PrepareForCheckpoint(15);
-  EXPECT_TRUE(storage->PutObject(key, &value_two, 12));
-  EXPECT_TRUE(storage->PutObject(key, &value_two, 20));
-  EXPECT_TRUE(storage->PutObject(key, &value_one, 30));
+  EXPECT_TRUE(storage->PutObject(key, new Value(value_two), 12));
+  EXPECT_TRUE(storage->PutObject(key, new Value(value_two), 20));
+  EXPECT_TRUE(storage->PutObject(key, new Value(value_one), 30));
 
   EXPECT_EQ(0, storage->ReadObject(key, 10));
   result = storage->ReadObject(key, 12);
@@ -49,19 +52,34 @@ TEST(CheckpointingTest) {
   Value value_two = bytes("value_two");
   Value* result;
 
-  EXPECT_TRUE(storage->PutObject(key, &value_one, 10));
+  EXPECT_TRUE(storage->PutObject(key, new Value(value_one), 10));
   storage->PrepareForCheckpoint(15);
-  EXPECT_TRUE(storage->PutObject(key, &value_two, 20));
+  EXPECT_TRUE(storage->PutObject(key, new Value(value_two), 20));
   storage->Checkpoint();
 
   sleep(5);
 
-  char checkpoint_path[100];
-  snprintf(checkpoint_path, sizeof(checkpoint_path), "%s/15.checkpoint",
-           CHKPNTDIR);
-  FILE* checkpoint = fopen(checkpoint_path, "r");
-  EXPECT_TRUE(checkpoint != NULL);
-  fclose(checkpoint);
+  // Each checkpoint thread writes one part; together they hold the one
+  // object as of txn 15.
+  int64 records = 0;
+  for (int part = 0; part < CHECKPOINT_THREADS; part++) {
+    FILE* checkpoint =
+        fopen(CheckpointPath(CHKPNTDIR, 15, part).c_str(), "r");
+    EXPECT_TRUE(checkpoint != NULL);
+    if (checkpoint == NULL)
+      continue;
+    CheckpointHeader header;
+    CheckpointTrailer trailer;
+    EXPECT_EQ(1, fread(&header, sizeof(header), 1, checkpoint));
+    EXPECT_EQ(15, header.stable);
+    EXPECT_EQ(static_cast<uint32>(part), header.part);
+    fseek(checkpoint, -static_cast<long>(sizeof(trailer)), SEEK_END);
+    EXPECT_EQ(1, fread(&trailer, sizeof(trailer), 1, checkpoint));
+    EXPECT_EQ(CHECKPOINT_END_OF_RECORDS, trailer.end_of_records);
+    records += trailer.records;
+    fclose(checkpoint);
+  }
+  EXPECT_EQ(1, records);
 
   EXPECT_EQ(0, storage->ReadObject(key, 10));
   result = storage->ReadObject(key);
@@ -72,7 +90,52 @@ TEST(CheckpointingTest) {
   END;
 }
 
+TEST(CopyOnReadTest) {
+  CollapsedVersionedStorage* storage = new CollapsedVersionedStorage();
+
+  Key key = bytes("key");
+  Value* value = new Value("value_one");
+  EXPECT_TRUE(storage->PutObject(key, value, 10));
+  storage->PrepareForCheckpoint(15);
+  EXPECT_TRUE(storage->Checkpointing());
+
+  // Txn 20 updates the object in place, as applications do.
+  Value* result = storage->ReadObject(key, 20);
+  EXPECT_TRUE(result != value);
+  result->assign("value_two");
+
+  EXPECT_EQ(Value("value_one"), *storage->ReadObject(key, 15));
+  EXPECT_EQ(Value("value_two"), *storage->ReadObject(key, 25));
+
+  delete storage;
+
+  END;
+}
+
+TEST(DeleteDuringCheckpointTest) {
+  CollapsedVersionedStorage* storage = new CollapsedVersionedStorage();
+
+  Key key = bytes("key");
+  EXPECT_TRUE(storage->PutObject(key, new Value("value_one"), 10));
+  storage->PrepareForCheckpoint(15);
+
+  // The checkpoint still sees the object deleted after its stable txn.
+  EXPECT_TRUE(storage->DeleteObject(key, 20));
+  EXPECT_EQ(Value("value_one"), *storage->ReadObject(key, 15));
+  EXPECT_EQ(0, storage->ReadObject(key, 25));
+
+  vector<Key> keys;
+  EXPECT_TRUE(storage->ListKeys(&keys));
+  EXPECT_EQ(0, keys.size());
+
+  delete storage;
+
+  END;
+}
+
 int main(int argc, char** argv) {
   CollapsedVersionedStorageTest();
   CheckpointingTest();
+  CopyOnReadTest();
+  DeleteDuringCheckpointTest();
 }
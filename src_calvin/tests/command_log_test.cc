@@ -0,0 +1,114 @@
+#include "sequencer/command_log.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include "common/testing.h"
+
+const char kLogPath[] = "command_log_test.log";
+
+TEST(CommandLogTest) {
+  unlink(kLogPath);
+  {
+    CommandLog log(kLogPath, CommandLog::FSYNC, false);
+    log.Append(0, "first");
+    log.Append(2, "");
+    log.Commit();
+    log.Append(4, "third");
+  }  // The destructor commits the last record.
+
+  int64 batch_number;
+  string batch;
+  {
+    CommandLog log(kLogPath, CommandLog::BUFFERED, true);
+    EXPECT_TRUE(log.Replay(&batch_number, &batch));
+    EXPECT_EQ(0, batch_number);
+    EXPECT_EQ(string("first"), batch);
+    EXPECT_TRUE(log.Replay(&batch_number, &batch));
+    EXPECT_EQ(2, batch_number);
+    EXPECT_EQ(string(""), batch);
+    EXPECT_TRUE(log.Replay(&batch_number, &batch));
+    EXPECT_EQ(4, batch_number);
+    EXPECT_EQ(string("third"), batch);
+    EXPECT_FALSE(log.Replay(&batch_number, &batch));
+  }
+
+  // Reopening without recovery starts an empty log.
+  {
+    CommandLog log(kLogPath, CommandLog::BUFFERED, false);
+    EXPECT_FALSE(log.Replay(&batch_number, &batch));
+  }
+
+  unlink(kLogPath);
+  END;
+}
+
+TEST(CommandLogTornTailTest) {
+  unlink(kLogPath);
+  {
+    CommandLog log(kLogPath, CommandLog::BUFFERED, false);
+    log.Append(0, "complete");
+    log.Append(2, "torn");
+  }
+  // Cut the last record short, as a crash in the middle of a write would.
+  FILE* file = fopen(kLogPath, "r+");
+  fseek(file, 0, SEEK_END);
+  EXPECT_EQ(0, ftruncate(fileno(file), ftell(file) - 2));
+  fclose(file);
+
+  int64 batch_number;
+  string batch;
+  {
+    CommandLog log(kLogPath, CommandLog::BUFFERED, true);
+    EXPECT_TRUE(log.Replay(&batch_number, &batch));
+    EXPECT_EQ(string("complete"), batch);
+    EXPECT_FALSE(log.Replay(&batch_number, &batch));
+    log.Append(2, "retried");
+  }
+  {
+    CommandLog log(kLogPath, CommandLog::BUFFERED, true);
+    EXPECT_TRUE(log.Replay(&batch_number, &batch));
+    EXPECT_TRUE(log.Replay(&batch_number, &batch));
+    EXPECT_EQ(2, batch_number);
+    EXPECT_EQ(string("retried"), batch);
+    EXPECT_FALSE(log.Replay(&batch_number, &batch));
+  }
+
+  unlink(kLogPath);
+  END;
+}
+
+TEST(CommandLogGarbageHeaderTest) {
+  unlink(kLogPath);
+  {
+    CommandLog log(kLogPath, CommandLog::BUFFERED, false);
+    log.Append(0, "complete");
+  }
+  // A header torn out of its record can claim a length far past the end of
+  // the file.
+  FILE* file = fopen(kLogPath, "a");
+  char header[16];
+  memset(header, 0xff, sizeof(header));
+  EXPECT_EQ(1, fwrite(header, sizeof(header), 1, file));
+  fclose(file);
+
+  int64 batch_number;
+  string batch;
+  {
+    CommandLog log(kLogPath, CommandLog::BUFFERED, true);
+    EXPECT_TRUE(log.Replay(&batch_number, &batch));
+    EXPECT_EQ(string("complete"), batch);
+    EXPECT_FALSE(log.Replay(&batch_number, &batch));
+  }
+
+  unlink(kLogPath);
+  END;
+}
+
+int main(int argc, char** argv) {
+  CommandLogTest();
+  CommandLogTornTailTest();
+  CommandLogGarbageHeaderTest();
+}
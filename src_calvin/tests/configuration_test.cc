@@ -19,14 +19,59 @@ TEST(ConfigurationTest_ReadFromFile) {
   END;
 }
 
-// TODO(alex): Write proper test once partitioning is implemented.
 TEST(ConfigurationTest_LookupPartition) {
   Configuration config(1, "common/configuration_test.conf");
   EXPECT_EQ(0, config.LookupPartition(Key("0")));
+  EXPECT_EQ(1, config.LookupPartition(Key("7")));
+  EXPECT_EQ(1, config.LookupPartition(Key("w3d1c4")));
+  END;
+}
+
+// common/configuration_test_partition.conf:
+//  node0..node2
+//  partition.w=range:0-3@2
+//  partition.default=hash
+TEST(ConfigurationTest_PartitionSchemes) {
+  Configuration config(0, "common/configuration_test_partition.conf");
+  EXPECT_EQ(2, config.LookupPartition(Key("w0")));
+  EXPECT_EQ(2, config.LookupPartition(Key("w3d1c4")));
+  EXPECT_EQ(1, config.LookupPartition(Key("w4d1")));
+  EXPECT_EQ(1, config.LookupPartition(Key("4")));
+  EXPECT_EQ(0, config.LookupPartition(Key("42")));
+
+  // The schemes survive a round trip through WriteToFile.
+  EXPECT_TRUE(config.WriteToFile("/tmp/configuration_test_partition.conf"));
+  Configuration copy(0, "/tmp/configuration_test_partition.conf");
+  EXPECT_EQ(2, copy.LookupPartition(Key("w1")));
+  EXPECT_EQ(0, copy.LookupPartition(Key("42")));
+  END;
+}
+
+TEST(ConfigurationTest_Migration) {
+  Configuration config(0, "common/configuration_test_partition.conf");
+  config.AddMigration(100, 'w', 0, 1, 0);
+  config.AddMigration(100, '\0', 42, 42, 1);
+
+  // Sequencers routing batch 100 and later see the move right away ...
+  EXPECT_EQ(2, config.PartitionMapAt(99)->Lookup("w1"));
+  EXPECT_EQ(0, config.PartitionMapAt(100)->Lookup("w1"));
+  EXPECT_EQ(1, config.PartitionMapAt(250)->Lookup("42"));
+  EXPECT_EQ(2, config.PartitionMapAt(250)->Lookup("w2"));
+
+  // ... while the scheduler only switches once it installs batch 100.
+  EXPECT_TRUE(config.PendingPartitionMap(99) == NULL);
+  EXPECT_TRUE(config.PendingPartitionMap(100) != NULL);
+  EXPECT_EQ(2, config.LookupPartition("w1"));
+  config.InstallPartitionMap(100);
+  EXPECT_EQ(0, config.LookupPartition("w1"));
+  EXPECT_EQ(1, config.LookupPartition("42"));
+  EXPECT_TRUE(config.PendingPartitionMap(100) == NULL);
   END;
 }
 
 int main(int argc, char** argv) {
   ConfigurationTest_ReadFromFile();
   ConfigurationTest_LookupPartition();
+  ConfigurationTest_PartitionSchemes();
+  ConfigurationTest_Migration();
 }
@@ -0,0 +1,70 @@
+#include "scheduler/conflict_bitmap.h"
+
+#include <cstdlib>
+#include <set>
+
+#include "common/definitions.hh"
+#include "common/testing.h"
+
+using std::set;
+
+TEST(ConflictBitmapTest) {
+  ConflictBitmap bitmap(LOCK_TABLE_SIZE);
+  set<int> reference;
+  srand(0);
+
+  for (int pass = 0; pass < 3; pass++) {
+    for (int txn = 0; txn < 1000; txn++) {
+      // Probe with lengths that leave a scalar tail after the vector loop.
+      int slots[21];
+      int count = rand() % 21;
+      bool expected = false;
+      for (int i = 0; i < count; i++) {
+        slots[i] = rand() % LOCK_TABLE_SIZE;
+        if (reference.count(slots[i]))
+          expected = true;
+      }
+      EXPECT_EQ(expected, bitmap.AnySet(slots, count));
+
+      bitmap.Set(slots, count / 2);
+      reference.insert(slots, slots + count / 2);
+      if (count > 0)
+        EXPECT_TRUE(count == 1 || bitmap.AnySet(slots, count));
+    }
+
+    bitmap.Clear();
+    for (set<int>::iterator it = reference.begin(); it != reference.end();
+         ++it)
+      EXPECT_FALSE(bitmap.AnySet(&*it, 1));
+    reference.clear();
+  }
+
+  int last = LOCK_TABLE_SIZE - 1;
+  bitmap.Set(&last, 1);
+  EXPECT_TRUE(bitmap.AnySet(&last, 1));
+
+  END;
+}
+
+TEST(AnyLockedTest) {
+  vector<int> counts(LOCK_TABLE_SIZE, 0);
+  int slots[19];
+  for (int i = 0; i < 19; i++)
+    slots[i] = i * 50000;
+  EXPECT_FALSE(AnyLocked(counts.data(), slots, 19));
+
+  // Each slot is found, whether the vector loop or the scalar tail tests it.
+  for (int i = 0; i < 19; i++) {
+    counts[slots[i]] = 1;
+    EXPECT_TRUE(AnyLocked(counts.data(), slots, 19));
+    EXPECT_FALSE(AnyLocked(counts.data(), slots, i));
+    counts[slots[i]] = 0;
+  }
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  ConflictBitmapTest();
+  AnyLockedTest();
+}
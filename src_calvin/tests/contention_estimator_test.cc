@@ -0,0 +1,37 @@
+#include "scheduler/contention_estimator.h"
+
+#include "common/testing.h"
+
+TEST(ContentionEstimatorTest) {
+  ContentionEstimator contention(100);
+  EXPECT_EQ(1, contention.threshold());
+  EXPECT_FALSE(contention.Record(0, 0));
+  EXPECT_FALSE(contention.Record(0, 1));
+
+  // A key whose requests keep waiting behind long queues becomes contended.
+  bool contended = false;
+  for (int i = 0; i < 10; i++)
+    contended = contention.Record(1, 20);
+  EXPECT_TRUE(contended);
+
+  // Once it is no longer requested, a few windows of requests elsewhere cool
+  // it down.
+  for (int i = 0; i < 5 * CONTENTION_WINDOW; i++)
+    contention.Record(2, 0);
+  EXPECT_FALSE(contention.Record(1, 0));
+
+  // The threshold follows the queue lengths of the previous window.
+  for (int i = 0; i < CONTENTION_WINDOW; i++)
+    contention.Record(3 + i % 50, i % 2 == 0 ? 0 : 10);
+  EXPECT_EQ(10, contention.threshold());
+  EXPECT_FALSE(contention.Record(3, 10));
+  for (int i = 0; i < 10; i++)
+    contended = contention.Record(4, 30);
+  EXPECT_TRUE(contended);
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  ContentionEstimatorTest();
+}
@@ -2,32 +2,90 @@
 
 #include "backend/fetching_storage.h"
 
+#include <unistd.h>
+
 #include <iostream>
 #include <sstream>
 
 #include "common/testing.h"
 
 TEST(FetchingStorageTest) {
-  system("rm ../db/storage/*");
   FetchingStorage* storage = FetchingStorage::BuildStorage();
   Key key = bytes("1");
-  Value value = bytes("value");
+  Value* value = new Value("value");
   Value* result;
   double wait_time;
   EXPECT_FALSE(storage->Prefetch(key, &wait_time));
-  EXPECT_TRUE(storage->PutObject(key, &value));
+  EXPECT_TRUE(storage->PutObject(key, value));
   result = storage->ReadObject(key);
-  EXPECT_EQ(value, *result);
+  EXPECT_EQ(string("value"), *result);
   EXPECT_TRUE(storage->Unfetch(key));
-  sleep(1);
   EXPECT_TRUE(storage->Prefetch(key, &wait_time));
-  sleep(1);
+  EXPECT_EQ(0, wait_time);
   result = storage->ReadObject(key);
-  EXPECT_EQ(value, *result);
+  EXPECT_EQ(string("value"), *result);
   EXPECT_TRUE(storage->Unfetch(key));
   END;
 }
 
+// With fewer frames than objects, pages are written back on eviction and
+// read back on the next prefetch.
+void CheckEviction(const string& page_io) {
+  string path = string(STORAGE_PATH) + "eviction_test";
+  FetchingStorage storage(path, 4, page_io);
+  for (int i = 0; i < 64; i++)
+    EXPECT_TRUE(storage.PutObject(IntToString(i), new Value(IntToString(i))));
+
+  for (int i = 0; i < 64; i++) {
+    double wait_time;
+    EXPECT_TRUE(storage.Prefetch(IntToString(i), &wait_time));
+    if (wait_time == 0)
+      EXPECT_EQ(0, storage.FetchWait(IntToString(i)));
+    storage.SubmitPrefetches();
+    Value* result = storage.ReadObject(IntToString(i));
+    EXPECT_EQ(IntToString(i), *result);
+    EXPECT_EQ(0, storage.FetchWait(IntToString(i)));
+    result->append("x");
+    EXPECT_TRUE(storage.Unfetch(IntToString(i)));
+  }
+
+  // Updates made in place while pinned survive eviction.
+  for (int i = 0; i < 64; i++)
+    EXPECT_EQ(IntToString(i) + "x", *storage.ReadObject(IntToString(i)));
+
+  EXPECT_TRUE(storage.DeleteObject("7"));
+  EXPECT_TRUE(storage.ReadObject("7") == NULL);
+  string stats = storage.ReportStats();
+  EXPECT_TRUE(stats.find("hit rate") != string::npos);
+  EXPECT_TRUE(stats.find("(" + page_io + ")") != string::npos);
+  unlink(path.c_str());
+}
+
+TEST(EvictionTest) {
+  CheckEviction("aio");
+  CheckEviction("uring");
+  END;
+}
+
+// Keys that are not numbers, like TPC-C's, get pages of their own.
+TEST(NamedKeysTest) {
+  string path = string(STORAGE_PATH) + "named_keys_test";
+  FetchingStorage storage(path, 4, "aio");
+  for (int i = 0; i < 16; i++) {
+    string key = "w0d" + IntToString(i);
+    EXPECT_TRUE(storage.PutObject(key, new Value(key)));
+  }
+  for (int i = 0; i < 16; i++) {
+    string key = "w0d" + IntToString(i);
+    EXPECT_EQ(key, *storage.ReadObject(key));
+  }
+  EXPECT_TRUE(storage.ReadObject("w1") == NULL);
+  unlink(path.c_str());
+  END;
+}
+
 int main(int argc, char** argv) {
   FetchingStorageTest();
+  EvictionTest();
+  NamedKeysTest();
 }
@@ -0,0 +1,74 @@
+#include "scheduler/lock_slots.h"
+
+#include "common/testing.h"
+#include "common/utils.h"
+
+// Returns two keys whose hashes fall into the same lock table slot.
+void FindCollision(Key* first, Key* second) {
+  unordered_map<int, Key> seen;
+  for (int i = 0; second->empty(); i++) {
+    Key key = "k" + IntToString(i);
+    int slot = FnvHash(key) % LOCK_TABLE_SIZE;
+    if (seen.count(slot)) {
+      *first = seen[slot];
+      *second = key;
+    }
+    seen[slot] = key;
+  }
+}
+
+TEST(HashedLockSlotsTest) {
+  LockSlots slots(LockSlots::HASHED, DB_SIZE);
+  EXPECT_EQ(LOCK_TABLE_SIZE, slots.size());
+  EXPECT_EQ(static_cast<int>(FnvHash("w1d2c3") % LOCK_TABLE_SIZE),
+            slots.Acquire("w1d2c3"));
+
+  Key first, second;
+  FindCollision(&first, &second);
+  EXPECT_EQ(slots.Acquire(first), slots.Acquire(second));
+
+  END;
+}
+
+TEST(ExactLockSlotsTest) {
+  LockSlots slots(LockSlots::EXACT, 1000);
+  EXPECT_EQ(1000 + LOCK_TABLE_SIZE, slots.size());
+
+  // Plain ids are their own slots.
+  EXPECT_EQ(0, slots.Acquire("0"));
+  EXPECT_EQ(999, slots.Acquire("999"));
+  EXPECT_EQ(0, slots.assigned());
+
+  // Everything else gets a slot of its own above them, where its hash points.
+  int big = slots.Acquire("1000");
+  int padded = slots.Acquire("0999");
+  EXPECT_EQ(1000 + static_cast<int>(FnvHash("1000") % LOCK_TABLE_SIZE), big);
+  EXPECT_TRUE(padded >= 1000 && padded != big);
+  EXPECT_EQ(big, slots.Acquire("1000"));
+  EXPECT_EQ(2, slots.assigned());
+  slots.Release(999);
+  slots.Release(big);
+  slots.Release(padded);
+  EXPECT_EQ(0, slots.assigned());
+
+  // Keys whose hashes collide take consecutive slots.
+  Key first, second;
+  FindCollision(&first, &second);
+  int home = slots.Acquire(first);
+  EXPECT_EQ(home + 1, slots.Acquire(second));
+
+  // The second key is still found past the first one's released slot, which
+  // is reused once nothing lies behind it.
+  slots.Release(home);
+  EXPECT_EQ(home + 1, slots.Acquire(second));
+  slots.Release(home + 1);
+  EXPECT_EQ(home, slots.Acquire(second));
+  EXPECT_EQ(1, slots.assigned());
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  HashedLockSlotsTest();
+  ExactLockSlotsTest();
+}
@@ -0,0 +1,105 @@
+#include "common/partitioner.h"
+
+#include "common/testing.h"
+
+TEST(HashPartitionerTest) {
+  Partitioner* partitioner = Partitioner::Create("hash", 3);
+  EXPECT_TRUE(partitioner != NULL);
+  EXPECT_EQ(0, partitioner->Lookup(0));
+  EXPECT_EQ(2, partitioner->Lookup(5));
+  EXPECT_EQ(string("hash"), partitioner->ToString());
+  delete partitioner;
+  END;
+}
+
+TEST(RangePartitionerTest) {
+  // Ranges 0-9 and 20-29 are co-located on node 1.
+  Partitioner* partitioner =
+      Partitioner::Create("range:20-29@1,0-9@1,10-19@0", 2);
+  EXPECT_TRUE(partitioner != NULL);
+  EXPECT_EQ(1, partitioner->Lookup(0));
+  EXPECT_EQ(1, partitioner->Lookup(9));
+  EXPECT_EQ(0, partitioner->Lookup(10));
+  EXPECT_EQ(1, partitioner->Lookup(25));
+  EXPECT_EQ(0, partitioner->Lookup(30));  // Not covered: hashed.
+  EXPECT_EQ(1, partitioner->Lookup(31));
+  EXPECT_EQ(string("range:0-9@1,10-19@0,20-29@1"), partitioner->ToString());
+  delete partitioner;
+
+  EXPECT_TRUE(Partitioner::Create("range:0-9@0,5-14@1", 2) == NULL);
+  EXPECT_TRUE(Partitioner::Create("range:0-9@2", 2) == NULL);
+  EXPECT_TRUE(Partitioner::Create("range:9-0@0", 2) == NULL);
+  EXPECT_TRUE(Partitioner::Create("range:0@0", 2) == NULL);
+  END;
+}
+
+TEST(LookupTablePartitionerTest) {
+  Partitioner* partitioner = Partitioner::Create("lookup:4@0,7@2", 3);
+  EXPECT_TRUE(partitioner != NULL);
+  EXPECT_EQ(0, partitioner->Lookup(4));
+  EXPECT_EQ(2, partitioner->Lookup(7));
+  EXPECT_EQ(2, partitioner->Lookup(5));  // Not listed: hashed.
+  EXPECT_EQ(1, partitioner->Lookup(100));
+  EXPECT_EQ(string("lookup:4@0,7@2"), partitioner->ToString());
+  delete partitioner;
+
+  EXPECT_TRUE(Partitioner::Create("lookup:4@0,", 3) != NULL);
+  EXPECT_TRUE(Partitioner::Create("lookup:4", 3) == NULL);
+  EXPECT_TRUE(Partitioner::Create("lookup:x@1", 3) == NULL);
+  EXPECT_TRUE(Partitioner::Create("modulo", 3) == NULL);
+  END;
+}
+
+TEST(PartitionMapTest) {
+  HashPartitioner hash(2);
+  RangePartitioner warehouses(2);
+  EXPECT_TRUE(warehouses.AddRange(0, 9, 1));
+  PartitionMap partition_map(&hash);
+  partition_map.set_partitioner('w', &warehouses);
+
+  EXPECT_EQ(1, partition_map.Lookup("w3d1c4"));
+  EXPECT_EQ(0, partition_map.Lookup("w10"));
+  EXPECT_EQ(0, partition_map.Lookup("42"));
+  EXPECT_EQ(1, partition_map.Lookup("i7"));  // Unconfigured table: hashed.
+  EXPECT_EQ(0, partition_map.Lookup(""));
+
+  // Moving warehouses 2-3 leaves the rest of the table where it was.
+  MigratedPartitioner moved(&warehouses, 2, 3, 0);
+  PartitionMap next(partition_map);
+  next.set_partitioner('w', &moved);
+  EXPECT_EQ(0, next.Lookup("w3d1c4"));
+  EXPECT_EQ(1, next.Lookup("w4"));
+  EXPECT_EQ(1, partition_map.Lookup("w3d1c4"));
+  END;
+}
+
+TEST(MigrationSpecTest) {
+  char table;
+  int64 lo, hi;
+  int node;
+  EXPECT_TRUE(PartitionMap::ParseMigration("w:2-3@0", &table, &lo, &hi, &node));
+  EXPECT_EQ('w', table);
+  EXPECT_EQ(2, lo);
+  EXPECT_EQ(3, hi);
+  EXPECT_EQ(0, node);
+  EXPECT_TRUE(
+      PartitionMap::ParseMigration("default:17-17@1", &table, &lo, &hi, &node));
+  EXPECT_EQ('\0', table);
+  EXPECT_EQ(string("default:17-17@1"),
+            PartitionMap::FormatMigration(table, lo, hi, node));
+
+  EXPECT_FALSE(PartitionMap::ParseMigration("w:3-2@0", &table, &lo, &hi,
+                                            &node));
+  EXPECT_FALSE(PartitionMap::ParseMigration("1:0-2@0", &table, &lo, &hi,
+                                            &node));
+  EXPECT_FALSE(PartitionMap::ParseMigration("w:0-2", &table, &lo, &hi, &node));
+  END;
+}
+
+int main(int argc, char** argv) {
+  HashPartitionerTest();
+  RangePartitionerTest();
+  LookupTablePartitionerTest();
+  PartitionMapTest();
+  MigrationSpecTest();
+}
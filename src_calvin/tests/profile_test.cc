@@ -5,22 +5,26 @@
 #include "common/connection.h"
 #include "common/testing.h"
 #include "common/utils.h"
+#include "proto/tpcc_args.pb.h"
 
-int main(int argc, char** argv) {
-  Configuration* config =
-      new Configuration(0, "common/configuration_test_one_node.conf");
-  CollapsedVersionedStorage* storage = new CollapsedVersionedStorage();
-  TPCC* tpcc = new TPCC();
+// Id of the next txn to execute. Storage versions records by txn id, so ids
+// keep increasing across the txn types profiled.
+int64 next_txn_id = 0;
 
-  TPCC().InitializeStorage(storage, config);
-
-  for (int i = 0; i < 100000; i++) {
+// Executes 'count' txns of type 'txn_type' on one node and prints how many
+// it executed per second.
+void Profile(TPCC* tpcc, int txn_type, const char* name, int count,
+             Configuration* config, Storage* storage) {
+  double start = GetTime();
+  for (int i = 0; i < count; i++) {
     TPCCArgs args;
     args.set_system_time(GetTime());
     args.set_multipartition(false);
     string args_string;
     args.SerializeToString(&args_string);
-    TxnProto* txn = tpcc->NewTxn(0, TPCC::NEW_ORDER, args_string, config);
+    TxnProto* txn =
+        tpcc->NewTxn(next_txn_id++, txn_type, args_string, config);
+    tpcc->Reconnoiter(txn, storage, config);
     txn->add_readers(0);
     txn->add_writers(0);
 
@@ -31,6 +35,24 @@ int main(int argc, char** argv) {
     delete manager;
     delete txn;
   }
+  double elapsed = GetTime() - start;
+  printf("%s: %d txns in %.2f s (%.0f txns/sec)\n", name, count, elapsed,
+         count / elapsed);
+}
+
+int main(int argc, char** argv) {
+  Configuration* config =
+      new Configuration(0, "common/configuration_test_one_node.conf");
+  CollapsedVersionedStorage* storage = new CollapsedVersionedStorage();
+  TPCC* tpcc = new TPCC();
+
+  TPCC().InitializeStorage(storage, config);
+
+  Profile(tpcc, TPCC::NEW_ORDER, "NewOrder", 100000, config, storage);
+  Profile(tpcc, TPCC::PAYMENT, "Payment", 100000, config, storage);
+  Profile(tpcc, TPCC::ORDER_STATUS, "OrderStatus", 100000, config, storage);
+  Profile(tpcc, TPCC::DELIVERY, "Delivery", 10000, config, storage);
+  Profile(tpcc, TPCC::STOCK_LEVEL, "StockLevel", 10000, config, storage);
 
   delete tpcc;
   delete storage;
@@ -6,16 +6,25 @@
 
 TEST(SimpleStorageTest) {
   SimpleStorage storage;
+  storage.Initmutex();
   Key key = bytes("key");
   Value value = bytes("value");
   Value* result;
   EXPECT_EQ(0, storage.ReadObject(key));
-  EXPECT_TRUE(storage.PutObject(key, &value));
+  EXPECT_TRUE(storage.PutObject(key, new Value(value)));
   result = storage.ReadObject(key);
   EXPECT_EQ(value, *result);
 
+  Value copy;
+  EXPECT_TRUE(storage.CopyObject(key, &copy));
+  EXPECT_EQ(value, copy);
+  EXPECT_TRUE(storage.PutObject(key, new Value("replaced")));
+  EXPECT_EQ(value, copy);
+  EXPECT_EQ(Value("replaced"), *storage.ReadObject(key));
+
   EXPECT_TRUE(storage.DeleteObject(key));
   EXPECT_EQ(0, storage.ReadObject(key));
+  EXPECT_FALSE(storage.CopyObject(key, &copy));
 
   END;
 }
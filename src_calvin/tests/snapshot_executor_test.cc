@@ -0,0 +1,156 @@
+#include "scheduler/snapshot_executor.h"
+
+#include "applications/application.h"
+#include "backend/mvcc_storage.h"
+#include "backend/storage_manager.h"
+#include "common/configuration.h"
+#include "common/testing.h"
+#include "proto/txn.pb.h"
+
+// Reads two accounts that always add up to 100.
+class BalanceCheck : public Application {
+ public:
+  BalanceCheck() : checked(0), inconsistent(0) {}
+
+  virtual TxnProto* NewTxn(int64 txn_id, int txn_type, string args,
+                           Configuration* config) const {
+    return NULL;
+  }
+
+  virtual int Execute(TxnProto* txn, StorageManager* storage) const {
+    int balance = 0;
+    for (int i = 0; i < txn->read_set_size(); i++)
+      balance += StringToInt(*storage->ReadObject(txn->read_set(i)));
+    if (balance != 100)
+      __atomic_add_fetch(&inconsistent, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&checked, 1, __ATOMIC_RELAXED);
+    return SUCCESS;
+  }
+
+  virtual void InitializeStorage(Storage* storage, Configuration* conf) const {
+  }
+
+  mutable int checked;
+  mutable int inconsistent;
+};
+
+// Reads the object named by the index in read_set(0), predicted as
+// read_set(1), like a TPC-C order status reads its customer's latest order.
+class IndexLookup : public Application {
+ public:
+  IndexLookup() : redone(0), succeeded(0) {}
+
+  virtual TxnProto* NewTxn(int64 txn_id, int txn_type, string args,
+                           Configuration* config) const {
+    return NULL;
+  }
+
+  virtual int Execute(TxnProto* txn, StorageManager* storage) const {
+    Key target = *storage->ReadObject(txn->read_set(0));
+    if (target != txn->read_set(1)) {
+      txn->clear_dependent_keys();
+      txn->add_dependent_keys(target);
+      __atomic_add_fetch(&redone, 1, __ATOMIC_RELAXED);
+      return REDO;
+    }
+    found = *storage->ReadObject(target);
+    __atomic_add_fetch(&succeeded, 1, __ATOMIC_RELEASE);
+    return SUCCESS;
+  }
+
+  virtual void Repredict(TxnProto* txn) const {
+    txn->set_read_set(1, txn->dependent_keys(0));
+    txn->clear_dependent_keys();
+  }
+
+  virtual void InitializeStorage(Storage* storage, Configuration* conf) const {
+  }
+
+  mutable int redone;
+  mutable int succeeded;
+  mutable string found;
+};
+
+TEST(SnapshotExecutorTest) {
+  Configuration config(0, "common/configuration_test_one_node.conf");
+  MvccStorage storage;
+  storage.PutObject("1", new Value("100"), 0);
+  storage.PutObject("2", new Value("0"), 0);
+  storage.AdvanceWatermark(0);
+  BalanceCheck application;
+  SnapshotExecutor executor(&config, &storage, &application);
+
+  TxnProto* writer = new TxnProto();
+  writer->add_read_set("1");
+  writer->add_read_write_set("2");
+  EXPECT_FALSE(executor.Divert(writer));
+  delete writer;
+
+  // Reads of "3" wait until a txn creating it has completed.
+  TxnProto* reader = new TxnProto();
+  reader->add_read_set("1");
+  reader->add_read_set("2");
+  reader->add_read_set("3");
+  EXPECT_TRUE(executor.Divert(reader));
+
+  // Ordered txns keep moving money while the executor reads.
+  for (int txn = 1; txn <= 1000; txn++) {
+    Value* from = storage.ReadObject("1", txn);
+    Value* to = storage.ReadObject("2", txn);
+    from->assign(IntToString(StringToInt(*from) - 1));
+    to->assign(IntToString(StringToInt(*to) + 1));
+    if (txn == 500)
+      storage.PutObject("3", new Value("0"), txn);
+    storage.AdvanceWatermark(txn);
+
+    reader = new TxnProto();
+    reader->add_read_set("1");
+    reader->add_read_set("2");
+    EXPECT_TRUE(executor.Divert(reader));
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    if (__atomic_load_n(&application.checked, __ATOMIC_RELAXED) == 1001)
+      break;
+    Spin(0.01);
+  }
+  EXPECT_EQ(1001, application.checked);
+  EXPECT_EQ(0, application.inconsistent);
+  EXPECT_TRUE(executor.ReportStats().find("Snapshot reads") != string::npos);
+
+  END;
+}
+
+TEST(RepredictTest) {
+  Configuration config(0, "common/configuration_test_one_node.conf");
+  MvccStorage storage;
+  storage.PutObject("index", new Value("2"), 0);
+  storage.PutObject("1", new Value("old"), 0);
+  storage.PutObject("2", new Value("new"), 0);
+  storage.AdvanceWatermark(0);
+  IndexLookup application;
+  SnapshotExecutor executor(&config, &storage, &application);
+
+  // The prediction is stale: the txn is repredicted and runs, rather than
+  // counting as done without having read anything.
+  TxnProto* txn = new TxnProto();
+  txn->add_read_set("index");
+  txn->add_read_set("1");
+  EXPECT_TRUE(executor.Divert(txn));
+
+  for (int i = 0; i < 1000; i++) {
+    if (__atomic_load_n(&application.succeeded, __ATOMIC_ACQUIRE) == 1)
+      break;
+    Spin(0.01);
+  }
+  EXPECT_EQ(1, application.succeeded);
+  EXPECT_EQ(1, application.redone);
+  EXPECT_EQ(string("new"), application.found);
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  SnapshotExecutorTest();
+  RepredictTest();
+}
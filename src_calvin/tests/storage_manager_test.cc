@@ -134,8 +134,85 @@ TEST(TwoNodes) {
   END;
 }
 
+TEST(PooledManagers) {
+  Configuration config(0, "common/configuration_test_one_node.conf");
+  SimpleStorage storage;
+  storage.Initmutex();
+  storage.PutObject("0", new Value("a"));
+  storage.PutObject("1", new Value("b"));
+
+  TxnProto txn;
+  txn.set_txn_id(1);
+  txn.add_read_set("0");
+  txn.add_read_write_set("1");
+  txn.add_readers(0);
+  txn.add_writers(0);
+
+  StorageManagerPool pool(&config, NULL, &storage);
+  StorageManager* manager = pool.Get(&txn);
+  EXPECT_TRUE(manager->ReadyToExecute());
+  EXPECT_EQ("a", *manager->ReadObject(txn.read_set(0)));
+  EXPECT_EQ("b", *manager->ReadObject(txn.read_write_set(0)));
+  // Keys that are not stored in the txn itself are found by value.
+  EXPECT_EQ("b", *manager->ReadObject("1"));
+  EXPECT_TRUE(manager->ReadObject("2") == NULL);
+  pool.Release(manager);
+
+  // The pool hands the same manager back out, set up for the new txn.
+  TxnProto txn2;
+  txn2.set_txn_id(2);
+  txn2.add_read_write_set("0");
+  txn2.add_readers(0);
+  txn2.add_writers(0);
+  EXPECT_TRUE(pool.Get(&txn2) == manager);
+  EXPECT_TRUE(manager->ReadyToExecute());
+  EXPECT_EQ("a", *manager->ReadObject("0"));
+  pool.Release(manager);
+
+  END;
+}
+
+// Txns are executed where they write, and read-only txns by their readers.
+TEST(ExecutingNodes) {
+  Configuration config(0, "common/configuration_test_one_node.conf");
+  SimpleStorage storage;
+  storage.Initmutex();
+  storage.PutObject("0", new Value("a"));
+
+  TxnProto read_only;
+  read_only.set_txn_id(1);
+  read_only.add_read_set("0");
+  read_only.add_readers(0);
+  StorageManager manager(&config, NULL, &storage, &read_only);
+  EXPECT_FALSE(manager.writer);
+  EXPECT_TRUE(manager.Executes());
+  EXPECT_TRUE(manager.ReadyToExecute());
+  EXPECT_EQ("a", *manager.ReadObject("0"));
+
+  TxnProto written_elsewhere;
+  written_elsewhere.set_txn_id(2);
+  written_elsewhere.add_read_write_set("1");
+  written_elsewhere.add_writers(1);
+  manager.Reset();
+  manager.Setup(&written_elsewhere);
+  EXPECT_FALSE(manager.Executes());
+
+  TxnProto written_here;
+  written_here.set_txn_id(3);
+  written_here.add_read_write_set("0");
+  written_here.add_readers(0);
+  written_here.add_writers(0);
+  manager.Reset();
+  manager.Setup(&written_here);
+  EXPECT_TRUE(manager.Executes());
+
+  END;
+}
+
 int main(int argc, char** argv) {
   // TODO(alex): Fix these tests!
   //  SingleNode();
   //  TwoNodes();
+  PooledManagers();
+  ExecutingNodes();
 }
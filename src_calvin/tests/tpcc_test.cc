@@ -2,12 +2,14 @@
 
 #include "applications/tpcc.h"
 
+#include "applications/tpcc_records.h"
 #include "backend/simple_storage.h"
 #include "backend/storage_manager.h"
 #include "common/configuration.h"
 #include "common/connection.h"
 #include "common/testing.h"
 #include "common/utils.h"
+#include "proto/tpcc_args.pb.h"
 
 // We make these global variables to avoid weird pointer passing and code
 // redundancy
@@ -37,41 +39,43 @@ TEST(IdGenerationTest) {
 
 // Test for creation of a warehouse, ensure the attributes are correct
 TEST(WarehouseTest) {
-  Warehouse* warehouse = tpcc->CreateWarehouse("w1");
-
-  EXPECT_EQ(warehouse->id(), "w1");
-  EXPECT_TRUE(warehouse->has_name());
-  EXPECT_TRUE(warehouse->has_street_1());
-  EXPECT_TRUE(warehouse->has_street_2());
-  EXPECT_TRUE(warehouse->has_city());
-  EXPECT_TRUE(warehouse->has_state());
-  EXPECT_TRUE(warehouse->has_zip());
-  EXPECT_EQ(warehouse->tax(), 0.05);
-  EXPECT_EQ(warehouse->year_to_date(), 0.0);
+  Value* warehouse_value = tpcc->CreateWarehouse("w1");
+  Warehouse* warehouse = RecordIn<Warehouse>(warehouse_value);
+
+  EXPECT_EQ(string(warehouse->id), "w1");
+  EXPECT_TRUE(warehouse->name[0] != '\0');
+  EXPECT_TRUE(warehouse->street_1[0] != '\0');
+  EXPECT_TRUE(warehouse->street_2[0] != '\0');
+  EXPECT_TRUE(warehouse->city[0] != '\0');
+  EXPECT_TRUE(warehouse->state[0] != '\0');
+  EXPECT_TRUE(warehouse->zip[0] != '\0');
+  EXPECT_EQ(warehouse->tax, 0.05);
+  EXPECT_EQ(warehouse->year_to_date, 0.0);
 
   // Finish
-  delete warehouse;
+  delete warehouse_value;
   END
 }
 
 // Test for creation of a district, ensure the attributes are correct
 TEST(DistrictTest) {
-  District* district = tpcc->CreateDistrict("d1", "w1");
-
-  EXPECT_EQ(district->id(), "d1");
-  EXPECT_EQ(district->warehouse_id(), "w1");
-  EXPECT_TRUE(district->has_name());
-  EXPECT_TRUE(district->has_street_1());
-  EXPECT_TRUE(district->has_street_2());
-  EXPECT_TRUE(district->has_city());
-  EXPECT_TRUE(district->has_state());
-  EXPECT_TRUE(district->has_zip());
-  EXPECT_EQ(district->tax(), 0.05);
-  EXPECT_EQ(district->year_to_date(), 0.0);
-  EXPECT_EQ(district->next_order_id(), 1);
+  Value* district_value = tpcc->CreateDistrict("d1", "w1");
+  District* district = RecordIn<District>(district_value);
+
+  EXPECT_EQ(string(district->id), "d1");
+  EXPECT_EQ(string(district->warehouse_id), "w1");
+  EXPECT_TRUE(district->name[0] != '\0');
+  EXPECT_TRUE(district->street_1[0] != '\0');
+  EXPECT_TRUE(district->street_2[0] != '\0');
+  EXPECT_TRUE(district->city[0] != '\0');
+  EXPECT_TRUE(district->state[0] != '\0');
+  EXPECT_TRUE(district->zip[0] != '\0');
+  EXPECT_EQ(district->tax, 0.05);
+  EXPECT_EQ(district->year_to_date, 0.0);
+  EXPECT_EQ(district->next_order_id, 1);
 
   // Finish
-  delete district;
+  delete district_value;
   END
 }
 
@@ -80,64 +84,67 @@ TEST(CustomerTest) {
   // Create a transaction so the customer creation can do secondary insertion
   TxnProto* secondary_keying = new TxnProto();
   secondary_keying->set_txn_id(1);
-  Customer* customer = tpcc->CreateCustomer("c1", "d1", "w1");
-
-  EXPECT_EQ(strcmp(customer->id().c_str(), "c1"), 0);
-  EXPECT_EQ(strcmp(customer->district_id().c_str(), "d1"), 0);
-  EXPECT_EQ(strcmp(customer->warehouse_id().c_str(), "w1"), 0);
-  EXPECT_TRUE(customer->has_first());
-  EXPECT_TRUE(customer->has_middle());
-  EXPECT_TRUE(customer->has_last());
-  EXPECT_TRUE(customer->has_street_1());
-  EXPECT_TRUE(customer->has_street_2());
-  EXPECT_TRUE(customer->has_city());
-  EXPECT_TRUE(customer->has_state());
-  EXPECT_TRUE(customer->has_zip());
-  EXPECT_TRUE(customer->has_data());
-  EXPECT_EQ(customer->since(), 0);
-  EXPECT_EQ(customer->credit(), "GC");
-  EXPECT_EQ(customer->credit_limit(), 0.01);
-  EXPECT_EQ(customer->discount(), 0.5);
-  EXPECT_EQ(customer->balance(), 0);
-  EXPECT_EQ(customer->year_to_date_payment(), 0);
-  EXPECT_EQ(customer->payment_count(), 0);
-  EXPECT_EQ(customer->delivery_count(), 0);
+  Value* customer_value = tpcc->CreateCustomer("c1", "d1", "w1");
+  Customer* customer = RecordIn<Customer>(customer_value);
+
+  EXPECT_EQ(strcmp(customer->id, "c1"), 0);
+  EXPECT_EQ(strcmp(customer->district_id, "d1"), 0);
+  EXPECT_EQ(strcmp(customer->warehouse_id, "w1"), 0);
+  EXPECT_TRUE(customer->first[0] != '\0');
+  EXPECT_TRUE(customer->middle[0] != '\0');
+  EXPECT_TRUE(customer->last[0] != '\0');
+  EXPECT_TRUE(customer->street_1[0] != '\0');
+  EXPECT_TRUE(customer->street_2[0] != '\0');
+  EXPECT_TRUE(customer->city[0] != '\0');
+  EXPECT_TRUE(customer->state[0] != '\0');
+  EXPECT_TRUE(customer->zip[0] != '\0');
+  EXPECT_TRUE(customer->data[0] != '\0');
+  EXPECT_EQ(customer->since, 0);
+  EXPECT_EQ(string(customer->credit), "GC");
+  EXPECT_EQ(customer->credit_limit, 0.01);
+  EXPECT_EQ(customer->discount, 0.5);
+  EXPECT_EQ(customer->balance, 0);
+  EXPECT_EQ(customer->year_to_date_payment, 0);
+  EXPECT_EQ(customer->payment_count, 0);
+  EXPECT_EQ(customer->delivery_count, 0);
 
   // Finish
   delete secondary_keying;
-  delete customer;
+  delete customer_value;
   END
 }
 
 // Test for creation of an item, ensure the attributes are correct
 TEST(ItemTest) {
-  Item* item = tpcc->CreateItem("i1");
+  Value* item_value = tpcc->CreateItem("i1");
+  Item* item = RecordIn<Item>(item_value);
 
-  EXPECT_EQ(item->id(), "i1");
-  EXPECT_TRUE(item->has_name());
-  EXPECT_TRUE(item->has_price());
-  EXPECT_TRUE(item->has_data());
+  EXPECT_EQ(string(item->id), "i1");
+  EXPECT_TRUE(item->name[0] != '\0');
+  EXPECT_TRUE(item->price >= 0);
+  EXPECT_TRUE(item->data[0] != '\0');
 
   // Finish
-  delete item;
+  delete item_value;
   END
 }
 
 // Test for creation of a stock, ensure the attributes are correct
 TEST(StockTest) {
-  Stock* stock = tpcc->CreateStock("i1", "w1");
-
-  EXPECT_EQ(stock->id(), "w1si1");
-  EXPECT_EQ(stock->warehouse_id(), "w1");
-  EXPECT_EQ(stock->item_id(), "i1");
-  EXPECT_TRUE(stock->has_quantity());
-  EXPECT_TRUE(stock->has_data());
-  EXPECT_EQ(stock->year_to_date(), 0);
-  EXPECT_EQ(stock->order_count(), 0);
-  EXPECT_EQ(stock->remote_count(), 0);
+  Value* stock_value = tpcc->CreateStock("i1", "w1");
+  Stock* stock = RecordIn<Stock>(stock_value);
+
+  EXPECT_EQ(string(stock->id), "w1si1");
+  EXPECT_EQ(string(stock->warehouse_id), "w1");
+  EXPECT_EQ(string(stock->item_id), "i1");
+  EXPECT_TRUE(stock->quantity > 0);
+  EXPECT_TRUE(stock->data[0] != '\0');
+  EXPECT_EQ(stock->year_to_date, 0);
+  EXPECT_EQ(stock->order_count, 0);
+  EXPECT_EQ(stock->remote_count, 0);
 
   // Finish
-  delete stock;
+  delete stock_value;
   END
 }
 
@@ -169,10 +176,10 @@ TEST(NewTxnTest) {
   EXPECT_EQ(txn->status(), TxnProto::NEW);
 
   EXPECT_TRUE(tpcc_args->ParseFromString(txn->arg()));
-  EXPECT_TRUE(tpcc_args->order_line_count() >= 5 &&
-              tpcc_args->order_line_count() <= 15);
-  EXPECT_TRUE(txn->write_set_size() == tpcc_args->order_line_count() + 2);
-  for (int i = 0; i < tpcc_args->order_line_count(); i++)
+  EXPECT_TRUE(tpcc_args->order_line_count(0) >= 5 &&
+              tpcc_args->order_line_count(0) <= 15);
+  EXPECT_TRUE(txn->write_set_size() == tpcc_args->order_line_count(0) + 3);
+  for (int i = 0; i < tpcc_args->order_line_count(0); i++)
     EXPECT_TRUE(tpcc_args->quantities(i) <= 10 && tpcc_args->quantities(i) > 0);
 
   // Payment Transaction Generation
@@ -208,9 +215,7 @@ TEST(InitializeTest) {
     snprintf(warehouse_key, sizeof(warehouse_key), "w%d", i);
     warehouse_value = simple_store->ReadObject(warehouse_key);
 
-    Warehouse* dummy_warehouse = new Warehouse();
-    EXPECT_TRUE(dummy_warehouse->ParseFromString(*warehouse_value));
-    delete dummy_warehouse;
+    EXPECT_EQ(sizeof(Warehouse), warehouse_value->size());
 
     // Expect all the districts to be there
     for (int j = 0; j < DISTRICTS_PER_WAREHOUSE; j++) {
@@ -219,9 +224,7 @@ TEST(InitializeTest) {
       snprintf(district_key, sizeof(district_key), "w%dd%d", i, j);
       district_value = simple_store->ReadObject(district_key);
 
-      District* dummy_district = new District();
-      EXPECT_TRUE(dummy_district->ParseFromString(*district_value));
-      delete dummy_district;
+      EXPECT_EQ(sizeof(District), district_value->size());
 
       // Expect all the customers to be there
       for (int k = 0; k < CUSTOMERS_PER_DISTRICT; k++) {
@@ -230,9 +233,7 @@ TEST(InitializeTest) {
         snprintf(customer_key, sizeof(customer_key), "w%dd%dc%d", i, j, k);
         customer_value = simple_store->ReadObject(customer_key);
 
-        Customer* dummy_customer = new Customer();
-        EXPECT_TRUE(dummy_customer->ParseFromString(*customer_value));
-        delete dummy_customer;
+        EXPECT_EQ(sizeof(Customer), customer_value->size());
       }
     }
 
@@ -244,9 +245,7 @@ TEST(InitializeTest) {
       snprintf(stock_key, sizeof(stock_key), "%ss%s", warehouse_key, item_key);
       stock_value = simple_store->ReadObject(stock_key);
 
-      Stock* dummy_stock = new Stock();
-      EXPECT_TRUE(dummy_stock->ParseFromString(*stock_value));
-      delete dummy_stock;
+      EXPECT_EQ(sizeof(Stock), stock_value->size());
     }
   }
 
@@ -257,9 +256,7 @@ TEST(InitializeTest) {
     snprintf(item_key, sizeof(item_key), "i%d", i);
     item_value = *(tpcc->GetItem(string(item_key)));
 
-    Item* dummy_item = new Item();
-    EXPECT_TRUE(dummy_item->ParseFromString(item_value));
-    delete dummy_item;
+    EXPECT_EQ(sizeof(Item), item_value.size());
   }
 
   END;
@@ -280,7 +277,7 @@ TEST(NewOrderTest) {
     txn = tpcc->NewTxn(2, TPCC::NEW_ORDER, txn_args_value, config);
     assert(txn_args->ParseFromString(txn->arg()));
     invalid = false;
-    for (int i = 0; i < txn_args->order_line_count(); i++) {
+    for (int i = 0; i < txn_args->order_line_count(0); i++) {
       if (txn->read_write_set(i + 1).find("i-1") != string::npos)
         invalid = true;
     }
@@ -292,36 +289,34 @@ TEST(NewOrderTest) {
       new StorageManager(config, connection, simple_store, txn);
 
   // Prefetch some values in order to ensure our ACIDity after
-  District* district = new District();
+  District* district;
   Value* district_value;
   district_value = storage->ReadObject(txn->read_write_set(0));
-  assert(district->ParseFromString(*district_value));
+  district = RecordIn<District>(district_value);
 
-  // Prefetch the stocks
-  Stock* old_stocks[txn_args->order_line_count()];
-  for (int i = 0; i < txn_args->order_line_count(); i++) {
+  // Prefetch the stocks. Records are updated in place, so they are copied.
+  Stock* old_stocks[txn_args->order_line_count(0)];
+  for (int i = 0; i < txn_args->order_line_count(0); i++) {
     Value* stock_value;
-    Stock* stock = new Stock();
     stock_value = storage->ReadObject(txn->read_write_set(i + 1));
-    assert(stock->ParseFromString(*stock_value));
-    old_stocks[i] = stock;
+    old_stocks[i] = new Stock(*RecordIn<Stock>(stock_value));
   }
 
   // Prefetch the actual values
-  int old_next_order_id = district->next_order_id();
+  int old_next_order_id = district->next_order_id;
 
   // Execute the transaction
   tpcc->Execute(txn, storage);
 
   // Let's prefetch the keys we need for the post-check
   Key district_key = txn->read_write_set(0);
-  Key new_order_key = txn->write_set(txn_args->order_line_count());
-  Key order_key = txn->write_set(txn_args->order_line_count() + 1);
+  Key new_order_key = txn->write_set(txn_args->order_line_count(0));
+  Key order_key = txn->write_set(txn_args->order_line_count(0) + 1);
 
   // Add in all the keys and re-initialize the storage manager
   txn->add_read_set(new_order_key);
   txn->add_read_set(order_key);
-  for (int i = 0; i < txn_args->order_line_count(); i++) {
+  for (int i = 0; i < txn_args->order_line_count(0); i++) {
     txn->add_read_set(txn->write_set(i));
   }
   delete storage;
@@ -329,97 +324,84 @@ TEST(NewOrderTest) {
 
   // Ensure that D_NEXT_O_ID is incremented for district
   district_value = storage->ReadObject(district_key);
-  assert(district->ParseFromString(*district_value));
-  EXPECT_EQ(old_next_order_id + 1, district->next_order_id());
+  district = RecordIn<District>(district_value);
+  EXPECT_EQ(old_next_order_id + 1, district->next_order_id);
 
   // TPCC::NEW_ORDER row was inserted with appropriate fields
   Value* new_order_value;
-  NewOrder* new_order = new NewOrder();
   new_order_value = storage->ReadObject(new_order_key);
-  EXPECT_TRUE(new_order->ParseFromString(*new_order_value));
+  NewOrder* new_order = RecordIn<NewOrder>(new_order_value);
+  EXPECT_EQ(string(new_order->id), new_order_key);
 
   // ORDER row was inserted with appropriate fields
   Value* order_value;
-  Order* order = new Order();
   order_value = storage->ReadObject(order_key);
-  EXPECT_TRUE(order->ParseFromString(*order_value));
+  Order* order = RecordIn<Order>(order_value);
+  EXPECT_EQ(string(order->id), order_key);
+  EXPECT_EQ(order->order_line_count, txn_args->order_line_count(0));
 
   // For each item in O_OL_CNT
-  for (int i = 0; i < txn_args->order_line_count(); i++) {
+  for (int i = 0; i < txn_args->order_line_count(0); i++) {
     Value* stock_value;
-    Stock* stock = new Stock();
     stock_value = storage->ReadObject(txn->read_write_set(i + 1));
-    EXPECT_TRUE(stock->ParseFromString(*stock_value));
+    Stock* stock = RecordIn<Stock>(stock_value);
 
     // Check YTD, order_count, and remote_count
-    int corrected_year_to_date = old_stocks[i]->year_to_date();
-    for (int j = 0; j < txn_args->order_line_count(); j++) {
+    int corrected_year_to_date = old_stocks[i]->year_to_date;
+    for (int j = 0; j < txn_args->order_line_count(0); j++) {
       if (txn->read_write_set(j + 1) == txn->read_write_set(i + 1))
         corrected_year_to_date += txn_args->quantities(j);
     }
-    EXPECT_EQ(stock->year_to_date(), corrected_year_to_date);
+    EXPECT_EQ(stock->year_to_date, corrected_year_to_date);
 
     // Check order_count
-    int corrected_order_count = old_stocks[i]->order_count();
-    for (int j = 0; j < txn_args->order_line_count(); j++) {
+    int corrected_order_count = old_stocks[i]->order_count;
+    for (int j = 0; j < txn_args->order_line_count(0); j++) {
       if (txn->read_write_set(j + 1) == txn->read_write_set(i + 1))
         corrected_order_count--;
     }
-    EXPECT_EQ(stock->order_count(), corrected_order_count);
+    EXPECT_EQ(stock->order_count, corrected_order_count);
 
     // Check remote_count
     if (txn->multipartition()) {
-      int corrected_remote_count = old_stocks[i]->remote_count();
-      for (int j = 0; j < txn_args->order_line_count(); j++) {
+      int corrected_remote_count = old_stocks[i]->remote_count;
+      for (int j = 0; j < txn_args->order_line_count(0); j++) {
         if (txn->read_write_set(j + 1) == txn->read_write_set(i + 1))
           corrected_remote_count++;
       }
-      EXPECT_EQ(stock->remote_count(), corrected_remote_count);
+      EXPECT_EQ(stock->remote_count, corrected_remote_count);
     }
 
     // Check stock supply decrease
-    int corrected_quantity = old_stocks[i]->quantity();
-    for (int j = 0; j < txn_args->order_line_count(); j++) {
+    int corrected_quantity = old_stocks[i]->quantity;
+    for (int j = 0; j < txn_args->order_line_count(0); j++) {
       if (txn->read_write_set(j + 1) == txn->read_write_set(i + 1)) {
-        if (old_stocks[i]->quantity() >= txn_args->quantities(i) + 10)
+        if (old_stocks[i]->quantity >= txn_args->quantities(i) + 10)
           corrected_quantity -= txn_args->quantities(j);
         else
           corrected_quantity -= txn_args->quantities(j) - 91;
       }
     }
-    EXPECT_EQ(stock->quantity(), corrected_quantity);
+    EXPECT_EQ(stock->quantity, corrected_quantity);
 
     // First, we check if the item is valid
     size_t item_idx = txn->read_write_set(i + 1).find("i");
     Key item_key = txn->read_write_set(i + 1).substr(item_idx, string::npos);
-    Value item_value = *(tpcc->GetItem(item_key));
-    Item* item = new Item();
-    EXPECT_TRUE(item->ParseFromString(item_value));
+    Item* item = RecordIn<Item>(tpcc->GetItem(item_key));
 
     // Check the order line
-    // TODO(Thad): Get order_line_ptr from Order protobuf and deserialize from
-    // there
-    //    Value* order_line_value;
-    //    OrderLine* order_line = new OrderLine();
-    //    order_line_value = storage->ReadObject(txn->write_set(i));
-    //    EXPECT_TRUE(order_line->ParseFromString(*order_line_value));
-    //    EXPECT_EQ(order_line->amount(), item->price() *
-    //    txn_args->quantities(i)); EXPECT_EQ(order_line->number(), i);
-
-    // Free memory
-    //    delete order_line;
-    delete item;
-    delete stock;
+    Value* order_line_value;
+    order_line_value = storage->ReadObject(txn->write_set(i));
+    OrderLine* order_line = RecordIn<OrderLine>(order_line_value);
+    EXPECT_EQ(order_line->amount, item->price * txn_args->quantities(i));
+    EXPECT_EQ(order_line->number, i);
   }
 
   // Free memory
-  for (int i = 0; i < txn_args->order_line_count(); i++)
+  for (int i = 0; i < txn_args->order_line_count(0); i++)
     delete old_stocks[i];
   delete txn_args;
   delete storage;
-  delete district;
-  delete order;
-  delete new_order;
   delete txn;
 
   END
@@ -447,27 +429,27 @@ TEST(PaymentTest) {
       new StorageManager(config, connection, simple_store, txn);
 
   // Prefetch some values in order to ensure our ACIDity after
-  Warehouse* warehouse = new Warehouse();
+  Warehouse* warehouse;
   Value* warehouse_value;
   warehouse_value = storage->ReadObject(txn->read_write_set(0));
-  assert(warehouse->ParseFromString(*warehouse_value));
-  int old_warehouse_year_to_date = warehouse->year_to_date();
+  warehouse = RecordIn<Warehouse>(warehouse_value);
+  int old_warehouse_year_to_date = warehouse->year_to_date;
 
   // Prefetch district
-  District* district = new District();
+  District* district;
   Value* district_value;
   district_value = storage->ReadObject(txn->read_write_set(1));
-  assert(district->ParseFromString(*district_value));
-  int old_district_year_to_date = district->year_to_date();
+  district = RecordIn<District>(district_value);
+  int old_district_year_to_date = district->year_to_date;
 
   // Preetch customer
-  Customer* customer = new Customer();
+  Customer* customer;
   Value* customer_value;
   customer_value = storage->ReadObject(txn->read_write_set(2));
-  assert(customer->ParseFromString(*customer_value));
-  int old_customer_year_to_date_payment = customer->year_to_date_payment();
-  int old_customer_balance = customer->balance();
-  int old_customer_payment_count = customer->payment_count();
+  customer = RecordIn<Customer>(customer_value);
+  int old_customer_year_to_date_payment = customer->year_to_date_payment;
+  int old_customer_balance = customer->balance;
+  int old_customer_payment_count = customer->payment_count;
 
   // Execute the transaction
   tpcc->Execute(txn, storage);
@@ -477,38 +459,34 @@ TEST(PaymentTest) {
   storage = new StorageManager(config, connection, simple_store, txn);
 
   warehouse_value = storage->ReadObject(txn->read_write_set(0));
-  assert(warehouse->ParseFromString(*warehouse_value));
+  warehouse = RecordIn<Warehouse>(warehouse_value);
   district_value = storage->ReadObject(txn->read_write_set(1));
-  assert(district->ParseFromString(*district_value));
+  district = RecordIn<District>(district_value);
   customer_value = storage->ReadObject(txn->read_write_set(2));
-  assert(customer->ParseFromString(*customer_value));
+  customer = RecordIn<Customer>(customer_value);
 
   // Check the old values against the new
-  EXPECT_EQ(warehouse->year_to_date(),
+  EXPECT_EQ(warehouse->year_to_date,
             old_warehouse_year_to_date + txn_args->amount());
-  EXPECT_EQ(district->year_to_date(),
+  EXPECT_EQ(district->year_to_date,
             old_district_year_to_date + txn_args->amount());
-  EXPECT_EQ(customer->year_to_date_payment(),
+  EXPECT_EQ(customer->year_to_date_payment,
             old_customer_year_to_date_payment + txn_args->amount());
-  EXPECT_EQ(customer->balance(), old_customer_balance - txn_args->amount());
-  EXPECT_EQ(customer->payment_count(), old_customer_payment_count + 1);
+  EXPECT_EQ(customer->balance, old_customer_balance - txn_args->amount());
+  EXPECT_EQ(customer->payment_count, old_customer_payment_count + 1);
 
   // Ensure the history record is valid
-  History* history = new History();
+  History* history;
   Value* history_value;
   history_value = storage->ReadObject(txn->read_set(0));
-  EXPECT_TRUE(history->ParseFromString(*history_value));
-  EXPECT_EQ(history->warehouse_id(), warehouse->id());
-  EXPECT_EQ(history->district_id(), district->id());
-  EXPECT_EQ(history->customer_id(), customer->id());
-  EXPECT_EQ(history->customer_warehouse_id(), customer->warehouse_id());
-  EXPECT_EQ(history->customer_district_id(), customer->district_id());
+  history = RecordIn<History>(history_value);
+  EXPECT_EQ(strcmp(history->warehouse_id, warehouse->id), 0);
+  EXPECT_EQ(strcmp(history->district_id, district->id), 0);
+  EXPECT_EQ(strcmp(history->customer_id, customer->id), 0);
+  EXPECT_EQ(strcmp(history->customer_warehouse_id, customer->warehouse_id), 0);
+  EXPECT_EQ(strcmp(history->customer_district_id, customer->district_id), 0);
 
   // Free memory
-  delete history;
-  delete warehouse;
-  delete customer;
-  delete district;
   delete storage;
   delete txn_args;
   delete txn;
@@ -516,6 +494,60 @@ TEST(PaymentTest) {
   END
 }
 
+TEST(DeliveryTest) {
+  TPCCArgs args;
+  args.set_system_time(GetTime());
+  args.set_multipartition(false);
+  string args_string;
+  args.SerializeToString(&args_string);
+
+  // New orders are placed until a delivery finds one to deliver.
+  TxnProto* txn = NULL;
+  for (int64 txn_id = 5; txn == NULL; txn_id += 2) {
+    TxnProto* new_order =
+        tpcc->NewTxn(txn_id, TPCC::NEW_ORDER, args_string, config);
+    new_order->add_readers(0);
+    new_order->add_writers(0);
+    StorageManager* storage =
+        new StorageManager(config, connection, simple_store, new_order);
+    EXPECT_EQ(SUCCESS, tpcc->Execute(new_order, storage));
+    delete storage;
+    delete new_order;
+
+    txn = tpcc->NewTxn(txn_id + 1, TPCC::DELIVERY, args_string, config);
+    tpcc->Reconnoiter(txn, simple_store, config);
+    if (txn->read_write_set_size() == DISTRICTS_PER_WAREHOUSE) {
+      delete txn;
+      txn = NULL;
+    }
+  }
+  txn->add_readers(0);
+  txn->add_writers(0);
+  StorageManager* storage =
+      new StorageManager(config, connection, simple_store, txn);
+  EXPECT_EQ(SUCCESS, tpcc->Execute(txn, storage));
+  delete storage;
+
+  // The first delivered order, which follows its new order, and its order
+  // lines carry what the client chose.
+  TPCCArgs txn_args;
+  assert(txn_args.ParseFromString(txn->arg()));
+  storage = new StorageManager(config, connection, simple_store, txn);
+  Order* order = RecordIn<Order>(
+      storage->ReadObject(txn->read_write_set(DISTRICTS_PER_WAREHOUSE + 1)));
+  EXPECT_EQ(order->carrier_id, txn_args.carrier_id());
+  for (int i = 0; i < order->order_line_count; i++) {
+    OrderLine* order_line = RecordIn<OrderLine>(storage->ReadObject(
+        txn->read_write_set(DISTRICTS_PER_WAREHOUSE + 2 + i)));
+    EXPECT_EQ(order_line->delivery_date, txn_args.system_time());
+  }
+
+  delete storage;
+  delete txn;
+
+  END
+}
+
 TEST(MultipleTxnTest) {
   StorageManager* storage;
   TPCCArgs args;
@@ -559,6 +591,7 @@ int main(int argc, char** argv) {
   NewTxnTest();
   NewOrderTest();
   PaymentTest();
+  DeliveryTest();
 
   // MultipleTxnTest();
 
@@ -0,0 +1,262 @@
+#include "scheduler/txn_restarter.h"
+
+#include <string>
+
+#include "applications/tpcc.h"
+#include "applications/tpcc_records.h"
+#include "backend/simple_storage.h"
+#include "backend/storage_manager.h"
+#include "common/configuration.h"
+#include "common/definitions.hh"
+#include "common/utils.h"
+#include "proto/tpcc.pb.h"
+#include "proto/tpcc_args.pb.h"
+#include "proto/txn.pb.h"
+#include "common/testing.h"
+
+static Value* NewIndex(const string& a, const string& b, const string& c) {
+  CustomerIndex index;
+  index.add_customer_ids(a);
+  if (!b.empty())
+    index.add_customer_ids(b);
+  if (!c.empty())
+    index.add_customer_ids(c);
+  Value* value = new Value();
+  index.SerializeToString(value);
+  return value;
+}
+
+static int PaymentCount(Storage* storage, const Key& key) {
+  return RecordIn<Customer>(storage->ReadObject(key))->payment_count;
+}
+
+// Runs 'txn' at node 0, which holds all of its keys, and returns what
+// Execute() did. Like the sequencer, only makes the node a writer of txns that
+// write.
+static int Run(const TPCC& tpcc, Configuration* config, Storage* storage,
+               TxnProto* txn) {
+  if (txn->readers_size() == 0 && txn->writers_size() == 0) {
+    if (txn->read_set_size() > 0 || txn->read_write_set_size() > 0)
+      txn->add_readers(0);
+    if (txn->write_set_size() > 0 || txn->read_write_set_size() > 0)
+      txn->add_writers(0);
+  }
+  StorageManager manager(config, NULL, storage, txn);
+  return tpcc.Execute(txn, &manager);
+}
+
+// Returns a new order of items "i1" and "i2" by customer "w0d0c1".
+static TxnProto* NewOrderTxn(int order_number) {
+  TPCCArgs args;
+  args.add_order_line_count(2);
+  args.add_quantities(1);
+  args.add_quantities(1);
+  args.set_order_number(order_number);
+  TxnProto* txn = new TxnProto();
+  txn->set_txn_id(order_number);
+  txn->set_txn_type(TPCC::NEW_ORDER);
+  args.SerializeToString(txn->mutable_arg());
+  string order_key = "w0d0o" + IntToString(order_number);
+  txn->add_read_set("w0");
+  txn->add_read_set("w0d0c1");
+  txn->add_read_write_set("w0d0");
+  txn->add_read_write_set("w0si1");
+  txn->add_read_write_set("w0si2");
+  txn->add_write_set(order_key + "ol0");
+  txn->add_write_set(order_key + "ol1");
+  txn->add_write_set("w0d0no" + IntToString(order_number));
+  txn->add_write_set(order_key);
+  txn->add_write_set("w0d0c1lo");
+  return txn;
+}
+
+// Returns a delivery at warehouse "w0".
+static TxnProto* DeliveryTxn() {
+  TxnProto* txn = new TxnProto();
+  txn->set_txn_id(100);
+  txn->set_txn_type(TPCC::DELIVERY);
+  txn->add_read_set("w0");
+  for (int i = 0; i < DISTRICTS_PER_WAREHOUSE; i++) {
+    txn->add_read_set("w0d" + IntToString(i));
+    txn->add_read_write_set("w0d" + IntToString(i) + "on");
+  }
+  return txn;
+}
+
+TEST(PaymentByLastNameTest) {
+  Configuration config(0, "common/configuration_test_one_node.conf");
+  SimpleStorage storage;
+  storage.Initmutex();
+  TPCC tpcc;
+  TxnRestarter restarter(&config, &tpcc);
+
+  storage.PutObject("w0y", tpcc.CreateWarehouse("w0y"));
+  storage.PutObject("w0d0y", tpcc.CreateDistrict("w0d0y", "w0y"));
+  for (int i = 1; i <= 3; i++) {
+    Key customer_key = "w0d0c" + IntToString(i);
+    Value* customer_value = tpcc.CreateCustomer(customer_key, "w0d0y", "w0y");
+    SetField(RecordIn<Customer>(customer_value)->last, "BARBAR");
+    storage.PutObject(customer_key, customer_value);
+  }
+  storage.PutObject("w0d0lnBARBAR", NewIndex("w0d0c1", "w0d0c2", "w0d0c3"));
+
+  TPCCArgs args;
+  args.set_amount(10);
+  args.set_last_name("BARBAR");
+  TxnProto txn;
+  txn.set_txn_id(3 * MAX_LOCK_BATCH_SIZE + 5);
+  txn.set_txn_type(TPCC::PAYMENT);
+  args.SerializeToString(txn.mutable_arg());
+  txn.add_read_write_set("w0y");
+  txn.add_read_write_set("w0d0y");
+  txn.add_write_set("w0h1");
+  txn.add_read_set("w0d0lnBARBAR");
+
+  // The reconnaissance read predicts the middle customer by the name.
+  tpcc.Reconnoiter(&txn, &storage, &config);
+  EXPECT_EQ(3, txn.read_write_set_size());
+  EXPECT_EQ("w0d0c2", txn.read_write_set(2));
+
+  // The index changes before the txn runs: it restarts, writing nothing.
+  storage.PutObject("w0d0lnBARBAR", NewIndex("w0d0c1", "", ""));
+  txn.add_readers(0);
+  txn.add_writers(0);
+  StorageManager* manager =
+      new StorageManager(&config, NULL, &storage, &txn);
+  EXPECT_EQ(REDO, tpcc.Execute(&txn, manager));
+  delete manager;
+  EXPECT_EQ(3, txn.read_write_set_size());
+  EXPECT_EQ("w0d0c1", txn.dependent_keys(0));
+  EXPECT_TRUE(storage.ReadObject("w0h1") == NULL);
+  EXPECT_EQ(0, PaymentCount(&storage, "w0d0c2"));
+  EXPECT_EQ(0, restarter.SequencerOf(txn));
+
+  // The restart is ordered with the customer found.
+  TxnProto* restart = restarter.NewRestart(txn);
+  EXPECT_EQ("w0d0c1", restart->read_write_set(2));
+  EXPECT_EQ(0, restart->dependent_keys_size());
+  EXPECT_EQ(0, restart->writers_size());
+  restart->add_readers(0);
+  restart->add_writers(0);
+  manager = new StorageManager(&config, NULL, &storage, restart);
+  EXPECT_EQ(SUCCESS, tpcc.Execute(restart, manager));
+  delete manager;
+  EXPECT_TRUE(storage.ReadObject("w0h1") != NULL);
+  EXPECT_EQ(1, PaymentCount(&storage, "w0d0c1"));
+  EXPECT_EQ(0, PaymentCount(&storage, "w0d0c2"));
+  delete restart;
+
+  // Only the first writer sends restarts, the others just count them.
+  txn.set_writers(0, 1);
+  EXPECT_EQ(1, restarter.RestarterOf(txn));
+  restarter.Executed(txn, REDO, NULL);
+  restarter.Executed(txn, SUCCESS, NULL);
+  EXPECT_EQ("Restarted 1 of 2 executed txns (50.00%)", restarter.ReportStats());
+  EXPECT_EQ("Restarted 0 of 0 executed txns (0.00%)", restarter.ReportStats());
+
+  END;
+}
+
+TEST(OrderIndexTest) {
+  Configuration config(0, "common/configuration_test_one_node.conf");
+  SimpleStorage storage;
+  storage.Initmutex();
+  TPCC tpcc;
+  TxnRestarter restarter(&config, &tpcc);
+
+  storage.PutObject("w0", tpcc.CreateWarehouse("w0"));
+  storage.PutObject("w0d0", tpcc.CreateDistrict("w0d0", "w0"));
+  storage.PutObject("w0d0c1", tpcc.CreateCustomer("w0d0c1", "w0d0", "w0"));
+  OldestNewOrder* oldest_new_order;
+  storage.PutObject("w0d0on", NewRecord(&oldest_new_order));
+  for (int i = 1; i <= 2; i++) {
+    Key item_key = "i" + IntToString(i);
+    tpcc.SetItem(item_key, tpcc.CreateItem(item_key));
+    storage.PutObject("w0s" + item_key, tpcc.CreateStock(item_key, "w0"));
+  }
+
+  // Nothing is delivered before the district has new orders.
+  TxnProto* delivery = DeliveryTxn();
+  tpcc.Reconnoiter(delivery, &storage, &config);
+  EXPECT_EQ(DISTRICTS_PER_WAREHOUSE, delivery->read_write_set_size());
+  EXPECT_EQ(SUCCESS, Run(tpcc, &config, &storage, delivery));
+  delete delivery;
+
+  TxnProto* new_order = NewOrderTxn(0);
+  EXPECT_EQ(SUCCESS, Run(tpcc, &config, &storage, new_order));
+  delete new_order;
+
+  // Order-status reads the latest order of the customer, as predicted.
+  TxnProto order_status;
+  order_status.set_txn_id(101);
+  order_status.set_txn_type(TPCC::ORDER_STATUS);
+  order_status.add_read_set("w0");
+  order_status.add_read_set("w0d0");
+  order_status.add_read_set("w0d0c1");
+  order_status.add_read_set("w0d0c1lo");
+  tpcc.Reconnoiter(&order_status, &storage, &config);
+  EXPECT_EQ(7, order_status.read_set_size());
+  EXPECT_EQ("w0d0o0", order_status.read_set(4));
+  EXPECT_EQ("w0d0o0ol1", order_status.read_set(6));
+  TxnProto stale_order_status(order_status);
+  EXPECT_EQ(SUCCESS, Run(tpcc, &config, &storage, &order_status));
+
+  // A newer order makes the prediction stale.
+  new_order = NewOrderTxn(1);
+  EXPECT_EQ(SUCCESS, Run(tpcc, &config, &storage, new_order));
+  delete new_order;
+  EXPECT_EQ(REDO, Run(tpcc, &config, &storage, &stale_order_status));
+  EXPECT_EQ("w0d0o1", stale_order_status.dependent_keys(0));
+
+  // It writes nothing, so its first reader orders it again.
+  EXPECT_EQ(0, stale_order_status.writers_size());
+  EXPECT_EQ(0, restarter.RestarterOf(stale_order_status));
+  tpcc.Repredict(&stale_order_status);
+  EXPECT_EQ(7, stale_order_status.read_set_size());
+  EXPECT_EQ("w0d0o1", stale_order_status.read_set(4));
+  EXPECT_EQ(SUCCESS, Run(tpcc, &config, &storage, &stale_order_status));
+
+  // Deliveries take the oldest new order of the district.
+  delivery = DeliveryTxn();
+  tpcc.Reconnoiter(delivery, &storage, &config);
+  EXPECT_EQ(DISTRICTS_PER_WAREHOUSE + 5, delivery->read_write_set_size());
+  EXPECT_EQ("w0d0no0", delivery->read_write_set(DISTRICTS_PER_WAREHOUSE));
+  EXPECT_EQ("w0d0c1", delivery->read_write_set(DISTRICTS_PER_WAREHOUSE + 4));
+  TxnProto stale_delivery(*delivery);
+  EXPECT_EQ(SUCCESS, Run(tpcc, &config, &storage, delivery));
+  delete delivery;
+  EXPECT_TRUE(storage.ReadObject("w0d0no0") == NULL);
+
+  // A second delivery predicted at the same time finds the next one.
+  EXPECT_EQ(REDO, Run(tpcc, &config, &storage, &stale_delivery));
+  EXPECT_TRUE(storage.ReadObject("w0d0no1") != NULL);
+  tpcc.Repredict(&stale_delivery);
+  EXPECT_EQ("w0d0no1", stale_delivery.read_write_set(DISTRICTS_PER_WAREHOUSE));
+  EXPECT_EQ(SUCCESS, Run(tpcc, &config, &storage, &stale_delivery));
+  EXPECT_TRUE(storage.ReadObject("w0d0no1") == NULL);
+  EXPECT_EQ(2, RecordIn<OldestNewOrder>(storage.ReadObject("w0d0on"))
+                   ->order_number);
+
+  // Stock-level reads the lines of the latest orders, and their items' stock.
+  TPCCArgs args;
+  args.set_lastest_order_number(1);
+  args.set_threshold(10);
+  TxnProto stock_level;
+  stock_level.set_txn_id(102);
+  stock_level.set_txn_type(TPCC::STOCK_LEVEL);
+  args.SerializeToString(stock_level.mutable_arg());
+  stock_level.add_read_set("w0");
+  stock_level.add_read_set("w0d0");
+  tpcc.Reconnoiter(&stock_level, &storage, &config);
+  EXPECT_EQ(6, stock_level.read_set_size());
+  EXPECT_EQ("w0d0o1ol0", stock_level.read_set(2));
+  EXPECT_EQ("w0si1", stock_level.read_set(3));
+  EXPECT_EQ(SUCCESS, Run(tpcc, &config, &storage, &stock_level));
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  PaymentByLastNameTest();
+  OrderIndexTest();
+}
@@ -0,0 +1,146 @@
+#include "scheduler/vll_acquirer.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "common/configuration.h"
+#include "common/testing.h"
+#include "proto/txn.pb.h"
+#include "scheduler/vll_queue.h"
+
+using std::vector;
+
+// Lock requests made one txn at a time, as by a single lock manager thread.
+class SerialLocks {
+ public:
+  SerialLocks()
+      : slots_(LockSlots::EXACT, 100), Cx_(slots_.size(), 0),
+        Cs_(slots_.size(), 0) {}
+
+  // Requests the locks of 'txn', sets its slots in 'entry' and returns true
+  // if it is granted.
+  bool Request(const TxnProto& txn, VllTxn* entry) {
+    bool granted = true;
+    entry->slots.clear();
+    for (int i = 0; i < txn.read_write_set_size(); i++) {
+      int slot = slots_.Acquire(txn.read_write_set(i));
+      entry->slots.push_back(slot);
+      if (++Cx_[slot] > 1 || Cs_[slot] > 0)
+        granted = false;
+    }
+    entry->writes = entry->slots.size();
+    for (int i = 0; i < txn.read_set_size(); i++) {
+      int slot = slots_.Acquire(txn.read_set(i));
+      entry->slots.push_back(slot);
+      Cs_[slot]++;
+      if (Cx_[slot] > 0)
+        granted = false;
+    }
+    return granted;
+  }
+
+  void Release(const VllTxn& entry) {
+    for (size_t i = 0; i < entry.slots.size(); i++) {
+      int slot = entry.slots[i];
+      if (static_cast<int>(i) < entry.writes)
+        Cx_[slot]--;
+      else
+        Cs_[slot]--;
+      if (Cx_[slot] == 0 && Cs_[slot] == 0)
+        slots_.Release(slot);
+    }
+  }
+
+ private:
+  LockSlots slots_;
+  vector<int> Cx_;
+  vector<int> Cs_;
+};
+
+// Dense ids and table keys, few enough of each to conflict often.
+Key RandomKey() {
+  if (rand() % 2)
+    return IntToString(rand() % 100);
+  return "w1d" + IntToString(rand() % 100);
+}
+
+TEST(VllAcquirerTest) {
+  Configuration config(0, "common/configuration_test_one_node.conf");
+  VllAcquirer acquirer(&config, LockSlots::EXACT, 100, 3, 16);
+  SerialLocks serial;
+  vector<VllTxn*> in_flight;
+  srand(0);
+
+  int blocked = 0;
+  for (int round = 0; round < 200; round++) {
+    // Submit as many txns as fit...
+    vector<TxnProto> txns;
+    while (!acquirer.full()) {
+      TxnProto txn;
+      txn.set_txn_id(round * 100 + txns.size());
+      if (rand() % 50 == 0) {
+        MigrationProto* migration = txn.mutable_migration();
+        migration->set_table("w");
+        migration->set_first_id(0);
+        migration->set_last_id(9);
+        migration->set_node(0);
+      }
+      for (int i = rand() % 4; i > 0; i--)
+        txn.add_read_write_set(RandomKey());
+      for (int i = rand() % 4; i > 0; i--)
+        txn.add_read_set(RandomKey());
+      string data;
+      txn.SerializeToString(&data);
+      acquirer.Submit(&data);
+      txns.push_back(txn);
+    }
+
+    // ...and collect them in order. With no locks released meanwhile, each is
+    // granted or blocked as if requested serially, on the same slots.
+    for (size_t i = 0; i < txns.size(); i++) {
+      VllJob* job;
+      while ((job = acquirer.Next()) == NULL)
+        Spin(0.0001);
+      EXPECT_EQ(txns[i].txn_id(), job->txn->txn_id());
+      if (txns[i].has_migration()) {
+        EXPECT_TRUE(job->slots.empty());
+        delete job->txn;
+        continue;
+      }
+
+      VllTxn* expected = new VllTxn();
+      bool granted = serial.Request(txns[i], expected);
+      EXPECT_EQ(granted, (job->txn->status() == TxnProto::ACTIVE));
+      EXPECT_EQ(granted, job->waits.empty());
+      EXPECT_EQ(expected->writes, job->writes);
+      EXPECT_TRUE(expected->slots == job->slots);
+      if (!granted)
+        blocked++;
+      delete job->txn;
+      in_flight.push_back(expected);
+    }
+
+    // Release a random half of the txns in flight.
+    for (size_t i = 0; i < in_flight.size();) {
+      if (rand() % 2) {
+        acquirer.Release(*in_flight[i]);
+        serial.Release(*in_flight[i]);
+        delete in_flight[i];
+        in_flight[i] = in_flight.back();
+        in_flight.pop_back();
+      } else {
+        i++;
+      }
+    }
+  }
+  EXPECT_TRUE(blocked > 0);
+
+  for (size_t i = 0; i < in_flight.size(); i++)
+    delete in_flight[i];
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  VllAcquirerTest();
+}
@@ -0,0 +1,59 @@
+#include "scheduler/vll_queue.h"
+
+#include "common/testing.h"
+#include "proto/txn.pb.h"
+
+TEST(VllQueueTest) {
+  VllQueue queue(4);
+  TxnProto txns[10];
+  for (int i = 0; i < 10; i++)
+    txns[i].set_txn_id(i * 1000 + 7);
+
+  // Fill the window, with txns 1 and 3 blocked.
+  for (int i = 0; i < 4; i++) {
+    VllTxn* entry = queue.Append(&txns[i]);
+    if (i % 2 == 1)
+      queue.Block(entry);
+  }
+  EXPECT_TRUE(queue.full());
+  EXPECT_EQ(4, queue.size());
+  EXPECT_EQ(2, queue.blocked());
+  EXPECT_EQ(&txns[1], queue.first_blocked()->txn);
+  EXPECT_EQ(&txns[3], queue.first_blocked()->next_blocked->txn);
+
+  // Completing a txn behind the front frees no room.
+  queue.Remove(queue.Find(2007));
+  EXPECT_TRUE(queue.full());
+  EXPECT_EQ(3, queue.size());
+
+  // Completing the front one skips over it and txn 2.
+  queue.Remove(queue.Find(7));
+  EXPECT_FALSE(queue.full());
+  EXPECT_EQ(&txns[1], queue.front()->txn);
+
+  queue.Unblock(queue.Find(1007));
+  EXPECT_EQ(&txns[3], queue.first_blocked()->txn);
+  EXPECT_TRUE(queue.first_blocked()->next_blocked == NULL);
+  queue.Remove(queue.Find(1007));
+  EXPECT_EQ(&txns[3], queue.front()->txn);
+
+  // The ring wraps around.
+  for (int i = 4; i < 7; i++)
+    queue.Append(&txns[i]);
+  EXPECT_TRUE(queue.full());
+  for (int i = 4; i < 7; i++)
+    EXPECT_EQ(&txns[i], queue.Find(i * 1000 + 7)->txn);
+  queue.Unblock(queue.Find(3007));
+  EXPECT_EQ(0, queue.blocked());
+  EXPECT_TRUE(queue.first_blocked() == NULL);
+  for (int i = 3; i < 7; i++)
+    queue.Remove(queue.Find(i * 1000 + 7));
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.front() == NULL);
+
+  END;
+}
+
+int main(int argc, char** argv) {
+  VllQueueTest();
+}
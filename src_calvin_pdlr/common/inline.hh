@@ -1,3 +0,0 @@
-#pragma once
-
-#define INLINE __attribute__((always_inline)) inline
@@ -1,13 +0,0 @@
-// Author: Name (email)
-
-#include "common/testing.h"
-
-TEST(MyTest) {
-  // Testing code here ...
-
-  END;
-}
-
-int main(int argc, char** argv) {
-  MyTest();
-}
@@ -1,9 +0,0 @@
-// Author: Alexander Thomson (thomson@cs.yale.edu)
-
-#include "scheduler/determinstic_scheduler.h"
-
-#include <string>
-
-#include "common/types.h"
-
-int main(int argc, char** argv) {}
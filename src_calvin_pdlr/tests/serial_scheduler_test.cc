@@ -1,13 +0,0 @@
-// Author: Alexander Thomson (thomson@cs.yale.edu)
-
-#include "scheduler/serial_scheduler.h"
-
-#include "common/testing.h"
-
-TEST(SerialSchedulerTest) {
-  END;
-}
-
-int main() {
-  SerialSchedulerTest();
-}
@@ -1,15 +0,0 @@
-// Author: Alexander Thomson (thomson@cs.yale.edu)
-
-#include "sequencer/sequencer.h"
-
-#include <string>
-
-#include "common/testing.h"
-
-TEST(SequencerTest) {
-  END;
-}
-
-int main(int argc, char** argv) {
-  SequencerTest();
-}